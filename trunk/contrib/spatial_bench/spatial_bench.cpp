@@ -0,0 +1,150 @@
+/* 
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Compares the area search over the grid (linked unit lists, position read from each unit)
+with UnitSpatialCell::FilterRadius over the same 3x3 cells. Build from src/game with the
+include flags of libmangosgame, e.g.:
+
+g++ -O2 -DHAVE_CONFIG_H -I. -I../shared -I../framework -I../../dep/include \
+    ../../contrib/spatial_bench/spatial_bench.cpp UnitSpatialIndex.cpp -o spatial_bench
+*/
+
+#include "UnitSpatialIndex.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <list>
+#include <algorithm>
+
+#define BENCH_CELL_SIZE     66.6666f
+#define BENCH_CELLS         9
+#define BENCH_QUERIES       20000
+
+// stands for a unit: the position is far from the grid link, like in Unit
+struct BenchUnit
+{
+    BenchUnit* next;
+    char data[1024];
+    float x, y, z;
+    float size;
+};
+
+struct BenchDistOrder
+{
+    float x, y;
+    BenchDistOrder(float _x, float _y) : x(_x), y(_y) {}
+    bool operator()(BenchUnit const* a, BenchUnit const* b) const
+    {
+        return (a->x-x)*(a->x-x) + (a->y-y)*(a->y-y) < (b->x-x)*(b->x-x) + (b->y-y)*(b->y-y);
+    }
+};
+
+static float frand(float max) { return max * float(rand()) / float(RAND_MAX); }
+
+static bool InRange(BenchUnit const* u, float x, float y, float z, float radius)
+{
+    float dx = u->x - x;
+    float dy = u->y - y;
+    float dz = u->z - z;
+    float dist = radius + u->size;
+    return dx*dx + dy*dy + dz*dz < dist*dist;
+}
+
+static void Run(unsigned int perCell, float radius)
+{
+    BenchUnit* heads[BENCH_CELLS];
+    UnitSpatialCell cells[BENCH_CELLS];
+    std::vector<BenchUnit*> units;
+
+    // interleave allocations of the cells so list neighbours are not memory neighbours
+    for(unsigned int c = 0; c < BENCH_CELLS; ++c)
+        heads[c] = NULL;
+    for(unsigned int i = 0; i < perCell; ++i)
+    {
+        for(unsigned int c = 0; c < BENCH_CELLS; ++c)
+        {
+            BenchUnit* u = new BenchUnit;
+            u->x = (c % 3) * BENCH_CELL_SIZE + frand(BENCH_CELL_SIZE);
+            u->y = (c / 3) * BENCH_CELL_SIZE + frand(BENCH_CELL_SIZE);
+            u->z = frand(5.0f);
+            u->size = 0.3f + frand(1.2f);
+            u->next = heads[c];
+            heads[c] = u;
+            cells[c].Add((Unit*)u, u->x, u->y, u->size, SPATIAL_UNIT_CREATURE);
+            units.push_back(u);
+        }
+    }
+
+    std::vector<float> qx(BENCH_QUERIES), qy(BENCH_QUERIES);
+    for(unsigned int q = 0; q < BENCH_QUERIES; ++q)
+    {
+        qx[q] = BENCH_CELL_SIZE + frand(BENCH_CELL_SIZE);
+        qy[q] = BENCH_CELL_SIZE + frand(BENCH_CELL_SIZE);
+    }
+
+    size_t foundGrid = 0;
+    clock_t start = clock();
+    for(unsigned int q = 0; q < BENCH_QUERIES; ++q)
+    {
+        std::list<BenchUnit*> found;
+        for(unsigned int c = 0; c < BENCH_CELLS; ++c)
+            for(BenchUnit* u = heads[c]; u; u = u->next)
+                if(InRange(u, qx[q], qy[q], 2.5f, radius))
+                    found.push_back(u);
+        found.sort(BenchDistOrder(qx[q], qy[q]));
+        foundGrid += found.size();
+    }
+    double gridTime = double(clock() - start) / CLOCKS_PER_SEC;
+
+    size_t foundIndex = 0;
+    start = clock();
+    for(unsigned int q = 0; q < BENCH_QUERIES; ++q)
+    {
+        UnitSpatialCell::UnitVector candidates;
+        for(unsigned int c = 0; c < BENCH_CELLS; ++c)
+            cells[c].FilterRadius(qx[q], qy[q], radius, SPATIAL_UNIT_ANY, candidates);
+
+        std::list<BenchUnit*> found;
+        for(size_t i = 0; i < candidates.size(); ++i)
+            if(InRange((BenchUnit*)candidates[i], qx[q], qy[q], 2.5f, radius))
+                found.push_back((BenchUnit*)candidates[i]);
+        found.sort(BenchDistOrder(qx[q], qy[q]));
+        foundIndex += found.size();
+    }
+    double indexTime = double(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%5u units/cell radius %5.1f: grid %8.2f us  index %8.2f us  speedup %5.1fx  %s\n",
+        perCell, radius, gridTime * 1e6 / BENCH_QUERIES, indexTime * 1e6 / BENCH_QUERIES,
+        indexTime > 0 ? gridTime / indexTime : 0.0, foundGrid == foundIndex ? "same results" : "RESULTS DIFFER");
+
+    for(size_t i = 0; i < units.size(); ++i)
+        delete units[i];
+}
+
+int main()
+{
+    srand(1);
+    unsigned int const sizes[] = { 50, 200, 1000 };
+    float const radii[] = { 8.0f, 30.0f };
+    for(unsigned int s = 0; s < sizeof(sizes)/sizeof(sizes[0]); ++s)
+        for(unsigned int r = 0; r < sizeof(radii)/sizeof(radii[0]); ++r)
+            Run(sizes[s], radii[r]);
+    return 0;
+}
@@ -0,0 +1,3 @@
+DELETE FROM command WHERE name = 'debug netstats';
+INSERT INTO `command` VALUES
+('debug netstats',3,'Syntax: .debug netstats [$playername]\r\n\r\nShow output queue size, dropped low priority packets and queue flush time for connection of selected or named player.');
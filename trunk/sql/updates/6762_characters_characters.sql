@@ -0,0 +1,2 @@
+ALTER TABLE characters
+  CHANGE COLUMN data data longblob;
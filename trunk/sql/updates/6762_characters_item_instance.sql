@@ -0,0 +1,2 @@
+ALTER TABLE item_instance
+  CHANGE COLUMN data data longblob;
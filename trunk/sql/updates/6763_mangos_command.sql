@@ -0,0 +1,3 @@
+DELETE FROM command WHERE name = 'debug vmapstats';
+INSERT INTO `command` VALUES
+('debug vmapstats',3,'Syntax: .debug vmapstats\r\n\r\nShow line of sight cache hits and misses of currently loaded vmaps.');
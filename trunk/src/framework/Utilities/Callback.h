@@ -39,7 +39,7 @@ namespace MaNGOS
             _Callback(Class *object, Method method, ParamType1 param1, ParamType2 param2, ParamType3 param3, ParamType4 param4)
                 : m_object(object), m_method(method), m_param1(param1), m_param2(param2), m_param3(param3), m_param4(param4) {}
             _Callback(_Callback < Class, ParamType1, ParamType2, ParamType3, ParamType4> const& cb)
-                : m_object(cb.object), m_method(cb.m_method), m_param1(cb.m_param1), m_param2(cb.m_param2), m_param3(cb.m_param3), m_param4(cb.m_param4) {}
+                : m_object(cb.m_object), m_method(cb.m_method), m_param1(cb.m_param1), m_param2(cb.m_param2), m_param3(cb.m_param3), m_param4(cb.m_param4) {}
     };
 
     template < class Class, typename ParamType1, typename ParamType2, typename ParamType3 >
@@ -55,9 +55,9 @@ namespace MaNGOS
             void _Execute() { (m_object->*m_method)(m_param1, m_param2, m_param3); }
         public:
             _Callback(Class *object, Method method, ParamType1 param1, ParamType2 param2, ParamType3 param3)
-                : m_object(object), m_method(method), m_param1(param1), m_param2(param2) {}
+                : m_object(object), m_method(method), m_param1(param1), m_param2(param2), m_param3(param3) {}
             _Callback(_Callback < Class, ParamType1, ParamType2, ParamType3 > const& cb)
-                : m_object(cb.object), m_method(cb.m_method), m_param1(cb.m_param1), m_param2(cb.m_param2), m_param3(cb.m_param3) {}
+                : m_object(cb.m_object), m_method(cb.m_method), m_param1(cb.m_param1), m_param2(cb.m_param2), m_param3(cb.m_param3) {}
     };
 
     template < class Class, typename ParamType1, typename ParamType2 >
@@ -140,7 +140,7 @@ namespace MaNGOS
             void _Execute() { (*m_method)(m_param1, m_param2, m_param3); }
         public:
             _SCallback(Method method, ParamType1 param1, ParamType2 param2, ParamType3 param3)
-                : m_method(method), m_param1(param1), m_param2(param2) {}
+                : m_method(method), m_param1(param1), m_param2(param2), m_param3(param3) {}
             _SCallback(_SCallback < ParamType1, ParamType2, ParamType3 > const& cb)
                 : m_method(cb.m_method), m_param1(cb.m_param1), m_param2(cb.m_param2), m_param3(cb.m_param3) {}
     };
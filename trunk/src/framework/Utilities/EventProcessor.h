@@ -21,7 +21,7 @@
 
 #include "Platform/Define.h"
 
-#include<map>
+#include<vector>
 
 // Note. All times are in milliseconds here.
 
@@ -48,7 +48,24 @@ class BasicEvent
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
 };
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
+// queued event, events with same execution time are executed in adding order
+struct EventQueueEntry
+{
+    EventQueueEntry(uint64 e_time, uint64 order, BasicEvent* e) : execTime(e_time), addOrder(order), event(e) {}
+
+    // inverted for std heap functions, so earliest event is at heap top
+    bool operator<(EventQueueEntry const& r) const
+    {
+        return execTime > r.execTime || (execTime == r.execTime && addOrder > r.addOrder);
+    }
+
+    uint64 execTime;
+    uint64 addOrder;
+    BasicEvent* event;
+};
+
+// binary heap in vector: memory reused by next events, no allocation per added event
+typedef std::vector<EventQueueEntry> EventList;
 
 class EventProcessor
 {
@@ -63,6 +80,7 @@ class EventProcessor
     protected:
         uint64 m_time;
         EventList m_events;
+        uint64 m_addOrder;
         bool m_aborting;
 };
 #endif
@@ -639,7 +639,7 @@ void WorldSession::HandleAuctionListItems( WorldPacket & recv_data )
 {
     CHECK_PACKET_SIZE(recv_data,8+4+1+1+1+4+4+4+4+1);
 
-    std::string searchedname, name;
+    std::string searchedname;
     uint8 levelmin, levelmax, usable, location;
     uint32 count, totalcount, listfrom, auctionSlotID, auctionMainCategory, auctionSubCategory, quality;
     uint64 guid;
@@ -672,74 +672,35 @@ void WorldSession::HandleAuctionListItems( WorldPacket & recv_data )
 
     //sLog.outDebug("Auctionhouse search guid: " I64FMTD ", list from: %u, searchedname: %s, levelmin: %u, levelmax: %u, auctionSlotID: %u, auctionMainCategory: %u, auctionSubCategory: %u, quality: %u, usable: %u", guid, listfrom, searchedname.c_str(), levelmin, levelmax, auctionSlotID, auctionMainCategory, auctionSubCategory, quality, usable);
 
+    // converting string that we try to find to lower case
+    AuctionSearchQuery query;
+    if(!Utf8toWStr(searchedname,query.name))
+        return;
+
+    wstrToLower(query.name);
+
+    query.locale = GetSessionDbLocaleIndex();
+    query.levelmin = levelmin;
+    query.levelmax = levelmax;
+    query.inventoryType = auctionSlotID;
+    query.itemClass = auctionMainCategory;
+    query.itemSubClass = auctionSubCategory;
+    query.quality = quality;
+    query.usableBy = usable ? _player : NULL;
+    query.listfrom = listfrom;
+
+    // candidates selected by auction house index, only listed page auctions are collected
+    std::vector<AuctionEntry*> auctions;
+    totalcount = mAuctions->Search(query, auctions, 50);
+
     WorldPacket data( SMSG_AUCTION_LIST_RESULT, (4+4+4) );
     count = 0;
-    totalcount = 0;
     data << (uint32) 0;
 
-    // converting string that we try to find to lower case
-    std::wstring wsearchedname;
-    if(!Utf8toWStr(searchedname,wsearchedname))
-        return;
-
-    wstrToLower(wsearchedname);
+    for(std::vector<AuctionEntry*>::const_iterator itr = auctions.begin(); itr != auctions.end(); ++itr)
+        if(SendAuctionInfo(data, *itr))
+            ++count;
 
-    for (AuctionHouseObject::AuctionEntryMap::iterator itr = mAuctions->GetAuctionsBegin();itr != mAuctions->GetAuctionsEnd();++itr)
-    {
-        AuctionEntry *Aentry = itr->second;
-        Item *item = objmgr.GetAItem(Aentry->item_guidlow);
-        if( item )
-        {
-            ItemPrototype const *proto = item->GetProto();
-            if( proto )
-            {
-                if( auctionMainCategory == (0xffffffff) || proto->Class == auctionMainCategory )
-                {
-                    if( auctionSubCategory == (0xffffffff) || proto->SubClass == auctionSubCategory )
-                    {
-                        if( auctionSlotID == (0xffffffff) || proto->InventoryType == auctionSlotID )
-                        {
-                            if( quality == (0xffffffff) || proto->Quality == quality )
-                            {
-                                if( usable == (0x00) || _player->CanUseItem( item ) == EQUIP_ERR_OK )
-                                {
-                                    if( ( levelmin == (0x00) || proto->RequiredLevel >= levelmin ) && ( levelmax == (0x00) || proto->RequiredLevel <= levelmax ) )
-                                    {
-                                        name = proto->Name1;
-
-                                        // local name
-                                        int loc_idx = GetSessionDbLocaleIndex();
-                                        if ( loc_idx >= 0 )
-                                        {
-                                            ItemLocale const *il = objmgr.GetItemLocale(proto->ItemId);
-                                            if (il)
-                                            {
-                                                if (il->Name.size() > loc_idx && !il->Name[loc_idx].empty())
-                                                    name = il->Name[loc_idx];
-                                            }
-                                        }
-
-                                        if(name.empty())
-                                            continue;
-
-                                        if( wsearchedname.empty() || Utf8FitTo(name, wsearchedname) )
-                                        {
-                                            if ((count < 50) && (totalcount >= listfrom))
-                                            {
-                                                ++count;
-                                                SendAuctionInfo( data, Aentry);
-                                            }
-                                            ++totalcount;
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
     data.put<uint32>(0, count);
     data << (uint32) totalcount;
     data << (uint32) 300;                                   // unk 2.3.0 const?
@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Common.h"
+#include "ObjectMgr.h"
+#include "AuctionHouseObject.h"
+#include "Player.h"
+#include "Util.h"
+
+#include <algorithm>
+
+static std::wstring LowerItemName(std::string const& name)
+{
+    std::wstring wname;
+    if(!Utf8toWStr(name, wname))
+        return std::wstring();
+
+    wstrToLower(wname);
+    return wname;
+}
+
+static bool AuctionIdLess(AuctionEntry const* a, AuctionEntry const* b)
+{
+    return a->Id < b->Id;
+}
+
+template<class T>
+static void AddToBucket(std::map<uint32, T>& index, uint32 key, AuctionEntry* auction)
+{
+    index[key][auction->Id] = auction;
+}
+
+template<class T>
+static void RemoveFromBucket(std::map<uint32, T>& index, uint32 key, uint32 id)
+{
+    typename std::map<uint32, T>::iterator itr = index.find(key);
+    if(itr == index.end())
+        return;
+
+    itr->second.erase(id);
+    if(itr->second.empty())
+        index.erase(itr);
+}
+
+void AuctionHouseObject::AddToIndex(AuctionEntry* auction)
+{
+    AuctionTemplateMap::iterator tItr = m_templates.find(auction->item_template);
+    if(tItr == m_templates.end())
+    {
+        ItemPrototype const* proto = objmgr.GetItemPrototype(auction->item_template);
+        if(!proto)
+            return;
+
+        AuctionTemplateInfo& info = m_templates[auction->item_template];
+        info.proto = proto;
+        info.names.push_back(LowerItemName(proto->Name1));
+        if(ItemLocale const* il = objmgr.GetItemLocale(proto->ItemId))
+            for(size_t i = 0; i < il->Name.size(); ++i)
+                info.names.push_back(LowerItemName(il->Name[i]));
+
+        tItr = m_templates.find(auction->item_template);
+    }
+
+    ++tItr->second.auctions;
+    ItemPrototype const* proto = tItr->second.proto;
+
+    m_indexed[auction->Id] = auction;
+    AddToBucket(m_byClass, proto->Class, auction);
+    AddToBucket(m_bySubClass, proto->Class << 16 | proto->SubClass, auction);
+    AddToBucket(m_byInventoryType, proto->InventoryType, auction);
+    AddToBucket(m_byQuality, proto->Quality, auction);
+    AddToBucket(m_byRequiredLevel, proto->RequiredLevel, auction);
+}
+
+void AuctionHouseObject::RemoveFromIndex(AuctionEntry* auction)
+{
+    AuctionTemplateMap::iterator tItr = m_templates.find(auction->item_template);
+    if(tItr == m_templates.end())
+        return;
+
+    ItemPrototype const* proto = tItr->second.proto;
+
+    m_indexed.erase(auction->Id);
+    RemoveFromBucket(m_byClass, proto->Class, auction->Id);
+    RemoveFromBucket(m_bySubClass, proto->Class << 16 | proto->SubClass, auction->Id);
+    RemoveFromBucket(m_byInventoryType, proto->InventoryType, auction->Id);
+    RemoveFromBucket(m_byQuality, proto->Quality, auction->Id);
+    RemoveFromBucket(m_byRequiredLevel, proto->RequiredLevel, auction->Id);
+
+    if(--tItr->second.auctions == 0)
+        m_templates.erase(tItr);
+}
+
+bool AuctionHouseObject::IsMatching(AuctionEntry const* auction, AuctionSearchQuery const& query, NameMatchMap& nameMatches) const
+{
+    AuctionTemplateMap::const_iterator tItr = m_templates.find(auction->item_template);
+    if(tItr == m_templates.end())
+        return false;
+
+    AuctionTemplateInfo const& info = tItr->second;
+    ItemPrototype const* proto = info.proto;
+
+    if( query.itemClass != 0xFFFFFFFF && proto->Class != query.itemClass )
+        return false;
+    if( query.itemSubClass != 0xFFFFFFFF && proto->SubClass != query.itemSubClass )
+        return false;
+    if( query.inventoryType != 0xFFFFFFFF && proto->InventoryType != query.inventoryType )
+        return false;
+    if( query.quality != 0xFFFFFFFF && proto->Quality != query.quality )
+        return false;
+    if( ( query.levelmin != 0 && proto->RequiredLevel < query.levelmin ) || ( query.levelmax != 0 && proto->RequiredLevel > query.levelmax ) )
+        return false;
+
+    // name check result is same for all auctions of the item template
+    NameMatchMap::const_iterator nItr = nameMatches.find(auction->item_template);
+    if(nItr == nameMatches.end())
+    {
+        std::wstring const* name = &info.names[0];
+        if(query.locale >= 0 && size_t(query.locale + 1) < info.names.size() && !info.names[query.locale + 1].empty())
+            name = &info.names[query.locale + 1];
+
+        bool match = !name->empty() && ( query.name.empty() || name->find(query.name) != std::wstring::npos );
+        nItr = nameMatches.insert(NameMatchMap::value_type(auction->item_template, match)).first;
+    }
+
+    if(!nItr->second)
+        return false;
+
+    // auctions with lost item are not listed
+    Item* item = objmgr.GetAItem(auction->item_guidlow);
+    if(!item)
+        return false;
+
+    if(query.usableBy && query.usableBy->CanUseItem(item) != EQUIP_ERR_OK)
+        return false;
+
+    return true;
+}
+
+uint32 AuctionHouseObject::Search(AuctionSearchQuery const& query, std::vector<AuctionEntry*>& result, uint32 maxCount) const
+{
+    // select smallest index bucket as candidates list, it covers one of filters
+    AuctionEntryMap const* candidates = &m_indexed;
+    AuctionIndexMap const* index = NULL;
+    uint32 key = 0;
+
+    if(query.itemClass != 0xFFFFFFFF)
+    {
+        if(query.itemSubClass != 0xFFFFFFFF)
+        {
+            index = &m_bySubClass;
+            key = query.itemClass << 16 | query.itemSubClass;
+        }
+        else
+        {
+            index = &m_byClass;
+            key = query.itemClass;
+        }
+
+        AuctionIndexMap::const_iterator itr = index->find(key);
+        if(itr == index->end())
+            return 0;
+
+        if(itr->second.size() < candidates->size())
+            candidates = &itr->second;
+    }
+    if(query.inventoryType != 0xFFFFFFFF)
+    {
+        AuctionIndexMap::const_iterator itr = m_byInventoryType.find(query.inventoryType);
+        if(itr == m_byInventoryType.end())
+            return 0;
+
+        if(itr->second.size() < candidates->size())
+            candidates = &itr->second;
+    }
+
+    if(query.quality != 0xFFFFFFFF)
+    {
+        AuctionIndexMap::const_iterator itr = m_byQuality.find(query.quality);
+        if(itr == m_byQuality.end())
+            return 0;
+
+        if(itr->second.size() < candidates->size())
+            candidates = &itr->second;
+    }
+
+    // required level range selects several buckets, merged only if they are smaller than selected candidates
+    std::vector<AuctionEntry*> levelCandidates;
+    bool byLevel = false;
+    if(query.levelmin != 0 || query.levelmax != 0)
+    {
+        AuctionIndexMap::const_iterator lower = m_byRequiredLevel.lower_bound(query.levelmin);
+        AuctionIndexMap::const_iterator upper = query.levelmax != 0 ? m_byRequiredLevel.upper_bound(query.levelmax) : m_byRequiredLevel.end();
+
+        size_t size = 0;
+        for(AuctionIndexMap::const_iterator itr = lower; itr != upper; ++itr)
+            size += itr->second.size();
+
+        if(!size)
+            return 0;
+
+        if(size < candidates->size())
+        {
+            byLevel = true;
+            levelCandidates.reserve(size);
+            for(AuctionIndexMap::const_iterator itr = lower; itr != upper; ++itr)
+                for(AuctionEntryMap::const_iterator aItr = itr->second.begin(); aItr != itr->second.end(); ++aItr)
+                    levelCandidates.push_back(aItr->second);
+
+            std::sort(levelCandidates.begin(), levelCandidates.end(), AuctionIdLess);
+        }
+    }
+
+    NameMatchMap nameMatches;
+    uint32 totalcount = 0;
+
+    if(byLevel)
+    {
+        for(std::vector<AuctionEntry*>::const_iterator itr = levelCandidates.begin(); itr != levelCandidates.end(); ++itr)
+        {
+            if(!IsMatching(*itr, query, nameMatches))
+                continue;
+
+            if(totalcount >= query.listfrom && result.size() < maxCount)
+                result.push_back(*itr);
+            ++totalcount;
+        }
+    }
+    else
+    {
+        for(AuctionEntryMap::const_iterator itr = candidates->begin(); itr != candidates->end(); ++itr)
+        {
+            if(!IsMatching(itr->second, query, nameMatches))
+                continue;
+
+            if(totalcount >= query.listfrom && result.size() < maxCount)
+                result.push_back(itr->second);
+            ++totalcount;
+        }
+    }
+
+    return totalcount;
+}
@@ -55,6 +55,24 @@ struct AuctionEntry
     uint32 location;
 };
 
+struct ItemPrototype;
+class Player;
+
+/// auction list filters as received in CMSG_AUCTION_LIST_ITEMS, 0xFFFFFFFF/0 for not used ones
+struct AuctionSearchQuery
+{
+    std::wstring name;                                      // lower case
+    int locale;                                             // db locale index for item names, -1 for default names
+    uint8 levelmin;
+    uint8 levelmax;
+    uint32 inventoryType;
+    uint32 itemClass;
+    uint32 itemSubClass;
+    uint32 quality;
+    Player* usableBy;                                       // NULL if not filtered by CanUseItem
+    uint32 listfrom;
+};
+
 //this class is used as auctionhouse instance
 class AuctionHouseObject
 {
@@ -77,6 +95,8 @@ class AuctionHouseObject
         {
             ASSERT( ah );
             AuctionsMap[ah->Id] = ah;
+            m_expireQueue.insert(AuctionExpireQueue::value_type(ah->time, ah->Id));
+            AddToIndex(ah);
         }
 
         AuctionEntry* GetAuction(uint32 id) const
@@ -87,6 +107,7 @@ class AuctionHouseObject
             return NULL;
         }
 
+        // must be called before auction entry delete
         bool RemoveAuction(uint32 id)
         {
             AuctionEntryMap::iterator i = AuctionsMap.find(id);
@@ -94,11 +115,55 @@ class AuctionHouseObject
             {
                 return false;
             }
+            RemoveFromIndex(i->second);
+            m_expireQueue.erase(AuctionExpireQueue::value_type(i->second->time, id));
             AuctionsMap.erase(i);
             return true;
         }
 
+        /// auction with earliest expire time if it expired before now, NULL otherwise
+        AuctionEntry* GetExpiredAuction(time_t now) const
+        {
+            if( m_expireQueue.empty() || m_expireQueue.begin()->first >= now )
+                return NULL;
+            return GetAuction(m_expireQueue.begin()->second);
+        }
+
+        /// auctions matching query in Id order: up to maxCount of them starting from query.listfrom into result,
+        /// total count of matching auctions returned
+        uint32 Search(AuctionSearchQuery const& query, std::vector<AuctionEntry*>& result, uint32 maxCount) const;
+
     private:
+        // item template data used in searches, shared by all auctions with the item
+        struct AuctionTemplateInfo
+        {
+            AuctionTemplateInfo() : proto(NULL), auctions(0) {}
+
+            ItemPrototype const* proto;
+            std::vector<std::wstring> names;                // lower case, [0] default name, [i+1] db locale i name
+            uint32 auctions;
+        };
+
+        typedef std::map<uint32, AuctionTemplateInfo> AuctionTemplateMap;
+        typedef std::map<uint32, AuctionEntryMap> AuctionIndexMap;
+        typedef std::map<uint32, bool> NameMatchMap;        // item template -> name match in current search
+
+        void AddToIndex(AuctionEntry* auction);
+        void RemoveFromIndex(AuctionEntry* auction);
+        bool IsMatching(AuctionEntry const* auction, AuctionSearchQuery const& query, NameMatchMap& nameMatches) const;
+
         AuctionEntryMap AuctionsMap;
+
+        typedef std::set<std::pair<time_t, uint32> > AuctionExpireQueue;
+        AuctionExpireQueue m_expireQueue;                   // (expire time, auction id), earliest first
+
+        // search index, auctions with unknown item template not listed
+        AuctionEntryMap m_indexed;
+        AuctionTemplateMap m_templates;
+        AuctionIndexMap m_byClass;                          // proto->Class
+        AuctionIndexMap m_bySubClass;                       // proto->Class << 16 | proto->SubClass
+        AuctionIndexMap m_byInventoryType;
+        AuctionIndexMap m_byQuality;
+        AuctionIndexMap m_byRequiredLevel;
 };
 #endif
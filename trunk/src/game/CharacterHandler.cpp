@@ -35,6 +35,7 @@
 #include "Database/DatabaseImpl.h"
 #include "PlayerDump.h"
 #include "SocialMgr.h"
+#include "CharacterSnapshotCache.h"
 #include "Util.h"
 #include "Language.h"
 
@@ -48,41 +49,58 @@ class LoginQueryHolder : public SqlQueryHolder
             : m_accountId(accountId), m_guid(guid) { }
         uint64 GetGuid() const { return m_guid; }
         uint32 GetAccountId() const { return m_accountId; }
-        bool Initialize();
+        /// snapshot holders leave the mail queries to InitializeMail at login
+        bool Initialize(bool snapshot = false);
+        bool InitializeMail();
 };
 
-bool LoginQueryHolder::Initialize()
+// prepared statements of login queries, by query index
+static SqlStatementID sLoginStmts[MAX_PLAYER_LOGIN_QUERY];
+
+bool LoginQueryHolder::Initialize(bool snapshot)
 {
     SetSize(MAX_PLAYER_LOGIN_QUERY);
 
     bool res = true;
 
+    SqlStmtParameters byGuid;
+    byGuid << GUID_LOPART(m_guid);
+
     // NOTE: all fields in `characters` must be read to prevent lost character data at next save in case wrong DB structure.
     // !!! NOTE: including unused `zone`,`online`
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADFROM,            "SELECT guid, account, data, name, race, class, position_x, position_y, position_z, map, orientation, taximask, cinematic, totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost, resettalents_time, trans_x, trans_y, trans_z, trans_o, transguid, gmstate, stable_slots, at_login, zone, online, death_expire_time, taxi_path, dungeon_difficulty FROM characters WHERE guid = '%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADGROUP,           "SELECT leaderGuid FROM group_member WHERE memberGuid ='%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADBOUNDINSTANCES,  "SELECT id, permanent, map, difficulty, resettime FROM character_instance LEFT JOIN instance ON instance = id WHERE guid = '%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADAURAS,           "SELECT caster_guid,spell,effect_index,amount,maxduration,remaintime,remaincharges FROM character_aura WHERE guid = '%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADSPELLS,          "SELECT spell,slot,active,disabled FROM character_spell WHERE guid = '%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADQUESTSTATUS,     "SELECT quest,status,rewarded,explored,timer,mobcount1,mobcount2,mobcount3,mobcount4,itemcount1,itemcount2,itemcount3,itemcount4 FROM character_queststatus WHERE guid = '%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADDAILYQUESTSTATUS,"SELECT quest,time FROM character_queststatus_daily WHERE guid = '%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADTUTORIALS,       "SELECT tut0,tut1,tut2,tut3,tut4,tut5,tut6,tut7 FROM character_tutorial WHERE account = '%u' AND realmid = '%u'", GetAccountId(), realmID);
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADREPUTATION,      "SELECT faction,standing,flags FROM character_reputation WHERE guid = '%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADINVENTORY,       "SELECT data,bag,slot,item,item_template FROM character_inventory JOIN item_instance ON character_inventory.item = item_instance.guid WHERE character_inventory.guid = '%u' ORDER BY bag,slot", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADACTIONS,         "SELECT button,action,type,misc FROM character_action WHERE guid = '%u' ORDER BY button", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADMAILCOUNT,       "SELECT COUNT(id) FROM mail WHERE receiver = '%u' AND (checked & 1)=0 AND deliver_time <= '" I64FMTD "'", GUID_LOPART(m_guid),(uint64)time(NULL));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADMAILDATE,        "SELECT MIN(deliver_time) FROM mail WHERE receiver = '%u' AND (checked & 1)=0", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADSOCIALLIST,      "SELECT friend,flags,note FROM character_social WHERE guid = '%u' LIMIT 255", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADHOMEBIND,        "SELECT map,zone,position_x,position_y,position_z FROM character_homebind WHERE guid = '%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADSPELLCOOLDOWNS,  "SELECT spell,item,time FROM character_spell_cooldown WHERE guid = '%u'", GUID_LOPART(m_guid));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADFROM,             sLoginStmts[PLAYER_LOGIN_QUERY_LOADFROM], "SELECT guid, account, data, name, race, class, position_x, position_y, position_z, map, orientation, taximask, cinematic, totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost, resettalents_time, trans_x, trans_y, trans_z, trans_o, transguid, gmstate, stable_slots, at_login, zone, online, death_expire_time, taxi_path, dungeon_difficulty FROM characters WHERE guid = ?", byGuid);
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADGROUP,            sLoginStmts[PLAYER_LOGIN_QUERY_LOADGROUP], "SELECT leaderGuid FROM group_member WHERE memberGuid = ?", byGuid);
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADBOUNDINSTANCES,   sLoginStmts[PLAYER_LOGIN_QUERY_LOADBOUNDINSTANCES], "SELECT id, permanent, map, difficulty, resettime FROM character_instance LEFT JOIN instance ON instance = id WHERE guid = ?", byGuid);
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADAURAS,            sLoginStmts[PLAYER_LOGIN_QUERY_LOADAURAS], "SELECT caster_guid,spell,effect_index,amount,maxduration,remaintime,remaincharges FROM character_aura WHERE guid = ?", byGuid);
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADSPELLS,           sLoginStmts[PLAYER_LOGIN_QUERY_LOADSPELLS], "SELECT spell,slot,active,disabled FROM character_spell WHERE guid = ?", byGuid);
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADQUESTSTATUS,      sLoginStmts[PLAYER_LOGIN_QUERY_LOADQUESTSTATUS], "SELECT quest,status,rewarded,explored,timer,mobcount1,mobcount2,mobcount3,mobcount4,itemcount1,itemcount2,itemcount3,itemcount4 FROM character_queststatus WHERE guid = ?", byGuid);
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADDAILYQUESTSTATUS, sLoginStmts[PLAYER_LOGIN_QUERY_LOADDAILYQUESTSTATUS], "SELECT quest,time FROM character_queststatus_daily WHERE guid = ?", byGuid);
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADTUTORIALS,        sLoginStmts[PLAYER_LOGIN_QUERY_LOADTUTORIALS], "SELECT tut0,tut1,tut2,tut3,tut4,tut5,tut6,tut7 FROM character_tutorial WHERE account = ? AND realmid = ?", SqlStmtParameters() << GetAccountId() << realmID);
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADREPUTATION,       sLoginStmts[PLAYER_LOGIN_QUERY_LOADREPUTATION], "SELECT faction,standing,flags FROM character_reputation WHERE guid = ?", byGuid);
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADINVENTORY,        sLoginStmts[PLAYER_LOGIN_QUERY_LOADINVENTORY], "SELECT data,bag,slot,item,item_template FROM character_inventory JOIN item_instance ON character_inventory.item = item_instance.guid WHERE character_inventory.guid = ? ORDER BY bag,slot", byGuid);
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADACTIONS,          sLoginStmts[PLAYER_LOGIN_QUERY_LOADACTIONS], "SELECT button,action,type,misc FROM character_action WHERE guid = ? ORDER BY button", byGuid);
+    if(!snapshot)
+        res &= InitializeMail();
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADSOCIALLIST,       sLoginStmts[PLAYER_LOGIN_QUERY_LOADSOCIALLIST], "SELECT friend,flags,note FROM character_social WHERE guid = ? LIMIT 255", byGuid);
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADHOMEBIND,         sLoginStmts[PLAYER_LOGIN_QUERY_LOADHOMEBIND], "SELECT map,zone,position_x,position_y,position_z FROM character_homebind WHERE guid = ?", byGuid);
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADSPELLCOOLDOWNS,   sLoginStmts[PLAYER_LOGIN_QUERY_LOADSPELLCOOLDOWNS], "SELECT spell,item,time FROM character_spell_cooldown WHERE guid = ?", byGuid);
     if(sWorld.getConfig(CONFIG_DECLINED_NAMES_USED))
-        res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADDECLINEDNAMES,   "SELECT genitive, dative, accusative, instrumental, prepositional FROM character_declinedname WHERE guid = '%u'",GUID_LOPART(m_guid));
+        res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADDECLINEDNAMES,    sLoginStmts[PLAYER_LOGIN_QUERY_LOADDECLINEDNAMES], "SELECT genitive, dative, accusative, instrumental, prepositional FROM character_declinedname WHERE guid = ?", byGuid);
     // in other case still be dummy query
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADGUILD,           "SELECT guildid,rank FROM guild_member WHERE guid = '%u'", GUID_LOPART(m_guid));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADGUILD,            sLoginStmts[PLAYER_LOGIN_QUERY_LOADGUILD], "SELECT guildid,rank FROM guild_member WHERE guid = ?", byGuid);
 
     return res;
 }
 
+// mail is sent to offline characters and delivered by time, so it is never taken from a snapshot
+bool LoginQueryHolder::InitializeMail()
+{
+    bool res = true;
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADMAILCOUNT,        sLoginStmts[PLAYER_LOGIN_QUERY_LOADMAILCOUNT], "SELECT COUNT(id) FROM mail WHERE receiver = ? AND (checked & 1)=0 AND deliver_time <= ?", SqlStmtParameters() << GUID_LOPART(m_guid) << (uint64)time(NULL));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADMAILDATE,         sLoginStmts[PLAYER_LOGIN_QUERY_LOADMAILDATE], "SELECT MIN(deliver_time) FROM mail WHERE receiver = ? AND (checked & 1)=0", SqlStmtParameters() << GUID_LOPART(m_guid));
+    return res;
+}
+
 // don't call WorldSession directly
 // it may get deleted before the query callbacks get executed
 // instead pass an account id to this handler
@@ -110,6 +128,11 @@ class CharacterHandler
             }
             session->HandlePlayerLogin((LoginQueryHolder*)holder);
         }
+        void HandleSnapshotCallback(QueryResult * /*dummy*/, SqlQueryHolder * holder, uint32 requestId)
+        {
+            if (!holder) return;
+            sCharacterSnapshotCache.Store(GUID_LOPART(((LoginQueryHolder*)holder)->GetGuid()), requestId, holder);
+        }
 } chrHandler;
 
 void WorldSession::HandleCharEnum(QueryResult * result)
@@ -457,6 +480,16 @@ void WorldSession::HandlePlayerLoginOpcode( WorldPacket & recv_data )
 
     recv_data >> playerGuid;
 
+    // login data loaded at recent logout, "GetAccountId()==db stored account id" still checked in LoadFromDB
+    // only the mail queries are run, queued after mail sent meanwhile
+    if(LoginQueryHolder *snapshot = (LoginQueryHolder*)sCharacterSnapshotCache.Take(GUID_LOPART(playerGuid)))
+    {
+        if(snapshot->InitializeMail() && CharacterDatabase.DelayQueryHolder(&chrHandler, &CharacterHandler::HandlePlayerLoginCallback, (SqlQueryHolder*)snapshot))
+            return;
+
+        delete snapshot;
+    }
+
     LoginQueryHolder *holder = new LoginQueryHolder(GetAccountId(), playerGuid);
     if(!holder->Initialize())
     {
@@ -468,6 +501,27 @@ void WorldSession::HandlePlayerLoginOpcode( WorldPacket & recv_data )
     CharacterDatabase.DelayQueryHolder(&chrHandler, &CharacterHandler::HandlePlayerLoginCallback, holder);
 }
 
+void WorldSession::LoadCharacterSnapshot(uint64 guid)
+{
+    if(!sCharacterSnapshotCache.IsEnabled() || World::m_stopEvent)
+        return;
+
+    // queued after logout saves, so the results are the saved state
+    LoginQueryHolder *holder = new LoginQueryHolder(GetAccountId(), guid);
+    if(!holder->Initialize(true))
+    {
+        delete holder;
+        return;
+    }
+
+    uint32 requestId = sCharacterSnapshotCache.Request(GUID_LOPART(guid), GetAccountId());
+    if(!CharacterDatabase.DelayQueryHolder(&chrHandler, &CharacterHandler::HandleSnapshotCallback, (SqlQueryHolder*)holder, requestId))
+    {
+        sCharacterSnapshotCache.Invalidate(GUID_LOPART(guid));
+        delete holder;
+    }
+}
+
 void WorldSession::HandlePlayerLogin(LoginQueryHolder * holder)
 {
     uint64 playerGuid = holder->GetGuid();
@@ -978,6 +1032,7 @@ void WorldSession::HandleChangePlayerNameOpcode(WorldPacket& recv_data)
     CharacterDatabase.escape_string(newname);
     CharacterDatabase.PExecute("UPDATE characters set name = '%s', at_login = at_login & ~ %u WHERE guid ='%u'", newname.c_str(), uint32(AT_LOGIN_RENAME),GUID_LOPART(guid));
     CharacterDatabase.PExecute("DELETE FROM character_declinedname WHERE guid ='%u'", GUID_LOPART(guid));
+    sCharacterSnapshotCache.Invalidate(GUID_LOPART(guid));
 
     std::string IP_str = GetRemoteAddress();
     sLog.outChar("Account: %d (IP: %s) Character:[%s] (guid:%u) Changed name to: %s",GetAccountId(),IP_str.c_str(),oldname.c_str(),GUID_LOPART(guid),newname.c_str());
@@ -1072,6 +1127,7 @@ void WorldSession::HandleDeclinedPlayerNameOpcode(WorldPacket& recv_data)
     CharacterDatabase.PExecute("INSERT INTO character_declinedname (guid, genitive, dative, accusative, instrumental, prepositional) VALUES ('%u','%s','%s','%s','%s','%s')",
         GUID_LOPART(guid), declinedname.name[0].c_str(), declinedname.name[1].c_str(), declinedname.name[2].c_str(), declinedname.name[3].c_str(), declinedname.name[4].c_str());
     CharacterDatabase.CommitTransaction();
+    sCharacterSnapshotCache.Invalidate(GUID_LOPART(guid));
 
     WorldPacket data(SMSG_SET_PLAYER_DECLINED_NAMES_RESULT, 4+8);
     data << uint32(0);                                      // OK
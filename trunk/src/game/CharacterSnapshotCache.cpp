@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "CharacterSnapshotCache.h"
+#include "Policies/SingletonImp.h"
+#include "Database/DatabaseEnv.h"
+#include "Database/SqlOperations.h"
+#include "World.h"
+#include "zthread/Guard.h"
+
+#define CHARACTER_SNAPSHOT_STATS_INTERVAL   MINUTE
+
+INSTANTIATE_SINGLETON_1( CharacterSnapshotCache );
+
+CharacterSnapshotCache::CharacterSnapshotCache() : m_nextRequestId(1), m_statTime(time(NULL)),
+    m_statHits(0), m_statMisses(0), m_statExpired(0), m_statInvalidated(0)
+{
+}
+
+CharacterSnapshotCache::~CharacterSnapshotCache()
+{
+    Clear();
+}
+
+bool CharacterSnapshotCache::IsEnabled() const
+{
+    return sWorld.getConfig(CONFIG_CHARACTER_SNAPSHOT_COUNT) > 0;
+}
+
+uint32 CharacterSnapshotCache::Request(uint32 guidlow, uint32 account)
+{
+    ZThread::Guard<ZThread::FastMutex> guard(m_lock);
+
+    SnapshotMap::iterator itr = m_snapshots.find(guidlow);
+    if(itr != m_snapshots.end())
+        Remove(itr);
+
+    m_lru.push_front(guidlow);
+
+    Snapshot& snapshot = m_snapshots[guidlow];
+    snapshot.requestId = m_nextRequestId++;
+    snapshot.account = account;
+    snapshot.holder = NULL;
+    snapshot.time = time(NULL);
+    snapshot.lru = m_lru.begin();
+
+    // loading requests are counted also, their results are dropped at arrival
+    while(m_snapshots.size() > sWorld.getConfig(CONFIG_CHARACTER_SNAPSHOT_COUNT))
+        Remove(m_snapshots.find(m_lru.back()));
+
+    return snapshot.requestId;
+}
+
+void CharacterSnapshotCache::Store(uint32 guidlow, uint32 requestId, SqlQueryHolder* holder)
+{
+    ZThread::Guard<ZThread::FastMutex> guard(m_lock);
+
+    SnapshotMap::iterator itr = m_snapshots.find(guidlow);
+    if(itr == m_snapshots.end() || itr->second.requestId != requestId)
+    {
+        delete holder;                                      // invalidated or evicted while loading
+        return;
+    }
+
+    itr->second.holder = holder;
+    itr->second.time = time(NULL);
+}
+
+SqlQueryHolder* CharacterSnapshotCache::Take(uint32 guidlow)
+{
+    ZThread::Guard<ZThread::FastMutex> guard(m_lock);
+
+    time_t now = time(NULL);
+    if(now >= m_statTime + CHARACTER_SNAPSHOT_STATS_INTERVAL && (m_statHits || m_statMisses))
+    {
+        sLog.outDetail("Character snapshots: %u used, %u not found, %u expired, %u invalidated, %u kept",
+            m_statHits, m_statMisses, m_statExpired, m_statInvalidated, (uint32)m_snapshots.size());
+
+        m_statTime = now;
+        m_statHits = 0;
+        m_statMisses = 0;
+        m_statExpired = 0;
+        m_statInvalidated = 0;
+    }
+
+    SnapshotMap::iterator itr = m_snapshots.find(guidlow);
+    if(itr == m_snapshots.end())
+    {
+        ++m_statMisses;
+        return NULL;
+    }
+
+    // a snapshot still loading is dropped also: it can't be used for later login after saves of this session
+    SqlQueryHolder* holder = itr->second.holder;
+    itr->second.holder = NULL;
+    bool expired = holder && now >= itr->second.time + time_t(sWorld.getConfig(CONFIG_CHARACTER_SNAPSHOT_EXPIRE_TIME));
+    Remove(itr);
+
+    if(!holder || expired)
+    {
+        delete holder;
+        if(expired)
+            ++m_statExpired;
+        else
+            ++m_statMisses;
+        return NULL;
+    }
+
+    ++m_statHits;
+    return holder;
+}
+
+void CharacterSnapshotCache::Invalidate(uint32 guidlow)
+{
+    ZThread::Guard<ZThread::FastMutex> guard(m_lock);
+
+    SnapshotMap::iterator itr = m_snapshots.find(guidlow);
+    if(itr == m_snapshots.end())
+        return;
+
+    Remove(itr);
+    ++m_statInvalidated;
+}
+
+void CharacterSnapshotCache::InvalidateAccount(uint32 account)
+{
+    ZThread::Guard<ZThread::FastMutex> guard(m_lock);
+
+    for(SnapshotMap::iterator itr = m_snapshots.begin(); itr != m_snapshots.end();)
+    {
+        if(itr->second.account == account)
+        {
+            Remove(itr++);
+            ++m_statInvalidated;
+        }
+        else
+            ++itr;
+    }
+}
+
+void CharacterSnapshotCache::Clear()
+{
+    ZThread::Guard<ZThread::FastMutex> guard(m_lock);
+
+    for(SnapshotMap::iterator itr = m_snapshots.begin(); itr != m_snapshots.end(); ++itr)
+        delete itr->second.holder;
+
+    m_statInvalidated += m_snapshots.size();
+    m_snapshots.clear();
+    m_lru.clear();
+}
+
+void CharacterSnapshotCache::Remove(SnapshotMap::iterator itr)
+{
+    delete itr->second.holder;
+    m_lru.erase(itr->second.lru);
+    m_snapshots.erase(itr);
+}
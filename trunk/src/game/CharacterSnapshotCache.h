@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_CHARACTERSNAPSHOTCACHE_H
+#define MANGOS_CHARACTERSNAPSHOTCACHE_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "zthread/FastMutex.h"
+
+#include <list>
+
+class SqlQueryHolder;
+
+/// Login query results of recently logged out characters, so a relog shortly after logout
+/// (reconnect after connection lost, character switch) doesn't wait for the character database.
+///
+/// The login queries are queued at logout after all logout saves, so the results are the
+/// state of the character in DB. Every change of an offline character in DB must call
+/// Invalidate (or InvalidateAccount/Clear for changes of many characters), results loaded
+/// for an invalidated request are dropped at arrival. Each snapshot is used only once.
+/// Mail is not cached, the mail login queries are run when the snapshot is used.
+class CharacterSnapshotCache
+{
+    public:
+        CharacterSnapshotCache();
+        ~CharacterSnapshotCache();
+
+        bool IsEnabled() const;
+
+        /// login queries for the character are queued, id must be passed to Store with results
+        uint32 Request(uint32 guidlow, uint32 account);
+        void Store(uint32 guidlow, uint32 requestId, SqlQueryHolder* holder);
+
+        /// results for character login or NULL, caller takes ownership
+        SqlQueryHolder* Take(uint32 guidlow);
+
+        void Invalidate(uint32 guidlow);
+        void InvalidateAccount(uint32 account);             // account wide data (tutorials) changed
+        void Clear();
+
+    private:
+        struct Snapshot
+        {
+            uint32 requestId;
+            uint32 account;
+            SqlQueryHolder* holder;                         // NULL while loading
+            time_t time;                                    // store time
+            std::list<uint32>::iterator lru;
+        };
+        typedef std::map<uint32, Snapshot> SnapshotMap;
+
+        void Remove(SnapshotMap::iterator itr);
+
+        ZThread::FastMutex m_lock;
+        SnapshotMap m_snapshots;
+        std::list<uint32> m_lru;                            // character guids, last stored first
+        uint32 m_nextRequestId;
+
+        // statistics, logged periodically at login
+        time_t m_statTime;
+        uint32 m_statHits;
+        uint32 m_statMisses;
+        uint32 m_statExpired;
+        uint32 m_statInvalidated;
+};
+
+#define sCharacterSnapshotCache MaNGOS::Singleton<CharacterSnapshotCache>::Instance()
+#endif
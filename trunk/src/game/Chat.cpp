@@ -107,6 +107,8 @@ ChatCommand * ChatHandler::getCommandTable()
         { "Mod32Value",     SEC_ADMINISTRATOR,  &ChatHandler::HandleMod32Value,                 "", NULL },
         { "anim",           SEC_GAMEMASTER,     &ChatHandler::HandleAnimCommand,                "", NULL },
         { "lootrecipient",  SEC_GAMEMASTER,     &ChatHandler::HandleGetLootRecipient,           "", NULL },
+        { "netstats",       SEC_ADMINISTRATOR,  &ChatHandler::HandleDebugNetStatsCommand,       "", NULL },
+        { "vmapstats",      SEC_ADMINISTRATOR,  &ChatHandler::HandleDebugVMapStatsCommand,      "", NULL },
         { NULL,             0,                  NULL,                                           "", NULL }
     };
 
@@ -387,6 +387,8 @@ class ChatHandler
         bool HandleSaveAllCommand(const char* args);
         bool HandleGetItemState(const char * args);
         bool HandleGetLootRecipient(const char * args);
+        bool HandleDebugNetStatsCommand(const char * args);
+        bool HandleDebugVMapStatsCommand(const char * args);
 
         Player*   getSelectedPlayer();
         Creature* getSelectedCreature();
@@ -575,6 +575,7 @@ void GameEvent::ChangeEquipOrModel(int16 event_id, bool activate)
                         pCreature->SetNativeDisplayId(itr->second.modelid);
                         pCreature->SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS,minfo->bounding_radius);
                         pCreature->SetFloatValue(UNIT_FIELD_COMBATREACH,minfo->combat_reach );
+                        pCreature->UpdateSpatialIndex();
                     }
                 }
             }
@@ -590,6 +591,7 @@ void GameEvent::ChangeEquipOrModel(int16 event_id, bool activate)
                         pCreature->SetNativeDisplayId(itr->second.modelid_prev);
                         pCreature->SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS,minfo->bounding_radius);
                         pCreature->SetFloatValue(UNIT_FIELD_COMBATREACH,minfo->combat_reach );
+                        pCreature->UpdateSpatialIndex();
                     }
                 }
             }
@@ -295,10 +295,6 @@ void GameObject::Update(uint32 /*p_time*/)
 
                 bool NeedDespawn = (goInfo->trap.charges != 0);
 
-                CellPair p(MaNGOS::ComputeCellPair(GetPositionX(),GetPositionY()));
-                Cell cell(p);
-                cell.data.Part.reserved = ALL_DISTRICT;
-
                 // Note: this hack with search required until GO casting not implemented
                 // search unfriendly creature
                 if(owner && NeedDespawn)                    // hunter trap
@@ -306,17 +302,8 @@ void GameObject::Update(uint32 /*p_time*/)
                     MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck u_check(this, owner, radius);
                     MaNGOS::UnitSearcher<MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck> checker(ok, u_check);
 
-                    CellLock<GridReadGuard> cell_lock(cell, p);
-
-                    TypeContainerVisitor<MaNGOS::UnitSearcher<MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck>, GridTypeMapContainer > grid_object_checker(checker);
-                    cell_lock->Visit(cell_lock, grid_object_checker, *MapManager::Instance().GetMap(GetMapId(), this));
-
-                    // or unfriendly player/pet
-                    if(!ok)
-                    {
-                        TypeContainerVisitor<MaNGOS::UnitSearcher<MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck>, WorldTypeMapContainer > world_object_checker(checker);
-                        cell_lock->Visit(cell_lock, world_object_checker, *MapManager::Instance().GetMap(GetMapId(), this));
-                    }
+                    // creature or unfriendly player/pet
+                    GetMap()->GetUnitSpatialIndex().Visit(this, radius, checker);
                 }
                 else                                        // environmental trap
                 {
@@ -327,10 +314,7 @@ void GameObject::Update(uint32 /*p_time*/)
                     MaNGOS::AnyPlayerInObjectRangeCheck p_check(this, radius);
                     MaNGOS::PlayerSearcher<MaNGOS::AnyPlayerInObjectRangeCheck>  checker(p_ok, p_check);
 
-                    CellLock<GridReadGuard> cell_lock(cell, p);
-
-                    TypeContainerVisitor<MaNGOS::PlayerSearcher<MaNGOS::AnyPlayerInObjectRangeCheck>, WorldTypeMapContainer > world_object_checker(checker);
-                    cell_lock->Visit(cell_lock, world_object_checker, *MapManager::Instance().GetMap(GetMapId(), this));
+                    GetMap()->GetUnitSpatialIndex().Visit(this, radius, checker, SPATIAL_UNIT_PLAYER);
                     ok = p_ok;
                 }
 
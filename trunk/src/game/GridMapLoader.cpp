@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "GridMapLoader.h"
+#include "Map.h"
+#include "World.h"
+#include "Log.h"
+#include "Timer.h"
+#include "zthread/PoolExecutor.h"
+#include "zthread/Runnable.h"
+#include "zthread/Guard.h"
+
+#include <ace/Mem_Map.h>
+
+#define GRID_MAP_PRELOAD_EXPIRE     60000                   // loaded and not taken mappings are closed after this time
+#define GRID_MAP_STATS_INTERVAL     60000
+#define GRID_MAP_PAGE_SIZE          4096                    // read step for paging in mapped file
+
+// magic *.map header
+const char MAP_MAGIC[] = "MAP_2.00";
+
+class GridMapLoadRequest : public ZThread::Runnable
+{
+    public:
+        GridMapLoadRequest(GridMapLoader& l, uint32 k) : i_loader(l), i_key(k) {}
+
+        void run()
+        {
+            i_loader.Load(i_key);
+        }
+
+    private:
+        GridMapLoader& i_loader;
+        uint32 i_key;
+};
+
+GridMapLoader::GridMapLoader() : i_executor(NULL), i_statTime(0), i_statLoads(0), i_statLoadTimeTotal(0),
+    i_statLoadTimeMax(0), i_statHits(0), i_statLate(0), i_statMisses(0), i_statExpired(0)
+{
+}
+
+GridMapLoader::~GridMapLoader()
+{
+    Deactivate();
+}
+
+void GridMapLoader::Activate()
+{
+    Deactivate();
+
+    i_executor = new ZThread::PoolExecutor(1);
+    i_statTime = getMSTime();
+
+    sLog.outString("Grid map files will be preloaded in background thread");
+}
+
+void GridMapLoader::Deactivate()
+{
+    if(!i_executor)
+        return;
+
+    i_executor->wait();
+    i_executor->cancel();
+    delete i_executor;
+    i_executor = NULL;
+
+    for(PreloadedMap::iterator itr = i_preloaded.begin(); itr != i_preloaded.end(); ++itr)
+        delete itr->second.file;
+    i_preloaded.clear();
+}
+
+void GridMapLoader::Preload(uint32 mapid, int x, int y)
+{
+    if(!i_executor)
+        return;
+
+    uint32 key = MakeKey(mapid, x, y);
+    {
+        ZThread::Guard<ZThread::FastMutex> guard(i_lock);
+        if(i_preloaded.find(key) != i_preloaded.end())
+            return;
+
+        PreloadedGridMap& entry = i_preloaded[key];
+        entry.file = NULL;
+        entry.loaded = false;
+        entry.time = getMSTime();
+    }
+
+    i_executor->execute(ZThread::Task(new GridMapLoadRequest(*this, key)));
+}
+
+ACE_Mem_Map* GridMapLoader::Take(uint32 mapid, int x, int y)
+{
+    if(!i_executor)
+        return NULL;
+
+    ZThread::Guard<ZThread::FastMutex> guard(i_lock);
+
+    PreloadedMap::iterator itr = i_preloaded.find(MakeKey(mapid, x, y));
+    if(itr == i_preloaded.end())
+    {
+        ++i_statMisses;
+        return NULL;
+    }
+
+    // still queued: caller loads it now and the loader thread result is dropped
+    ACE_Mem_Map* file = itr->second.file;
+    if(itr->second.loaded)
+        ++i_statHits;
+    else
+        ++i_statLate;
+
+    i_preloaded.erase(itr);
+    return file;
+}
+
+ACE_Mem_Map* GridMapLoader::OpenMapFile(uint32 mapid, int x, int y)
+{
+    // map file name
+    char *tmp=NULL;
+    // Pihhan: dataPath length + "maps/" + 3+2+2+ ".map" length may be > 32 !
+    int len = sWorld.GetDataPath().length()+strlen("maps/%03u%02u%02u.map")+1;
+    tmp = new char[len];
+    snprintf(tmp, len, (char *)(sWorld.GetDataPath()+"maps/%03u%02u%02u.map").c_str(),mapid,x,y);
+    sLog.outDetail("Loading map %s",tmp);
+
+    // map file read-only to memory: pages are loaded on first access and shared by OS file cache
+    ACE_Mem_Map* file = new ACE_Mem_Map;
+    if(file->map(tmp, static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_SHARED) == -1)
+    {
+        delete file;
+        delete [] tmp;
+        return NULL;
+    }
+
+    if(file->size() < 8 + sizeof(GridMap) || strncmp(MAP_MAGIC,(char const*)file->addr(),8))
+    {
+        sLog.outError("Map file '%s' is non-compatible version (outdated?). Please, create new using ad.exe program.",tmp);
+        delete [] tmp;
+        delete file;                                        //close file before return
+        return NULL;
+    }
+    delete []  tmp;
+
+    return file;
+}
+
+void GridMapLoader::Load(uint32 key)
+{
+    uint32 start = getMSTime();
+
+    ACE_Mem_Map* file = OpenMapFile(key >> 12, (key >> 6) & 0x3F, key & 0x3F);
+
+    // touch each page so the map thread doesn't wait for disk reads at grid load
+    if(file)
+    {
+        char const* data = (char const*)file->addr();
+        volatile char sum = 0;
+        for(size_t i = 0; i < file->size(); i += GRID_MAP_PAGE_SIZE)
+            sum ^= data[i];
+    }
+
+    uint32 now = getMSTime();
+
+    ZThread::Guard<ZThread::FastMutex> guard(i_lock);
+
+    PreloadedMap::iterator itr = i_preloaded.find(key);
+    if(itr == i_preloaded.end() || itr->second.loaded)
+        delete file;                                        // taken before load or requested again
+    else
+    {
+        itr->second.file = file;
+        itr->second.loaded = true;
+        itr->second.time = now;
+    }
+
+    RemoveExpired(now);
+    UpdateStats(getMSTimeDiff(start, now), now);
+}
+
+void GridMapLoader::Update()
+{
+    if(!i_executor)
+        return;
+
+    ZThread::Guard<ZThread::FastMutex> guard(i_lock);
+    RemoveExpired(getMSTime());
+}
+
+void GridMapLoader::RemoveExpired(uint32 now)
+{
+    for(PreloadedMap::iterator itr = i_preloaded.begin(); itr != i_preloaded.end();)
+    {
+        if(itr->second.loaded && getMSTimeDiff(itr->second.time, now) >= GRID_MAP_PRELOAD_EXPIRE)
+        {
+            delete itr->second.file;
+            i_preloaded.erase(itr++);
+            ++i_statExpired;
+        }
+        else
+            ++itr;
+    }
+}
+
+void GridMapLoader::UpdateStats(uint32 loadTime, uint32 now)
+{
+    ++i_statLoads;
+    i_statLoadTimeTotal += loadTime;
+    if(loadTime > i_statLoadTimeMax)
+        i_statLoadTimeMax = loadTime;
+
+    if(getMSTimeDiff(i_statTime, now) < GRID_MAP_STATS_INTERVAL)
+        return;
+
+    sLog.outDetail("Grid map preload: %u loaded (avg %u ms max %u ms), %u used, %u used late, %u not preloaded, %u expired, %u kept",
+        i_statLoads, i_statLoadTimeTotal / i_statLoads, i_statLoadTimeMax, i_statHits, i_statLate, i_statMisses, i_statExpired, (uint32)i_preloaded.size());
+
+    i_statTime = now;
+    i_statLoads = 0;
+    i_statLoadTimeTotal = 0;
+    i_statLoadTimeMax = 0;
+    i_statHits = 0;
+    i_statLate = 0;
+    i_statMisses = 0;
+    i_statExpired = 0;
+}
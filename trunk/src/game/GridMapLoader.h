@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_GRIDMAPLOADER_H
+#define MANGOS_GRIDMAPLOADER_H
+
+#include "Platform/Define.h"
+#include "zthread/FastMutex.h"
+
+#include <map>
+
+namespace ZThread
+{
+    class PoolExecutor;
+}
+
+class ACE_Mem_Map;
+
+extern const char MAP_MAGIC[];
+
+/// Opens grid terrain (.map) files ahead of grid creation in a background thread.
+/// Map threads request grids expected to be entered soon, the file is mapped and its pages
+/// read in by the loader thread, and Map::LoadMap only takes the prepared mapping.
+class MANGOS_DLL_DECL GridMapLoader
+{
+    public:
+        GridMapLoader();
+        ~GridMapLoader();
+
+        void Activate();
+        void Deactivate();
+        bool IsActivated() const { return i_executor != NULL; }
+
+        /// queue loading of grid map file (x and y as in map file name), ignored if already queued
+        void Preload(uint32 mapid, int x, int y);
+
+        /// mapping prepared for the grid or NULL if not preloaded, caller takes ownership
+        ACE_Mem_Map* Take(uint32 mapid, int x, int y);
+
+        /// map and check the grid map file, NULL if it not exist or is incompatible
+        static ACE_Mem_Map* OpenMapFile(uint32 mapid, int x, int y);
+
+        /// run by loader thread
+        void Load(uint32 key);
+
+        /// close preloaded mappings not taken in time, called at map update tick
+        void Update();
+
+    private:
+        GridMapLoader(const GridMapLoader&);
+        GridMapLoader& operator=(const GridMapLoader&);
+
+        static uint32 MakeKey(uint32 mapid, int x, int y) { return mapid << 12 | uint32(x) << 6 | uint32(y); }
+
+        void RemoveExpired(uint32 now);
+        void UpdateStats(uint32 loadTime, uint32 now);
+
+        struct PreloadedGridMap
+        {
+            ACE_Mem_Map* file;
+            bool loaded;
+            uint32 time;                                    // request time, load time after loaded
+        };
+        typedef std::map<uint32, PreloadedGridMap> PreloadedMap;
+
+        ZThread::PoolExecutor* i_executor;
+        ZThread::FastMutex i_lock;
+        PreloadedMap i_preloaded;
+
+        // statistics, logged periodically by loader thread
+        uint32 i_statTime;
+        uint32 i_statLoads;
+        uint32 i_statLoadTimeTotal;
+        uint32 i_statLoadTimeMax;
+        uint32 i_statHits;                                  // taken loaded
+        uint32 i_statLate;                                  // taken while still in queue
+        uint32 i_statMisses;                                // not preloaded
+        uint32 i_statExpired;                               // loaded but not used
+};
+#endif
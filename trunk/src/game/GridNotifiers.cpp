@@ -116,8 +116,8 @@ VisibleNotifier::Notify()
         i_player.GetSession()->SendPacket(&packet);
 
         // send out of range to other players if need
-        std::set<uint64> const& oor = i_data.GetOutOfRangeGUIDs();
-        for(std::set<uint64>::const_iterator iter = oor.begin(); iter != oor.end(); ++iter)
+        GuidSet const& oor = i_data.GetOutOfRangeGUIDs();
+        for(GuidSet::const_iterator iter = oor.begin(); iter != oor.end(); ++iter)
         {
             if(!IS_PLAYER_GUID(*iter))
                 continue;
@@ -145,7 +145,7 @@ MessageDeliverer::Visit(PlayerMapType &m)
         if( i_toSelf || iter->getSource() != &i_player)
         {
             if(WorldSession* session = iter->getSource()->GetSession())
-                session->SendPacket(i_message);
+                session->SendPacket(&i_message);
         }
     }
 }
@@ -156,7 +156,7 @@ ObjectMessageDeliverer::Visit(PlayerMapType &m)
     for(PlayerMapType::iterator iter=m.begin(); iter != m.end(); ++iter)
     {
         if(WorldSession* session = iter->getSource()->GetSession())
-            session->SendPacket(i_message);
+            session->SendPacket(&i_message);
     }
 }
 
@@ -170,7 +170,7 @@ MessageDistDeliverer::Visit(PlayerMapType &m)
             (!i_dist || iter->getSource()->GetDistance(&i_player) <= i_dist) )
         {
             if(WorldSession* session = iter->getSource()->GetSession())
-                session->SendPacket(i_message);
+                session->SendPacket(&i_message);
         }
     }
 }
@@ -183,7 +183,7 @@ ObjectMessageDistDeliverer::Visit(PlayerMapType &m)
         if( !i_dist || iter->getSource()->GetDistance(&i_object) <= i_dist )
         {
             if(WorldSession* session = iter->getSource()->GetSession())
-                session->SendPacket(i_message);
+                session->SendPacket(&i_message);
         }
     }
 }
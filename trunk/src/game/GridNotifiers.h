@@ -22,6 +22,7 @@
 #include "ObjectGridLoader.h"
 #include "ByteBuffer.h"
 #include "UpdateData.h"
+#include "SharedWorldPacket.h"
 #include <iostream>
 
 #include "Corpse.h"
@@ -90,7 +91,7 @@ namespace MaNGOS
     struct MANGOS_DLL_DECL MessageDeliverer
     {
         Player &i_player;
-        WorldPacket *i_message;
+        SharedWorldPacket i_message;
         bool i_toSelf;
         MessageDeliverer(Player &pl, WorldPacket *msg, bool to_self) : i_player(pl), i_message(msg), i_toSelf(to_self) {}
         void Visit(PlayerMapType &m);
@@ -99,7 +100,7 @@ namespace MaNGOS
 
     struct MANGOS_DLL_DECL ObjectMessageDeliverer
     {
-        WorldPacket *i_message;
+        SharedWorldPacket i_message;
         explicit ObjectMessageDeliverer(WorldPacket *msg) : i_message(msg) {}
         void Visit(PlayerMapType &m);
         template<class SKIP> void Visit(GridRefManager<SKIP> &) {}
@@ -108,7 +109,7 @@ namespace MaNGOS
     struct MANGOS_DLL_DECL MessageDistDeliverer
     {
         Player &i_player;
-        WorldPacket *i_message;
+        SharedWorldPacket i_message;
         bool i_toSelf;
         bool i_ownTeamOnly;
         float i_dist;
@@ -120,7 +121,7 @@ namespace MaNGOS
     struct MANGOS_DLL_DECL ObjectMessageDistDeliverer
     {
         WorldObject &i_object;
-        WorldPacket *i_message;
+        SharedWorldPacket i_message;
         float i_dist;
         ObjectMessageDistDeliverer(WorldObject &obj, WorldPacket *msg, float dist) : i_object(obj), i_message(msg), i_dist(dist) {}
         void Visit(PlayerMapType &m);
@@ -173,6 +174,19 @@ namespace MaNGOS
         void Visit(CreatureMapType &);
     };
 
+    // player move notifies collected by Map for one visit per moved player: visibility changes (as VisibleNotifier),
+    // trade distance check and near creatures AI reactions (called after visibility data sent)
+    struct MANGOS_DLL_DECL PlayerMoveNotifier : public VisibleNotifier
+    {
+        std::vector<Creature*> i_creatures;
+
+        explicit PlayerMoveNotifier(Player &player) : VisibleNotifier(player) {}
+        template<class T> void Visit(GridRefManager<T> &m) { VisibleNotifier::Visit(m); }
+        void Visit(PlayerMapType &);
+        void Visit(CreatureMapType &);
+        void Notify(void);
+    };
+
     struct MANGOS_DLL_DECL CreatureRelocationNotifier
     {
         Creature &i_creature;
@@ -201,6 +215,7 @@ namespace MaNGOS
         template<> inline void Visit<Creature>(CreatureMapType &);
         #endif
 
+        void Visit(Unit* target) { VisitHelper(target); }   // UnitSpatialIndex::Visit
         void VisitHelper(Unit* target);
     };
 
@@ -337,6 +352,8 @@ namespace MaNGOS
         void Visit(CreatureMapType &m);
         void Visit(PlayerMapType &m);
 
+        void Visit(Unit* u);                                // UnitSpatialIndex::Visit
+
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED> &) {}
     };
 
@@ -352,6 +369,8 @@ namespace MaNGOS
         void Visit(CreatureMapType &m);
         void Visit(PlayerMapType &m);
 
+        void Visit(Unit* u);                                // UnitSpatialIndex::Visit
+
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED> &) {}
     };
 
@@ -367,6 +386,8 @@ namespace MaNGOS
         void Visit(PlayerMapType &m);
         void Visit(CreatureMapType &m);
 
+        void Visit(Unit* u);                                // UnitSpatialIndex::Visit
+
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED> &) {}
     };
 
@@ -396,6 +417,8 @@ namespace MaNGOS
 
         void Visit(CreatureMapType &m);
 
+        void Visit(Unit* u);                                // UnitSpatialIndex::Visit, players skipped
+
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED> &) {}
     };
 
@@ -409,6 +432,8 @@ namespace MaNGOS
 
         void Visit(CreatureMapType &m);
 
+        void Visit(Unit* u);                                // UnitSpatialIndex::Visit, players skipped
+
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED> &) {}
     };
 
@@ -424,6 +449,8 @@ namespace MaNGOS
 
         void Visit(PlayerMapType &m);
 
+        void Visit(Unit* u);                                // UnitSpatialIndex::Visit, creatures skipped
+
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED> &) {}
     };
 
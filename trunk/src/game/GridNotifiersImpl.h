@@ -64,11 +64,8 @@ MaNGOS::PlayerRelocationNotifier::Visit(PlayerMapType &m)
     }
 }
 
-inline void PlayerCreatureRelocationWorker(Player* pl, Creature* c)
+inline void PlayerCreatureReactionWorker(Player* pl, Creature* c)
 {
-    // update creature visibility at player/creature move
-    pl->UpdateVisibilityOf(c);
-
     // Creature AI reaction
     if(!c->hasUnitState(UNIT_STAT_CHASE | UNIT_STAT_SEARCHING | UNIT_STAT_FLEEING))
     {
@@ -77,6 +74,14 @@ inline void PlayerCreatureRelocationWorker(Player* pl, Creature* c)
     }
 }
 
+inline void PlayerCreatureRelocationWorker(Player* pl, Creature* c)
+{
+    // update creature visibility at player/creature move
+    pl->UpdateVisibilityOf(c);
+
+    PlayerCreatureReactionWorker(pl, c);
+}
+
 inline void CreatureCreatureRelocationWorker(Creature* c1, Creature* c2)
 {
     if(!c1->hasUnitState(UNIT_STAT_CHASE | UNIT_STAT_SEARCHING | UNIT_STAT_FLEEING))
@@ -103,6 +108,41 @@ MaNGOS::PlayerRelocationNotifier::Visit(CreatureMapType &m)
             PlayerCreatureRelocationWorker(&i_player,iter->getSource());
 }
 
+inline void
+MaNGOS::PlayerMoveNotifier::Visit(PlayerMapType &m)
+{
+    VisibleNotifier::Visit(m);
+
+    // Cancel Trade
+    if(Player* trader = i_player.GetTrader())
+        for(PlayerMapType::iterator iter=m.begin(); iter != m.end(); ++iter)
+            if(iter->getSource() == trader && !i_player.IsWithinDistInMap(trader, 5))
+                i_player.GetSession()->SendCancelTrade();   // will clode both side trade windows
+}
+
+inline void
+MaNGOS::PlayerMoveNotifier::Visit(CreatureMapType &m)
+{
+    VisibleNotifier::Visit(m);
+
+    if(!i_player.isAlive() || i_player.isInFlight())
+        return;
+
+    for(CreatureMapType::iterator iter=m.begin(); iter != m.end(); ++iter)
+        if( iter->getSource()->isAlive())
+            i_creatures.push_back(iter->getSource());
+}
+
+inline void
+MaNGOS::PlayerMoveNotifier::Notify()
+{
+    // creatures must be known by client before possible attack at reaction
+    VisibleNotifier::Notify();
+
+    for(std::vector<Creature*>::const_iterator itr = i_creatures.begin(); itr != i_creatures.end(); ++itr)
+        PlayerCreatureReactionWorker(&i_player, *itr);
+}
+
 template<>
 inline void
 MaNGOS::CreatureRelocationNotifier::Visit(PlayerMapType &m)
@@ -396,6 +436,13 @@ void MaNGOS::UnitSearcher<Check>::Visit(PlayerMapType &m)
     }
 }
 
+template<class Check>
+void MaNGOS::UnitSearcher<Check>::Visit(Unit* u)
+{
+    if(!i_object && i_check(u))
+        i_object = u;
+}
+
 template<class Check>
 void MaNGOS::UnitLastSearcher<Check>::Visit(CreatureMapType &m)
 {
@@ -416,6 +463,13 @@ void MaNGOS::UnitLastSearcher<Check>::Visit(PlayerMapType &m)
     }
 }
 
+template<class Check>
+void MaNGOS::UnitLastSearcher<Check>::Visit(Unit* u)
+{
+    if(i_check(u))
+        i_object = u;
+}
+
 template<class Check>
 void MaNGOS::UnitListSearcher<Check>::Visit(PlayerMapType &m)
 {
@@ -432,6 +486,13 @@ void MaNGOS::UnitListSearcher<Check>::Visit(CreatureMapType &m)
             i_objects.push_back(itr->getSource());
 }
 
+template<class Check>
+void MaNGOS::UnitListSearcher<Check>::Visit(Unit* u)
+{
+    if(i_check(u))
+        i_objects.push_back(u);
+}
+
 // Creature searchers
 
 template<class Check>
@@ -461,6 +522,13 @@ void MaNGOS::CreatureLastSearcher<Check>::Visit(CreatureMapType &m)
     }
 }
 
+template<class Check>
+void MaNGOS::CreatureLastSearcher<Check>::Visit(Unit* u)
+{
+    if(u->GetTypeId() == TYPEID_UNIT && i_check((Creature*)u))
+        i_object = (Creature*)u;
+}
+
 template<class Check>
 void MaNGOS::CreatureListSearcher<Check>::Visit(CreatureMapType &m)
 {
@@ -469,6 +537,13 @@ void MaNGOS::CreatureListSearcher<Check>::Visit(CreatureMapType &m)
             i_objects.push_back(itr->getSource());
 }
 
+template<class Check>
+void MaNGOS::CreatureListSearcher<Check>::Visit(Unit* u)
+{
+    if(u->GetTypeId() == TYPEID_UNIT && i_check((Creature*)u))
+        i_objects.push_back((Creature*)u);
+}
+
 template<class Check>
 void MaNGOS::PlayerSearcher<Check>::Visit(PlayerMapType &m)
 {
@@ -486,4 +561,11 @@ void MaNGOS::PlayerSearcher<Check>::Visit(PlayerMapType &m)
     }
 }
 
+template<class Check>
+void MaNGOS::PlayerSearcher<Check>::Visit(Unit* u)
+{
+    if(!i_object && u->GetTypeId() == TYPEID_PLAYER && i_check((Player*)u))
+        i_object = (Player*)u;
+}
+
 #endif                                                      // MANGOS_GRIDNOTIFIERSIMPL_H
@@ -29,6 +29,7 @@
 #include "MapManager.h"
 #include "InstanceSaveMgr.h"
 #include "MapInstanced.h"
+#include "CharacterSnapshotCache.h"
 #include "Util.h"
 
 Group::Group()
@@ -318,6 +319,9 @@ void Group::Disband(bool hideDestroy)
 
     for(member_citerator citr = m_memberSlots.begin(); citr != m_memberSlots.end(); ++citr)
     {
+        // group membership of offline members is deleted in DB below
+        sCharacterSnapshotCache.Invalidate(GUID_LOPART(citr->guid));
+
         player = objmgr.GetPlayer(citr->guid);
         if(!player)
             continue;
@@ -992,7 +996,10 @@ bool Group::_removeMember(const uint64 &guid)
         m_memberSlots.erase(slot);
 
     if(!isBGGroup())
+    {
         CharacterDatabase.PExecute("DELETE FROM group_member WHERE memberGuid='%u'", GUID_LOPART(guid));
+        sCharacterSnapshotCache.Invalidate(GUID_LOPART(guid));
+    }
 
     if(m_leaderGuid == guid)                                // leader was removed
     {
@@ -1056,6 +1063,9 @@ void Group::_setLeader(const uint64 &guid)
         CharacterDatabase.PExecute("UPDATE groups SET leaderGuid='%u' WHERE leaderGuid='%u'", GUID_LOPART(slot->guid), GUID_LOPART(m_leaderGuid));
         CharacterDatabase.PExecute("UPDATE group_member SET leaderGuid='%u' WHERE leaderGuid='%u'", GUID_LOPART(slot->guid), GUID_LOPART(m_leaderGuid));
         CharacterDatabase.CommitTransaction();
+
+        for(member_citerator citr = m_memberSlots.begin(); citr != m_memberSlots.end(); ++citr)
+            sCharacterSnapshotCache.Invalidate(GUID_LOPART(citr->guid));
     }
 
     m_leaderGuid = slot->guid;
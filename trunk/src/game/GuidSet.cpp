@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "GuidSet.h"
+
+#include <algorithm>
+
+#define GUIDSET_MIN_BITS 4                                  // 16 slots
+
+bool GuidSet::insert(uint64 guid)
+{
+    if(!guid)
+        return false;
+
+    // keep at least half of slots empty for short probe sequences
+    if((m_size + 1) * 2 > m_slots.size())
+        Rehash(m_bits ? m_bits + 1 : GUIDSET_MIN_BITS);
+
+    size_t mask = m_slots.size() - 1;
+    size_t i = HomeSlot(guid);
+    for(; m_slots[i]; i = (i + 1) & mask)
+        if(m_slots[i] == guid)
+            return false;
+
+    m_slots[i] = guid;
+    ++m_size;
+    return true;
+}
+
+size_t GuidSet::erase(uint64 guid)
+{
+    if(!guid || m_slots.empty())
+        return 0;
+
+    size_t mask = m_slots.size() - 1;
+    size_t i = HomeSlot(guid);
+    for(; m_slots[i] != guid; i = (i + 1) & mask)
+        if(!m_slots[i])
+            return 0;
+
+    // move back following guids of probe sequence to keep it without holes
+    for(size_t j = (i + 1) & mask; m_slots[j]; j = (j + 1) & mask)
+    {
+        size_t home = HomeSlot(m_slots[j]);
+
+        // guid at j can fill hole at i only if its home slot is not cyclically in (i,j]
+        bool between = i < j ? (home > i && home <= j) : (home > i || home <= j);
+        if(between)
+            continue;
+
+        m_slots[i] = m_slots[j];
+        i = j;
+    }
+
+    m_slots[i] = 0;
+    --m_size;
+    return 1;
+}
+
+void GuidSet::clear()
+{
+    if(!m_size)
+        return;
+
+    std::fill(m_slots.begin(), m_slots.end(), 0);
+    m_size = 0;
+}
+
+void GuidSet::Rehash(uint32 bits)
+{
+    std::vector<uint64> old;
+    old.swap(m_slots);
+
+    m_bits = bits;
+    m_slots.resize(size_t(1) << bits, 0);
+    m_size = 0;
+
+    for(std::vector<uint64>::const_iterator itr = old.begin(); itr != old.end(); ++itr)
+        if(*itr)
+            insert(*itr);
+}
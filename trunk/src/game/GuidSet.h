@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_GUIDSET_H
+#define MANGOS_GUIDSET_H
+
+#include "Common.h"
+
+/// Set of object guids (guid 0 can't be stored) as open addressing hash table with linear probing.
+/// Used for often checked sets like objects at player client: lookup is a few reads in one array
+/// and inserts not allocate memory until table grow. Iteration order is not defined.
+class GuidSet
+{
+    public:
+        class const_iterator
+        {
+            public:
+                const_iterator() : m_slot(NULL), m_end(NULL) {}
+                const_iterator(uint64 const* slot, uint64 const* end) : m_slot(slot), m_end(end) { SkipEmpty(); }
+
+                uint64 const& operator*() const { return *m_slot; }
+                const_iterator& operator++() { ++m_slot; SkipEmpty(); return *this; }
+                const_iterator operator++(int) { const_iterator tmp = *this; ++(*this); return tmp; }
+                bool operator==(const_iterator const& r) const { return m_slot == r.m_slot; }
+                bool operator!=(const_iterator const& r) const { return m_slot != r.m_slot; }
+
+            private:
+                void SkipEmpty() { while(m_slot != m_end && !*m_slot) ++m_slot; }
+
+                uint64 const* m_slot;
+                uint64 const* m_end;
+        };
+        typedef const_iterator iterator;
+
+        GuidSet() : m_size(0), m_bits(0) {}
+
+        bool empty() const { return m_size == 0; }
+        size_t size() const { return m_size; }
+
+        const_iterator begin() const { return m_slots.empty() ? end() : const_iterator(&m_slots[0], &m_slots[0] + m_slots.size()); }
+        const_iterator end() const { return m_slots.empty() ? const_iterator() : const_iterator(&m_slots[0] + m_slots.size(), &m_slots[0] + m_slots.size()); }
+
+        const_iterator find(uint64 guid) const
+        {
+            if(!guid || m_slots.empty())
+                return end();
+
+            size_t mask = m_slots.size() - 1;
+            for(size_t i = HomeSlot(guid); m_slots[i]; i = (i + 1) & mask)
+                if(m_slots[i] == guid)
+                    return const_iterator(&m_slots[i], &m_slots[0] + m_slots.size());
+
+            return end();
+        }
+
+        size_t count(uint64 guid) const { return find(guid) != end() ? 1 : 0; }
+
+        /// false if guid already in set
+        bool insert(uint64 guid);
+        template<class Iter>
+            void insert(Iter first, Iter last) { for(; first != last; ++first) insert(*first); }
+
+        /// count of erased guids (0 or 1)
+        size_t erase(uint64 guid);
+
+        void clear();
+
+    private:
+        size_t HomeSlot(uint64 guid) const
+        {
+            // low guids are sequential and high guid is object type, so mix both and use the top bits of product
+            uint32 hash = (uint32(guid) ^ uint32(guid >> 32)) * 2654435761U;
+            return hash >> (32 - m_bits);
+        }
+
+        void Rehash(uint32 bits);
+
+        std::vector<uint64> m_slots;                        // size is 2^m_bits, 0 for empty slot
+        size_t m_size;
+        uint32 m_bits;
+};
+#endif
@@ -40,6 +40,7 @@
 #include "Group.h"
 #include "InstanceData.h"
 #include "ProgressBar.h"
+#include "CharacterSnapshotCache.h"
 
 INSTANTIATE_SINGLETON_1( InstanceSaveManager );
 
@@ -123,6 +124,7 @@ void InstanceSaveManager::DeleteInstanceFromDB(uint32 instanceid)
     CharacterDatabase.PExecute("DELETE FROM character_instance WHERE instance = '%u'", instanceid);
     CharacterDatabase.PExecute("DELETE FROM group_instance WHERE instance = '%u'", instanceid);
     CharacterDatabase.CommitTransaction();
+    sCharacterSnapshotCache.Clear();                        // binds of offline characters aren't known here
     // respawn times should be deleted only when the map gets unloaded
 }
 
@@ -133,7 +135,10 @@ void InstanceSaveManager::RemoveInstanceSave(uint32 InstanceId)
     {
         // save the resettime for normal instances only when they get unloaded
         if(time_t resettime = itr->second->GetResetTimeForDB())
+        {
             CharacterDatabase.PExecute("UPDATE instance SET resettime = '"I64FMTD"' WHERE id = '%u'", (uint64)resettime, InstanceId);
+            sCharacterSnapshotCache.Clear();
+        }
         delete itr->second;
         m_instanceSaveById.erase(itr);
     }
@@ -610,6 +615,7 @@ void InstanceSaveManager::_ResetOrWarnAll(uint32 mapid, bool warn, uint32 timeLe
         CharacterDatabase.PExecute("DELETE FROM group_instance USING group_instance LEFT JOIN instance ON group_instance.instance = id WHERE map = '%u'", mapid);
         CharacterDatabase.PExecute("DELETE FROM instance WHERE map = '%u'", mapid);
         CharacterDatabase.CommitTransaction();
+        sCharacterSnapshotCache.Clear();
 
         // calculate the next reset time
         uint32 diff = sWorld.getConfig(CONFIG_INSTANCE_RESET_TIME_HOUR) * HOUR;
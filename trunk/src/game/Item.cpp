@@ -22,6 +22,7 @@
 #include "WorldPacket.h"
 #include "Database/DatabaseEnv.h"
 #include "ItemEnchantmentMgr.h"
+#include "UpdateFieldsStorage.h"
 
 void AddItemsSetItem(Player*player,Item *item)
 {
@@ -292,23 +293,24 @@ void Item::SaveToDB()
     {
         case ITEM_NEW:
         {
-            CharacterDatabase.PExecute( "DELETE FROM item_instance WHERE guid = '%u'", guid );
-            std::ostringstream ss;
-            ss << "INSERT INTO item_instance (guid,owner_guid,data) VALUES (" << guid << "," << GUID_LOPART(GetOwnerGUID()) << ",'";
-            for(uint16 i = 0; i < m_valuesCount; i++ )
-                ss << GetUInt32Value(i) << " ";
-            ss << "' )";
-            CharacterDatabase.Execute( ss.str().c_str() );
+            static SqlStatementID delItem;
+            static SqlStatementID insItem;
+
+            CharacterDatabase.PreparedExecute(delItem, "DELETE FROM item_instance WHERE guid = ?", SqlStmtParameters() << guid);
+
+            SqlStmtParameters params;
+            params << guid << GUID_LOPART(GetOwnerGUID());
+            UpdateFieldsStorage::Write(params, m_uint32Values, m_valuesCount);
+            CharacterDatabase.PreparedExecute(insItem, "INSERT INTO item_instance (guid,owner_guid,data) VALUES (?, ?, ?)", params);
         } break;
         case ITEM_CHANGED:
         {
-            std::ostringstream ss;
-            ss << "UPDATE item_instance SET data = '";
-            for(uint16 i = 0; i < m_valuesCount; i++ )
-                ss << GetUInt32Value(i) << " ";
-            ss << "', owner_guid = '" << GUID_LOPART(GetOwnerGUID()) << "' WHERE guid = '" << guid << "'";
+            static SqlStatementID updItem;
 
-            CharacterDatabase.Execute( ss.str().c_str() );
+            SqlStmtParameters params;
+            UpdateFieldsStorage::Write(params, m_uint32Values, m_valuesCount);
+            params << GUID_LOPART(GetOwnerGUID()) << guid;
+            CharacterDatabase.PreparedExecute(updItem, "UPDATE item_instance SET data = ?, owner_guid = ? WHERE guid = ?", params);
 
             if(HasFlag(ITEM_FIELD_FLAGS, ITEM_FLAGS_WRAPPED))
                 CharacterDatabase.PExecute("UPDATE character_gifts SET guid = '%u' WHERE item_guid = '%u'", GUID_LOPART(GetOwnerGUID()),GetGUIDLow());
@@ -350,7 +352,7 @@ bool Item::LoadFromDB(uint32 guid, uint64 owner_guid, QueryResult *result)
 
     Field *fields = result->Fetch();
 
-    if(!LoadValues(fields[0].GetString()))
+    if(!LoadValues(fields[0]))
     {
         sLog.outError("ERROR: Item #%d have broken data in `data` field. Can't be loaded.",guid);
         if (delete_result) delete result;
@@ -404,10 +406,9 @@ bool Item::LoadFromDB(uint32 guid, uint64 owner_guid, QueryResult *result)
     if(need_save)                                           // normal item changed state set not work at loading
     {
         std::ostringstream ss;
-        ss << "UPDATE item_instance SET data = '";
-        for(uint16 i = 0; i < m_valuesCount; i++ )
-            ss << GetUInt32Value(i) << " ";
-        ss << "', owner_guid = '" << GUID_LOPART(GetOwnerGUID()) << "' WHERE guid = '" << guid << "'";
+        ss << "UPDATE item_instance SET data = ";
+        UpdateFieldsStorage::Write(ss, m_uint32Values, m_valuesCount);
+        ss << ", owner_guid = '" << GUID_LOPART(GetOwnerGUID()) << "' WHERE guid = '" << guid << "'";
 
         CharacterDatabase.Execute( ss.str().c_str() );
     }
@@ -35,6 +35,7 @@
 #include "SpellMgr.h"
 #include "AccountMgr.h"
 #include "WaypointManager.h"
+#include "CharacterSnapshotCache.h"
 #include "Util.h"
 #include <cctype>
 #include <iostream>
@@ -3411,6 +3412,7 @@ bool ChatHandler::HandleRenameCommand(const char* args)
     {
         PSendSysMessage(LANG_RENAME_PLAYER_GUID, oldname.c_str(), GUID_LOPART(targetGUID));
         CharacterDatabase.PExecute("UPDATE characters SET at_login = at_login | '1' WHERE guid = '%u'", GUID_LOPART(targetGUID));
+        sCharacterSnapshotCache.Invalidate(GUID_LOPART(targetGUID));
     }
 
     return true;
@@ -28,6 +28,7 @@
 #include "Unit.h"
 #include "Language.h"
 #include "Database/DBCStores.h"
+#include "CharacterSnapshotCache.h"
 
 void MailItem::deleteItem( bool inDB )
 {
@@ -820,6 +821,10 @@ void WorldSession::SendMailTo(Player* receiver, uint8 messageType, uint8 station
     else if(mi)
         mi->deleteIncludedItems();
 
+    // unread mail count of offline receiver is changed
+    if(!receiver)
+        sCharacterSnapshotCache.Invalidate(receiver_guidlow);
+
     CharacterDatabase.BeginTransaction();
     CharacterDatabase.escape_string(subject);
     CharacterDatabase.PExecute("INSERT INTO mail (id,messageType,stationery,mailTemplateId,sender,receiver,subject,itemTextId,has_items,expire_time,deliver_time,money,cod,checked) "
@@ -38,11 +38,11 @@
 #include "InstanceSaveMgr.h"
 #include "VMapFactory.h"
 
+#include <ace/Mem_Map.h>
+
 #define DEFAULT_GRID_EXPIRY     300
 #define MAX_GRID_LOAD_TIME      50
-
-// magic *.map header
-const char MAP_MAGIC[] = "MAP_2.00";
+#define MOVE_NOTIFY_STATS_INTERVAL 60000                    // ms between player move notifies stats output
 
 GridState* si_GridStates[MAX_GRID_STATE];
 
@@ -137,7 +137,6 @@ void Map::LoadMap(uint32 mapid, uint32 instanceid, int x,int y)
 //            return;
 
         ((MapInstanced*)(baseMap))->AddGridMapReference(GridPair(x,y));
-        baseMap->SetUnloadFlag(GridPair(63-x,63-y), false);
         GridMaps[x][y] = baseMap->GridMaps[x][y];
         return;
     }
@@ -146,41 +145,27 @@ void Map::LoadMap(uint32 mapid, uint32 instanceid, int x,int y)
     if(GridMaps[x][y])
     {
         sLog.outDetail("Unloading already loaded map %u before reloading.",mapid);
-        delete (GridMaps[x][y]);
-        GridMaps[x][y]=NULL;
+        UnloadGridMap(x,y);
     }
 
-    // map file name
-    char *tmp=NULL;
-    // Pihhan: dataPath length + "maps/" + 3+2+2+ ".map" length may be > 32 !
-    int len = sWorld.GetDataPath().length()+strlen("maps/%03u%02u%02u.map")+1;
-    tmp = new char[len];
-    snprintf(tmp, len, (char *)(sWorld.GetDataPath()+"maps/%03u%02u%02u.map").c_str(),mapid,x,y);
-    sLog.outDetail("Loading map %s",tmp);
-    // loading data
-    FILE *pf=fopen(tmp,"rb");
-    if(!pf)
-    {
-        delete [] tmp;
+    // loaded in background if player was moving to the grid
+    ACE_Mem_Map* file = MapManager::Instance().GetGridMapLoader()->Take(mapid,x,y);
+    if(!file)
+        file = GridMapLoader::OpenMapFile(mapid,x,y);
+    if(!file)
         return;
-    }
 
-    char magic[8];
-    fread(magic,1,8,pf);
-    if(strncmp(MAP_MAGIC,magic,8))
-    {
-        sLog.outError("Map file '%s' is non-compatible version (outdated?). Please, create new using ad.exe program.",tmp);
-        delete [] tmp;
-        fclose(pf);                                         //close file before return
-        return;
-    }
-    delete []  tmp;
-
-    GridMap * buf= new GridMap;
-    fread(buf,1,sizeof(GridMap),pf);
-    fclose(pf);
+    // GridMap starts after 8 bytes magic, so its floats are aligned in page aligned mapping
+    GridMaps[x][y] = (GridMap*)((char const*)file->addr() + 8);
+    GridMapFiles[x][y] = file;
+}
 
-    GridMaps[x][y] = buf;
+void Map::UnloadGridMap(int x, int y)
+{
+    // GridMaps of base map point into its own mapped file, instances use only references
+    delete GridMapFiles[x][y];
+    GridMapFiles[x][y] = NULL;
+    GridMaps[x][y] = NULL;
 }
 
 void Map::LoadMapAndVMap(uint32 mapid, uint32 instanceid, int x,int y)
@@ -208,7 +193,8 @@ void Map::DeleteStateMachine()
 
 Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
   : i_id(id), i_gridExpiry(expiry), i_mapEntry (sMapStore.LookupEntry(id)),
- i_InstanceId(InstanceId), i_spawnMode(SpawnMode), m_unloadTimer(0)
+ i_InstanceId(InstanceId), i_spawnMode(SpawnMode), m_unloadTimer(0),
+ i_moveNotifyMoves(0), i_moveNotifySweeps(0), i_moveNotifyStatsTimer(0)
 {
     for(unsigned int idx=0; idx < MAX_NUMBER_OF_GRIDS; ++idx)
     {
@@ -216,6 +202,7 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
         {
             //z code
             GridMaps[idx][j] =NULL;
+            GridMapFiles[idx][j] = NULL;
             setNGrid(NULL, idx, j);
         }
     }
@@ -315,6 +302,12 @@ void Map::DeleteFromWorld(T* obj)
     delete obj;
 }
 
+template<>
+void Map::AddToUnitIndex(Creature* obj)
+{
+    i_unitIndex.Add(obj);
+}
+
 template<class T>
 void Map::AddNotifier(T* , Cell const& , CellPair const& )
 {
@@ -419,12 +412,14 @@ Map::LoadGrid(const Cell& cell, bool no_unload)
 bool Map::Add(Player *player)
 {
     player->SetInstanceId(this->GetInstanceId());
+    i_Players.push_back(player);
 
     // update player state for other player and visa-versa
     CellPair p = MaNGOS::ComputeCellPair(player->GetPositionX(), player->GetPositionY());
     Cell cell(p);
     EnsureGridLoadedForPlayer(cell, player, true);
     player->AddToWorld();
+    i_unitIndex.Add(player);
 
     SendInitSelf(player);
     SendInitTransports(player);
@@ -433,6 +428,7 @@ bool Map::Add(Player *player)
     UpdateObjectsVisibilityFor(player,cell,p);
 
     AddNotifier(player,cell,p);
+    SetPlayerMoveNotified(player);
     return true;
 }
 
@@ -457,6 +453,7 @@ Map::Add(T *obj)
 
     AddToGrid(obj,grid,cell);
     obj->AddToWorld();
+    AddToUnitIndex(obj);
 
     DEBUG_LOG("Object %u enters grid[%u,%u]", GUID_LOPART(obj->GetGUID()), cell.GridX(), cell.GridY());
 
@@ -560,21 +557,110 @@ bool Map::loaded(const GridPair &p) const
     return ( getNGrid(p.x_coord, p.y_coord) && isGridObjectDataLoaded(p.x_coord, p.y_coord) );
 }
 
+// player from copy of i_Players, not far teleported out of the map meantime
+inline bool Map::IsPlayerStillHere(Player const* plr) const
+{
+    return plr->IsInWorld() && plr->GetMapId() == i_id && plr->GetInstanceId() == i_InstanceId;
+}
+
 void Map::Update(const uint32 &t_diff)
 {
     // Don't unload grids if it's battleground, since we may have manually added GOs,creatures, those doesn't load from DB at grid re-load !
     // This isn't really bother us, since as soon as we have instanced BG-s, the whole map unloads as the BG gets ended
-    if (IsBattleGroundOrArena())
-        return;
+    if (!IsBattleGroundOrArena())
+    {
+        for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end(); )
+        {
+            NGridType *grid = i->getSource();
+            GridInfo *info = i->getSource()->getGridInfoRef();
+            ++i;                                            // The update might delete the map and we need the next map before the iterator gets invalid
+            assert(grid->GetGridState() >= 0 && grid->GetGridState() < MAX_GRID_STATE);
+            si_GridStates[grid->GetGridState()]->Update(*this, *grid, *info, grid->getX(), grid->getY(), t_diff);
+        }
+    }
 
-    for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end(); )
+    // players and creatures updates can far teleport players and remove them from i_Players, so use a copy
+    std::vector<Player*> players(i_Players.begin(), i_Players.end());
+
+    // update players at this map
+    for(std::vector<Player*>::const_iterator itr = players.begin(); itr != players.end(); ++itr)
+    {
+        Player* plr = *itr;
+        if(IsPlayerStillHere(plr))
+            plr->Update(t_diff);
+    }
+
+    // visibility and creature reactions for players moved at this and previous ticks
+    UpdatePlayerMoveNotifies(t_diff);
+
+    // update active cells around players (creatures and pets)
+    resetMarkedCells();
+
+    MaNGOS::ObjectUpdater updater(t_diff);
+    // for creature
+    TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
+    // for pets
+    TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
+
+    for(std::vector<Player*>::const_iterator itr = players.begin(); itr != players.end(); ++itr)
+    {
+        Player* plr = *itr;
+        if(!IsPlayerStillHere(plr))
+            continue;
+
+        CellPair standing_cell(MaNGOS::ComputeCellPair(plr->GetPositionX(), plr->GetPositionY()));
+
+        // Check for correctness of standing_cell, it also avoids problems with update_cell
+        if (standing_cell.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || standing_cell.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
+            continue;
+
+        // the overloaded operators handle range checking
+        // so ther's no need for range checking inside the loop
+        CellPair begin_cell(standing_cell), end_cell(standing_cell);
+        begin_cell << 1; begin_cell -= 1;                   // upper left
+        end_cell >> 1; end_cell += 1;                       // lower right
+
+        for(uint32 x = begin_cell.x_coord; x <= end_cell.x_coord; ++x)
+        {
+            for(uint32 y = begin_cell.y_coord; y <= end_cell.y_coord; ++y)
+            {
+                uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+                if( !isCellMarked(cell_id) )
+                {
+                    markCell(cell_id);
+                    CellPair cell_pair(x,y);
+                    Cell cell(cell_pair);
+                    cell.data.Part.reserved = CENTER_DISTRICT;
+                    cell.SetNoCreate();
+                    CellLock<NullGuard> cell_lock(cell, cell_pair);
+                    cell_lock->Visit(cell_lock, grid_object_update,  *this);
+                    cell_lock->Visit(cell_lock, world_object_update, *this);
+                }
+            }
+        }
+    }
+}
+
+bool Map::PlayersNearGrid(uint32 x, uint32 y) const
+{
+    CellPair cell_min(x*MAX_NUMBER_OF_CELLS, y*MAX_NUMBER_OF_CELLS);
+    CellPair cell_max(cell_min.x_coord + MAX_NUMBER_OF_CELLS, cell_min.y_coord+MAX_NUMBER_OF_CELLS);
+    cell_min << 2;
+    cell_min -= 2;
+    cell_max >> 2;
+    cell_max += 2;
+
+    for(PlayerList::const_iterator itr = i_Players.begin(); itr != i_Players.end(); ++itr)
     {
-        NGridType *grid = i->getSource();
-        GridInfo *info = i->getSource()->getGridInfoRef();
-        ++i;                                                // The update might delete the map and we need the next map before the iterator gets invalid
-        assert(grid->GetGridState() >= 0 && grid->GetGridState() < MAX_GRID_STATE);
-        si_GridStates[grid->GetGridState()]->Update(*this, *grid, *info, grid->getX(), grid->getY(), t_diff);
+        Player* plr = *itr;
+
+        CellPair p = MaNGOS::ComputeCellPair(plr->GetPositionX(), plr->GetPositionY());
+        if( (cell_min.x_coord <= p.x_coord && p.x_coord <= cell_max.x_coord) &&
+            (cell_min.y_coord <= p.y_coord && p.y_coord <= cell_max.y_coord) )
+            return true;
     }
+
+    return false;
 }
 
 void InstanceMap::Update(const uint32& t_diff)
@@ -587,6 +673,8 @@ void InstanceMap::Update(const uint32& t_diff)
 
 void Map::Remove(Player *player, bool remove)
 {
+    i_Players.remove(player);
+
     CellPair p = MaNGOS::ComputeCellPair(player->GetPositionX(), player->GetPositionY());
     if(p.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || p.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
     {
@@ -669,7 +757,7 @@ Map::Remove(T *obj, bool remove)
 }
 
 void
-Map::PlayerRelocation(Player *player, float x, float y, float z, float orientation)
+Map::PlayerRelocation(Player *player, float x, float y, float z, float orientation, bool forceNotify)
 {
     assert(player);
 
@@ -700,10 +788,12 @@ Map::PlayerRelocation(Player *player, float x, float y, float z, float orientati
             EnsureGridLoadedForPlayer(new_cell, player, true);
     }
 
-    // if move then update what player see and who seen
-    UpdatePlayerVisibility(player,new_cell,new_val);
-    UpdateObjectsVisibilityFor(player,new_cell,new_val);
-    PlayerRelocationNotify(player,new_cell,new_val);
+    // what player see and who seen updated at map update, see UpdatePlayerMoveNotifies
+    player->m_moveNotifyPending = true;
+    if(forceNotify)
+        player->m_moveNotifyForced = true;
+    ++i_moveNotifyMoves;
+
     NGridType* newGrid = getNGrid(new_cell.GridX(), new_cell.GridY());
     if( !same_cell && newGrid->GetGridState()!= GRID_STATE_ACTIVE )
     {
@@ -875,7 +965,7 @@ bool Map::UnloadGrid(const uint32 &x, const uint32 &y, bool pForce)
     assert( grid != NULL);
 
     {
-        if(!pForce && ObjectAccessor::Instance().PlayersNearGrid(x, y, i_id, i_InstanceId) )
+        if(!pForce && PlayersNearGrid(x, y) )
             return false;
 
         DEBUG_LOG("Unloading grid[%u,%u] for map %u", x,y, i_id);
@@ -903,7 +993,7 @@ bool Map::UnloadGrid(const uint32 &x, const uint32 &y, bool pForce)
     {
         if (i_InstanceId == 0)
         {
-            if(GridMaps[gx][gy]) delete (GridMaps[gx][gy]);
+            UnloadGridMap(gx,gy);
             // x and y are swaped
             VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(GetId(), gy, gx);
         }
@@ -1208,6 +1298,104 @@ void Map::PlayerRelocationNotify( Player* player, Cell cell, CellPair cellpair )
     cell_lock->Visit(cell_lock, p2world_relocation, *this);
 }
 
+void Map::UpdatePlayerMoveNotifies(uint32 diff)
+{
+    uint32 now = getMSTime();
+    float minDist = float(sWorld.getConfig(CONFIG_RELOCATION_LOWER_LIMIT));
+    uint32 delay = sWorld.getConfig(CONFIG_RELOCATION_NOTIFY_DELAY);
+
+    for(PlayerList::const_iterator itr = i_Players.begin(); itr != i_Players.end(); ++itr)
+    {
+        Player* plr = *itr;
+        if(!plr->m_moveNotifyPending || !plr->IsInWorld())
+            continue;
+
+        // small moves wait for more distance or delay expire
+        if(!plr->m_moveNotifyForced && getMSTimeDiff(plr->m_moveNotifyTime, now) < delay)
+        {
+            float dx = plr->GetPositionX() - plr->m_moveNotifyX;
+            float dy = plr->GetPositionY() - plr->m_moveNotifyY;
+            float dz = plr->GetPositionZ() - plr->m_moveNotifyZ;
+            if(dx*dx + dy*dy + dz*dz < minDist*minDist)
+                continue;
+        }
+
+        // forced notify is done after teleport, position change is not a movement
+        uint32 preloadTime = sWorld.getConfig(CONFIG_GRID_PRELOAD_TIME);
+        if(preloadTime && !plr->m_moveNotifyForced)
+        {
+            // expected position after preloadTime of movement with same speed and direction
+            uint32 moveTime = getMSTimeDiff(plr->m_moveNotifyTime, now);
+            if(moveTime)
+            {
+                float scale = float(preloadTime) / moveTime;
+                PreloadGridMap(plr->GetPositionX() + (plr->GetPositionX() - plr->m_moveNotifyX) * scale,
+                    plr->GetPositionY() + (plr->GetPositionY() - plr->m_moveNotifyY) * scale);
+            }
+        }
+
+        PlayerMoveNotify(plr);
+        SetPlayerMoveNotified(plr);
+        ++i_moveNotifySweeps;
+    }
+
+    i_moveNotifyStatsTimer += diff;
+    if(i_moveNotifyStatsTimer >= MOVE_NOTIFY_STATS_INTERVAL)
+    {
+        // each move before did separate player visibility, objects visibility and relocation notifies visits
+        if(i_moveNotifyMoves)
+            sLog.outDetail("Map %u (instance %u): %u player moves, %u move notifies, %u cells visits saved",
+                i_id, i_InstanceId, i_moveNotifyMoves, i_moveNotifySweeps, 3*i_moveNotifyMoves - i_moveNotifySweeps);
+
+        i_moveNotifyMoves = 0;
+        i_moveNotifySweeps = 0;
+        i_moveNotifyStatsTimer = 0;
+    }
+}
+
+void Map::PreloadGridMap(float x, float y)
+{
+    GridPair p = MaNGOS::ComputeGridPair(x, y);
+    if(p.x_coord >= MAX_NUMBER_OF_GRIDS || p.y_coord >= MAX_NUMBER_OF_GRIDS)
+        return;
+
+    // grid maps are loaded by base map and only referenced by instances
+    int gx = 63 - p.x_coord;
+    int gy = 63 - p.y_coord;
+    Map const* baseMap = i_InstanceId ? MapManager::Instance().GetBaseMap(i_id) : this;
+    if(!baseMap->GridMaps[gx][gy])
+        MapManager::Instance().GetGridMapLoader()->Preload(i_id, gx, gy);
+}
+
+void Map::PlayerMoveNotify(Player* player)
+{
+    CellPair cellpair = MaNGOS::ComputeCellPair(player->GetPositionX(), player->GetPositionY());
+    Cell cell(cellpair);
+    cell.data.Part.reserved = ALL_DISTRICT;
+
+    MaNGOS::PlayerMoveNotifier notifier(*player);
+    TypeContainerVisitor<MaNGOS::PlayerMoveNotifier, WorldTypeMapContainer > world_notifier(notifier);
+    TypeContainerVisitor<MaNGOS::PlayerMoveNotifier, GridTypeMapContainer  > grid_notifier(notifier);
+
+    // grids around player loaded at visit
+    CellLock<GridReadGuard> cell_lock(cell, cellpair);
+    cell_lock->Visit(cell_lock, world_notifier, *this);
+    cell_lock->Visit(cell_lock, grid_notifier,  *this);
+
+    // send data and then do creature reactions
+    notifier.Notify();
+}
+
+void Map::SetPlayerMoveNotified(Player* player)
+{
+    player->m_moveNotifyPending = false;
+    player->m_moveNotifyForced = false;
+    player->m_moveNotifyX = player->GetPositionX();
+    player->m_moveNotifyY = player->GetPositionY();
+    player->m_moveNotifyZ = player->GetPositionZ();
+    player->m_moveNotifyTime = getMSTime();
+}
+
 void Map::CreatureRelocationNotify(Creature *creature, Cell cell, CellPair cellpair)
 {
     CellLock<ReadGuard> cell_lock(cell, cellpair);
@@ -1533,7 +1721,6 @@ bool InstanceMap::Add(Player *player)
         if(i_data) i_data->OnPlayerEnter(player);
         SetResetSchedule(false);
 
-        i_Players.push_back(player);
         player->SendInitWorldStates();
         sLog.outDetail("MAP: Player '%s' entered the instance '%u' of map '%s'", player->GetName(), GetInstanceId(), GetMapName());
         // initialize unload state
@@ -1550,11 +1737,10 @@ bool InstanceMap::Add(Player *player)
 void InstanceMap::Remove(Player *player, bool remove)
 {
     sLog.outDetail("MAP: Removing player '%s' from instance '%u' of map '%s' before relocating to other map", player->GetName(), GetInstanceId(), GetMapName());
-    i_Players.remove(player);
+    Map::Remove(player, remove);                            // removes the player from i_Players, can delete player
     SetResetSchedule(true);
     if(!m_unloadTimer && i_Players.empty())
         m_unloadTimer = m_unloadWhenEmpty ? MIN_UNLOAD_DELAY : std::max(sWorld.getConfig(CONFIG_INSTANCE_UNLOAD_DELAY), (uint32)MIN_UNLOAD_DELAY);
-    Map::Remove(player, remove);
 }
 
 void InstanceMap::CreateInstanceData(bool load)
@@ -1758,7 +1944,6 @@ bool BattleGroundMap::Add(Player * player)
         Guard guard(*this);
         if(!CanEnter(player))
             return false;
-        i_Players.push_back(player);
         // reset instance validity, battleground maps do not homebind
         player->m_InstanceValid = true;
     }
@@ -1768,7 +1953,6 @@ bool BattleGroundMap::Add(Player * player)
 void BattleGroundMap::Remove(Player *player, bool remove)
 {
     sLog.outDetail("MAP: Removing player '%s' from bg '%u' of map '%s' before relocating to other map", player->GetName(), GetInstanceId(), GetMapName());
-    i_Players.remove(player);
     Map::Remove(player, remove);
 }
 
@@ -28,6 +28,7 @@
 #include "GridDefines.h"
 #include "Cell.h"
 #include "Object.h"
+#include "UnitSpatialIndex.h"
 #include "Timer.h"
 #include "SharedDefines.h"
 #include "GameSystem/GridRefManager.h"
@@ -40,6 +41,7 @@ class WorldPacket;
 class InstanceData;
 class Group;
 class InstanceSave;
+class ACE_Mem_Map;
 
 namespace ZThread
 {
@@ -67,6 +69,7 @@ typedef RGuard<GridRWLock, ZThread::Lockable> GridReadGuard;
 typedef WGuard<GridRWLock, ZThread::Lockable> GridWriteGuard;
 typedef MaNGOS::SingleThreaded<GridRWLock>::Lock NullGuard;
 
+// *.map file content after header, used directly from file mapped to memory
 typedef struct
 {
     uint16 area_flag[16][16];
@@ -125,6 +128,8 @@ typedef HM_NAMESPACE::hash_map<Creature*, CreatureMover> CreatureMoveList;
 class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::ObjectLevelLockable<Map, ZThread::Mutex>
 {
     public:
+        typedef std::list<Player *> PlayerList;                 // online players only
+
         Map(uint32 id, time_t, uint32 InstanceId, uint8 SpawnMode);
         virtual ~Map();
 
@@ -143,7 +148,7 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
         void MessageDistBroadcast(Player *, WorldPacket *, float dist, bool to_self, bool own_team_only = false);
         void MessageDistBroadcast(WorldObject *, WorldPacket *, float dist);
 
-        void PlayerRelocation(Player *, float x, float y, float z, float angl);
+        void PlayerRelocation(Player *, float x, float y, float z, float angl, bool forceNotify = false);
         void CreatureRelocation(Creature *creature, float x, float y, float, float);
 
         template<class LOCK_TYPE, class T, class CONTAINER> void Visit(const CellLock<LOCK_TYPE> &cell, TypeContainerVisitor<T, CONTAINER> &visitor);
@@ -232,9 +237,19 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
         void resetMarkedCells() { marked_cells.reset(); }
         bool isCellMarked(uint32 pCellId) { return marked_cells.test(pCellId); }
         void markCell(uint32 pCellId) { marked_cells.set(pCellId); }
+
+        PlayerList const& GetPlayers() const { return i_Players; }
+        bool HavePlayers() const { return !i_Players.empty(); }
+        bool PlayersNearGrid(uint32 x, uint32 y) const;
+
+        // players and creatures of map by position, for area searches
+        UnitSpatialIndex& GetUnitSpatialIndex() { return i_unitIndex; }
+        UnitSpatialIndex const& GetUnitSpatialIndex() const { return i_unitIndex; }
     private:
+        bool IsPlayerStillHere(Player const* plr) const;
         void LoadVMap(int pX, int pY);
         void LoadMap(uint32 mapid, uint32 instanceid, int x,int y);
+        void UnloadGridMap(int x, int y);
 
         void SetTimer(uint32 t) { i_gridExpiry = t < MIN_GRID_DELAY ? MIN_GRID_DELAY : t; }
         //uint64 CalculateGridMask(const uint32 &y) const;
@@ -245,6 +260,10 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
         void SendRemoveTransports( Player * player );
 
         void PlayerRelocationNotify(Player* player, Cell cell, CellPair cellpair);
+        void UpdatePlayerMoveNotifies(uint32 diff);
+        void PlayerMoveNotify(Player* player);
+        void PreloadGridMap(float x, float y);
+        void SetPlayerMoveNotified(Player* player);
         void CreatureRelocationNotify(Creature *creature, Cell newcell, CellPair newval);
 
         bool CreatureCellRelocation(Creature *creature, Cell new_cell);
@@ -280,18 +299,29 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
         uint32 i_InstanceId;
         uint32 m_unloadTimer;
 
+        // only online players that are inside the map currently, objects near them are updated at Map::Update
+        PlayerList i_Players;
+
     private:
         typedef GridReadGuard ReadGuard;
         typedef GridWriteGuard WriteGuard;
 
         NGridType* i_grids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         GridMap *GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        ACE_Mem_Map *GridMapFiles[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS]; // base map only
         std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP*TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
 
         time_t i_gridExpiry;
 
         std::set<WorldObject *> i_objectsToRemove;
 
+        UnitSpatialIndex i_unitIndex;
+
+        // player moves and done move notifies (one cells visit each) since last stats output
+        uint32 i_moveNotifyMoves;
+        uint32 i_moveNotifySweeps;
+        uint32 i_moveNotifyStatsTimer;
+
         // Type specific code for add/remove to/from grid
         template<class T>
             void AddToGrid(T*, NGridType *, Cell const&);
@@ -299,6 +329,9 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
         template<class T>
             void AddNotifier(T*, Cell const&, CellPair const&);
 
+        template<class T>
+            void AddToUnitIndex(T*) {}
+
         template<class T>
             void RemoveFromGrid(T*, NGridType *, Cell const&);
 
@@ -319,8 +352,6 @@ enum InstanceResetMethod
 class MANGOS_DLL_SPEC InstanceMap : public Map
 {
     public:
-        typedef std::list<Player *> PlayerList;                 // online players only
-
         InstanceMap(uint32 id, time_t, uint32 InstanceId, uint8 SpawnMode);
         ~InstanceMap();
         bool Add(Player *);
@@ -331,13 +362,11 @@ class MANGOS_DLL_SPEC InstanceMap : public Map
         std::string GetScript() { return i_script; }
         InstanceData* GetInstanceData() { return i_data; }
         void PermBindAllPlayers(Player *player);
-        PlayerList const& GetPlayers() const { return i_Players;}
         void SendToPlayers(WorldPacket const* data) const;
         time_t GetResetTime();
         void UnloadAll(bool pForce);
         bool CanEnter(Player* player);
         uint32 GetPlayersCountExceptGMs() const;
-        uint32 HavePlayers() const { return !i_Players.empty(); }
         void SendResetWarnings(uint32 timeLeft);
         void SetResetSchedule(bool on);
     private:
@@ -345,16 +374,11 @@ class MANGOS_DLL_SPEC InstanceMap : public Map
         bool m_unloadWhenEmpty;
         InstanceData* i_data;
         std::string i_script;
-        // only online players that are inside the instance currently
-        // TODO ? - use the grid instead to access the players
-        PlayerList i_Players;
 };
 
 class MANGOS_DLL_SPEC BattleGroundMap : public Map
 {
     public:
-        typedef std::list<Player *> PlayerList;                 // online players only
-
         BattleGroundMap(uint32 id, time_t, uint32 InstanceId);
         ~BattleGroundMap();
 
@@ -363,8 +387,6 @@ class MANGOS_DLL_SPEC BattleGroundMap : public Map
         bool CanEnter(Player* player);
         void SetUnload();
         void UnloadAll(bool pForce);
-    private:
-        PlayerList i_Players;
 };
 
 /*inline
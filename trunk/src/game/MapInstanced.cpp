@@ -49,7 +49,7 @@ void MapInstanced::Update(const uint32& t)
         else
         {
             // update only here, because it may schedule some bad things before delete
-            i->second->Update(t);
+            MapManager::Instance().GetMapUpdater()->ScheduleUpdate(*i->second, t);
             ++i;
         }
     }
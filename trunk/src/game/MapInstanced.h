@@ -42,9 +42,16 @@ class MANGOS_DLL_DECL MapInstanced : public Map
         Map* FindMap(uint32 InstanceId) { return _FindMap(InstanceId); }
         void DestroyInstance(uint32 InstanceId);
         void DestroyInstance(InstancedMaps::iterator &itr);
-        void AddGridMapReference(const GridPair &p) { ++GridMapReference[p.x_coord][p.y_coord]; }
+        // instances of the map are updated in parallel and share its grid maps
+        void AddGridMapReference(const GridPair &p)
+        {
+            Guard guard(*this);
+            ++GridMapReference[p.x_coord][p.y_coord];
+            SetUnloadFlag(GridPair(63-p.x_coord,63-p.y_coord), false);
+        }
         void RemoveGridMapReference(const GridPair &p)
         {
+            Guard guard(*this);
             --GridMapReference[p.x_coord][p.y_coord];
             if (!GridMapReference[p.x_coord][p.y_coord]) { SetUnloadFlag(GridPair(63-p.x_coord,63-p.y_coord), true); }
         }
@@ -37,13 +37,19 @@ INSTANTIATE_CLASS_MUTEX(MapManager, ZThread::Mutex);
 
 extern GridState* si_GridStates[];                          // debugging code, should be deleted some day
 
-MapManager::MapManager() : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_INTERVAL_GRIDCLEAN))
+#define MAP_UPDATE_STATS_TICKS 600                          // ~1 minute with default MapUpdateInterval
+
+MapManager::MapManager() : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_INTERVAL_GRIDCLEAN)),
+    i_updateTicks(0), i_updateTimeTotal(0), i_updateTimeMax(0)
 {
     i_timer.SetInterval(sWorld.getConfig(CONFIG_INTERVAL_MAPUPDATE));
 }
 
 MapManager::~MapManager()
 {
+    i_updater.Deactivate();
+    i_gridMapLoader.Deactivate();
+
     for(MapMapType::iterator iter=i_maps.begin(); iter != i_maps.end(); ++iter)
         delete iter->second;
 
@@ -68,6 +74,11 @@ MapManager::Initialize()
     }
 
     InitMaxInstanceId();
+
+    i_updater.Activate(sWorld.getConfig(CONFIG_NUMTHREADS));
+
+    if(sWorld.getConfig(CONFIG_GRID_PRELOAD_TIME))
+        i_gridMapLoader.Activate();
 }
 
 // debugging code, should be deleted some day
@@ -244,13 +255,39 @@ MapManager::Update(time_t diff)
     if( !i_timer.Passed() )
         return;
 
+    uint32 updateStartTime = getMSTime();
+
     for(MapMapType::iterator iter=i_maps.begin(); iter != i_maps.end(); ++iter)
     {
         checkAndCorrectGridStatesArray();                   // debugging code, should be deleted some day
-        iter->second->Update(i_timer.GetCurrent());
+
+        // instanced base map schedules its instances itself and may destroy unused ones, so it stays at this thread
+        if(iter->second->Instanceable())
+            iter->second->Update(i_timer.GetCurrent());
+        else
+            i_updater.ScheduleUpdate(*iter->second, i_timer.GetCurrent());
+    }
+
+    // all maps must be updated before objects are relocated/removed and update data sent
+    i_updater.Wait();
+
+    uint32 updateTime = getMSTimeDiff(updateStartTime, getMSTime());
+    ++i_updateTicks;
+    i_updateTimeTotal += updateTime;
+    if(updateTime > i_updateTimeMax)
+        i_updateTimeMax = updateTime;
+
+    if(i_updateTicks >= MAP_UPDATE_STATS_TICKS)
+    {
+        sLog.outDetail("MapManager: %u map update ticks with %u worker threads, avg %u ms, max %u ms",
+            i_updateTicks, i_updater.GetThreadCount(), i_updateTimeTotal / i_updateTicks, i_updateTimeMax);
+        i_updateTicks = 0;
+        i_updateTimeTotal = 0;
+        i_updateTimeMax = 0;
     }
 
     ObjectAccessor::Instance().Update(i_timer.GetCurrent());
+    i_gridMapLoader.Update();
     for (TransportSet::iterator iter = m_Transports.begin(); iter != m_Transports.end(); ++iter)
         (*iter)->Update(i_timer.GetCurrent());
 
@@ -288,6 +325,9 @@ void MapManager::LoadGrid(int mapid, float x, float y, const WorldObject* obj, b
 
 void MapManager::UnloadAll()
 {
+    i_updater.Deactivate();
+    i_gridMapLoader.Deactivate();
+
     for(MapMapType::iterator iter=i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->UnloadAll(true);
 
@@ -25,6 +25,8 @@
 #include "Common.h"
 #include "Map.h"
 #include "GridStates.h"
+#include "MapUpdater.h"
+#include "GridMapLoader.h"
 
 class Transport;
 
@@ -113,6 +115,9 @@ class MANGOS_DLL_DECL MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::
         uint32 GetNumInstances();
         uint32 GetNumPlayersInInstances();
 
+        MapUpdater* GetMapUpdater() { return &i_updater; }
+        GridMapLoader* GetGridMapLoader() { return &i_gridMapLoader; }
+
     private:
         // debugging code, should be deleted some day
         void checkAndCorrectGridStatesArray();              // just for debugging to find some memory overwrites
@@ -138,5 +143,13 @@ class MANGOS_DLL_DECL MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::
         IntervalTimer i_timer;
 
         uint32 i_MaxInstanceId;
+
+        MapUpdater i_updater;
+        GridMapLoader i_gridMapLoader;
+
+        // map update tick time, logged periodically to compare serial and threaded updates
+        uint32 i_updateTicks;
+        uint32 i_updateTimeTotal;
+        uint32 i_updateTimeMax;
 };
 #endif
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MapUpdater.h"
+#include "Map.h"
+#include "Log.h"
+#include "zthread/PoolExecutor.h"
+#include "zthread/Runnable.h"
+
+class MapUpdateRequest : public ZThread::Runnable
+{
+    public:
+        MapUpdateRequest(Map& m, uint32 d) : i_map(m), i_diff(d) {}
+
+        void run()
+        {
+            i_map.Update(i_diff);
+        }
+
+    private:
+        Map& i_map;
+        uint32 i_diff;
+};
+
+MapUpdater::MapUpdater() : i_executor(NULL), i_threads(0)
+{
+}
+
+MapUpdater::~MapUpdater()
+{
+    Deactivate();
+}
+
+void MapUpdater::Activate(uint32 num_threads)
+{
+    Deactivate();
+
+    if(!num_threads)
+        return;
+
+    i_executor = new ZThread::PoolExecutor(num_threads);
+    i_threads = num_threads;
+
+    sLog.outString("Map updates will use %u worker threads", num_threads);
+}
+
+void MapUpdater::Deactivate()
+{
+    if(!i_executor)
+        return;
+
+    i_executor->wait();
+    i_executor->cancel();
+    delete i_executor;
+    i_executor = NULL;
+    i_threads = 0;
+}
+
+void MapUpdater::ScheduleUpdate(Map& map, uint32 diff)
+{
+    if(!i_executor)
+    {
+        map.Update(diff);
+        return;
+    }
+
+    i_executor->execute(ZThread::Task(new MapUpdateRequest(map, diff)));
+}
+
+void MapUpdater::Wait()
+{
+    if(i_executor)
+        i_executor->wait();
+}
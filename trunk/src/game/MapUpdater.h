@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPUPDATER_H
+#define MANGOS_MAPUPDATER_H
+
+#include "Common.h"
+
+namespace ZThread
+{
+    class PoolExecutor;
+}
+
+class Map;
+
+/// Runs independent Map::Update calls on a pool of worker threads
+class MANGOS_DLL_DECL MapUpdater
+{
+    public:
+        MapUpdater();
+        ~MapUpdater();
+
+        /// start num_threads worker threads (0 keeps updates on the caller thread)
+        void Activate(uint32 num_threads);
+        void Deactivate();
+        bool IsActivated() const { return i_executor != NULL; }
+        uint32 GetThreadCount() const { return i_threads; }
+
+        /// update the map right away when not activated, else queue it for a worker thread
+        void ScheduleUpdate(Map& map, uint32 diff);
+
+        /// barrier: block until all maps scheduled before this call are updated
+        void Wait();
+
+    private:
+        MapUpdater(const MapUpdater&);
+        MapUpdater& operator=(const MapUpdater&);
+
+        ZThread::PoolExecutor* i_executor;
+        uint32 i_threads;
+};
+#endif
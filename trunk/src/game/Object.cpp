@@ -29,6 +29,7 @@
 #include "WorldSession.h"
 #include "UpdateData.h"
 #include "UpdateMask.h"
+#include "UpdateFieldsStorage.h"
 #include "Util.h"
 #include "MapManager.h"
 #include "ObjectAccessor.h"
@@ -222,9 +223,54 @@ void Object::SendUpdateToPlayer(Player* player)
     // now object updated/(create updated)
 }
 
-void Object::BuildValuesUpdateBlockForPlayer(UpdateData *data, Player *target) const
+// bits of values update view key
+enum ValuesUpdateView
 {
-    ByteBuffer buf(500);
+    VALUES_VIEW_SELF        = 0x01,                         // player own values
+    VALUES_VIEW_GM          = 0x02,                         // changed unit flags, selectable for GM
+    VALUES_VIEW_LOOTER      = 0x04,                         // changed creature dynamic flags, lootable for target
+    VALUES_VIEW_QUEST       = 0x08                          // gameobject activated for target quests (or GM)
+};
+
+uint8 Object::GetValuesUpdateViewKey(Player *target) const
+{
+    uint8 key = 0;
+
+    if(target == this)
+        key |= VALUES_VIEW_SELF;
+
+    if(isType(TYPEMASK_UNIT))
+    {
+        if(_IsValueChanged(UNIT_FIELD_FLAGS) && target->isGameMaster())
+            key |= VALUES_VIEW_GM;
+
+        if(GetTypeId() == TYPEID_UNIT && _IsValueChanged(UNIT_DYNAMIC_FLAGS) && target->isAllowedToLoot((Creature*)this))
+            key |= VALUES_VIEW_LOOTER;
+    }
+    else if(isType(TYPEMASK_GAMEOBJECT) && !((GameObject*)this)->IsTransport())
+    {
+        if(((GameObject*)this)->ActivateToQuest(target) || target->isGameMaster())
+            key |= VALUES_VIEW_QUEST;
+    }
+
+    return key;
+}
+
+void Object::BuildValuesUpdateBlockForPlayer(UpdateData *data, Player *target, ValuesUpdateCache* cache) const
+{
+    uint8 key = 0;
+    if(cache)
+    {
+        key = GetValuesUpdateViewKey(target);
+        if(ByteBuffer const* block = cache->Find(key))
+        {
+            data->AddUpdateBlock(*block);
+            return;
+        }
+    }
+
+    ByteBuffer localBuf;
+    ByteBuffer& buf = cache ? cache->Add(key) : localBuf;
 
     buf << (uint8) UPDATETYPE_VALUES;
     //buf.append(GetPackGUID());    //client crashes when using this. but not have crash in debug mode
@@ -563,89 +609,80 @@ void Object::_BuildValuesUpdate(uint8 updatetype, ByteBuffer * data, UpdateMask
     // 2 specialized loops for speed optimization in non-unit case
     if(isType(TYPEMASK_UNIT))                               // unit (creature/player) case
     {
-        for( uint16 index = 0; index < m_valuesCount; index ++ )
+        for( uint16 index = updateMask->GetNextSetBit(0); index < m_valuesCount; index = updateMask->GetNextSetBit(index + 1) )
         {
-            if( updateMask->GetBit( index ) )
+            // remove custom flag before send
+            if( index == UNIT_NPC_FLAGS )
+                *data << uint32(m_uint32Values[ index ] & ~UNIT_NPC_FLAG_GUARD);
+            // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
+            else if(index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
             {
-                // remove custom flag before send
-                if( index == UNIT_NPC_FLAGS )
-                    *data << uint32(m_uint32Values[ index ] & ~UNIT_NPC_FLAG_GUARD);
-                // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
-                else if(index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
-                {
-                    // convert from float to uint32 and send
-                    *data << uint32(m_floatValues[ index ] < 0 ? 0 : m_floatValues[ index ]);
-                }
-                // there are some float values which may be negative or can't get negative due to other checks
-                else if(index >= UNIT_FIELD_NEGSTAT0   && index <= UNIT_FIELD_NEGSTAT4 ||
-                    index >= UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6) ||
-                    index >= UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6) ||
-                    index >= UNIT_FIELD_POSSTAT0   && index <= UNIT_FIELD_POSSTAT4)
-                {
-                    *data << uint32(m_floatValues[ index ]);
-                }
-                // Gamemasters should be always able to select units - remove not selectable flag
-                else if(index == UNIT_FIELD_FLAGS && target->isGameMaster())
-                {
-                    *data << (m_uint32Values[ index ] & ~UNIT_FLAG_NOT_SELECTABLE);
-                }
-                // hide lootable animation for unallowed players
-                else if(index == UNIT_DYNAMIC_FLAGS && GetTypeId() == TYPEID_UNIT)
-                {
-                    if(!target->isAllowedToLoot((Creature*)this))
-                        *data << (m_uint32Values[ index ] & ~UNIT_DYNFLAG_LOOTABLE);
-                    else
-                        *data << (m_uint32Values[ index ] & ~UNIT_DYNFLAG_OTHER_TAGGER);
-                }
+                // convert from float to uint32 and send
+                *data << uint32(m_floatValues[ index ] < 0 ? 0 : m_floatValues[ index ]);
+            }
+            // there are some float values which may be negative or can't get negative due to other checks
+            else if(index >= UNIT_FIELD_NEGSTAT0   && index <= UNIT_FIELD_NEGSTAT4 ||
+                index >= UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6) ||
+                index >= UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6) ||
+                index >= UNIT_FIELD_POSSTAT0   && index <= UNIT_FIELD_POSSTAT4)
+            {
+                *data << uint32(m_floatValues[ index ]);
+            }
+            // Gamemasters should be always able to select units - remove not selectable flag
+            else if(index == UNIT_FIELD_FLAGS && target->isGameMaster())
+            {
+                *data << (m_uint32Values[ index ] & ~UNIT_FLAG_NOT_SELECTABLE);
+            }
+            // hide lootable animation for unallowed players
+            else if(index == UNIT_DYNAMIC_FLAGS && GetTypeId() == TYPEID_UNIT)
+            {
+                if(!target->isAllowedToLoot((Creature*)this))
+                    *data << (m_uint32Values[ index ] & ~UNIT_DYNFLAG_LOOTABLE);
                 else
-                {
-                    // send in current format (float as float, uint32 as uint32)
-                    *data << m_uint32Values[ index ];
-                }
+                    *data << (m_uint32Values[ index ] & ~UNIT_DYNFLAG_OTHER_TAGGER);
+            }
+            else
+            {
+                // send in current format (float as float, uint32 as uint32)
+                *data << m_uint32Values[ index ];
             }
         }
     }
     else if(isType(TYPEMASK_GAMEOBJECT))                    // gameobject case
     {
-        for( uint16 index = 0; index < m_valuesCount; index ++ )
+        for( uint16 index = updateMask->GetNextSetBit(0); index < m_valuesCount; index = updateMask->GetNextSetBit(index + 1) )
         {
-            if( updateMask->GetBit( index ) )
+            // send in current format (float as float, uint32 as uint32)
+            if ( index == GAMEOBJECT_DYN_FLAGS )
             {
-                // send in current format (float as float, uint32 as uint32)
-                if ( index == GAMEOBJECT_DYN_FLAGS )
+                if(IsActivateToQuest )
                 {
-                    if(IsActivateToQuest )
+                    switch(((GameObject*)this)->GetGoType())
                     {
-                        switch(((GameObject*)this)->GetGoType())
-                        {
-                            case GAMEOBJECT_TYPE_CHEST:
-                                *data << uint32(9);         // enable quest object. Represent 9, but 1 for client before 2.3.0
-                                break;
-                            case GAMEOBJECT_TYPE_GOOBER:
-                                *data << uint32(1);
-                                break;
-                            default:
-                                *data << uint32(0);         //unknown. not happen.
-                                break;
-                        }
+                        case GAMEOBJECT_TYPE_CHEST:
+                            *data << uint32(9);             // enable quest object. Represent 9, but 1 for client before 2.3.0
+                            break;
+                        case GAMEOBJECT_TYPE_GOOBER:
+                            *data << uint32(1);
+                            break;
+                        default:
+                            *data << uint32(0);             //unknown. not happen.
+                            break;
                     }
-                    else
-                        *data << uint32(0);                 // disable quest object
                 }
                 else
-                    *data << m_uint32Values[ index ];       // other cases
+                    *data << uint32(0);                     // disable quest object
             }
+            else
+                *data << m_uint32Values[ index ];           // other cases
         }
     }
     else                                                    // other objects case (no special index checks)
     {
-        for( uint16 index = 0; index < m_valuesCount; index ++ )
+        for( uint16 index = updateMask->GetNextSetBit(0); index < m_valuesCount; index = updateMask->GetNextSetBit(index + 1) )
         {
-            if( updateMask->GetBit( index ) )
-            {
-                // send in current format (float as float, uint32 as uint32)
-                *data << m_uint32Values[ index ];
-            }
+            // send in current format (float as float, uint32 as uint32)
+            *data << m_uint32Values[ index ];
         }
     }
 }
@@ -679,23 +716,11 @@ void Object::SendUpdateObjectToAllExcept(Player* exceptPlayer)
     ObjectAccessor::UpdateObject(this,exceptPlayer);
 }
 
-bool Object::LoadValues(const char* data)
+bool Object::LoadValues(Field const& data)
 {
     if(!m_uint32Values) _InitValues();
 
-    Tokens tokens = StrSplit(data, " ");
-
-    if(tokens.size() != m_valuesCount)
-        return false;
-
-    Tokens::iterator iter;
-    int index;
-    for (iter = tokens.begin(), index = 0; index < m_valuesCount; ++iter, ++index)
-    {
-        m_uint32Values[index] = atol((*iter).c_str());
-    }
-
-    return true;
+    return UpdateFieldsStorage::Read(data, m_uint32Values, m_valuesCount);
 }
 
 void Object::_SetUpdateBits(UpdateMask *updateMask, Player* /*target*/) const
@@ -955,6 +980,10 @@ WorldObject::WorldObject()
     m_name = "";
 
     mSemaphoreTeleport  = false;
+
+    m_spatialIndex      = NULL;
+    m_spatialCell       = 0;
+    m_spatialSlot       = 0;
 }
 
 void WorldObject::_Create( uint32 guidlow, HighGuid guidhigh, uint32 mapid )
@@ -1362,6 +1391,12 @@ void WorldObject::SendObjectDeSpawnAnim(uint64 guid)
     SendMessageToSet(&data, true);
 }
 
+void WorldObject::UpdateSpatialIndex()
+{
+    if(m_spatialIndex)
+        m_spatialIndex->Relocate(this);
+}
+
 Map* WorldObject::GetMap() const
 {
     return MapManager::Instance().GetMap(GetMapId(), this);
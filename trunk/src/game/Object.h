@@ -89,6 +89,9 @@ class Player;
 class Map;
 class UpdateMask;
 class InstanceData;
+class Field;
+class ValuesUpdateCache;
+class UnitSpatialIndex;
 
 typedef HM_NAMESPACE::hash_map<Player*, UpdateData> UpdateDataMapType;
 
@@ -143,7 +146,7 @@ class MANGOS_DLL_SPEC Object
         virtual void BuildCreateUpdateBlockForPlayer( UpdateData *data, Player *target ) const;
         void SendUpdateToPlayer(Player* player);
 
-        void BuildValuesUpdateBlockForPlayer( UpdateData *data, Player *target ) const;
+        void BuildValuesUpdateBlockForPlayer( UpdateData *data, Player *target, ValuesUpdateCache* cache = NULL ) const;
         void BuildOutOfRangeUpdateBlock( UpdateData *data ) const;
         void BuildMovementUpdateBlock( UpdateData * data, uint32 flags = 0 ) const;
         void BuildUpdate(UpdateDataMapType &);
@@ -268,7 +271,7 @@ class MANGOS_DLL_SPEC Object
         void ClearUpdateMask(bool remove);
         void SendUpdateObjectToAllExcept(Player* exceptPlayer);
 
-        bool LoadValues(const char* data);
+        bool LoadValues(Field const& data);
 
         uint16 GetValuesCount() const { return m_valuesCount; }
 
@@ -286,6 +289,10 @@ class MANGOS_DLL_SPEC Object
         virtual void _SetUpdateBits(UpdateMask *updateMask, Player *target) const;
 
         virtual void _SetCreateBits(UpdateMask *updateMask, Player *target) const;
+
+        /// observers with the same key get the same values update (target dependent fields)
+        uint8 GetValuesUpdateViewKey(Player *target) const;
+        bool _IsValueChanged(uint16 index) const { return m_uint32Values_mirror[index] != m_uint32Values[index]; }
         void _BuildMovementUpdate(ByteBuffer * data, uint8 flags, uint32 flags2 ) const;
         void _BuildValuesUpdate(uint8 updatetype, ByteBuffer *data, UpdateMask *updateMask, Player *target ) const;
 
@@ -333,6 +340,9 @@ class MANGOS_DLL_SPEC WorldObject : public Object
             m_positionY = y;
             m_positionZ = z;
             m_orientation = orientation;
+
+            if(m_spatialIndex)
+                UpdateSpatialIndex();
         }
 
         void Relocate(float x, float y, float z)
@@ -340,6 +350,9 @@ class MANGOS_DLL_SPEC WorldObject : public Object
             m_positionX = x;
             m_positionY = y;
             m_positionZ = z;
+
+            if(m_spatialIndex)
+                UpdateSpatialIndex();
         }
 
         void Relocate(WorldLocation const & loc)
@@ -376,6 +389,8 @@ class MANGOS_DLL_SPEC WorldObject : public Object
             return ( m_valuesCount > UNIT_FIELD_BOUNDINGRADIUS ) ? m_floatValues[UNIT_FIELD_BOUNDINGRADIUS] : DEFAULT_WORLD_OBJECT_SIZE;
         }
         bool IsPositionValid() const;
+        // refresh position and size in the unit index of map, needed only for size changes (Relocate does it)
+        void UpdateSpatialIndex();
         void UpdateGroundPositionZ(float x, float y, float &z) const;
 
         void GetRandomPoint( float x, float y, float z, float distance, float &rand_x, float &rand_y, float &rand_z ) const;
@@ -446,6 +461,12 @@ class MANGOS_DLL_SPEC WorldObject : public Object
         explicit WorldObject();
         std::string m_name;
 
+        // set while unit is in UnitSpatialIndex of its map
+        friend class UnitSpatialIndex;
+        UnitSpatialIndex* m_spatialIndex;
+        uint32 m_spatialCell;
+        uint32 m_spatialSlot;
+
     private:
         uint32 m_mapId;
 
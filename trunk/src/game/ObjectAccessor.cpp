@@ -308,6 +308,9 @@ ObjectAccessor::RemoveUpdateObject(Object *obj)
 void
 ObjectAccessor::_buildUpdateObject(Object *obj, UpdateDataMapType &update_players)
 {
+    // values update blocks are built once per view and shared by all receivers
+    ValuesUpdateCache cache;
+
     bool build_for_all = true;
     Player *pl = NULL;
     if( obj->isType(TYPEMASK_ITEM) )
@@ -318,7 +321,7 @@ ObjectAccessor::_buildUpdateObject(Object *obj, UpdateDataMapType &update_player
     }
 
     if( pl != NULL )
-        _buildPacket(pl, obj, update_players);
+        _buildPacket(pl, obj, update_players, cache);
 
     // Capt: okey for all those fools who think its a real fix
     //       THIS IS A TEMP FIX
@@ -328,14 +331,14 @@ ObjectAccessor::_buildUpdateObject(Object *obj, UpdateDataMapType &update_player
 
         //assert(dynamic_cast<WorldObject*>(obj)!=NULL);
         if (temp)
-            _buildChangeObjectForPlayer(temp, update_players);
+            _buildChangeObjectForPlayer(temp, update_players, cache);
         else
             sLog.outDebug("ObjectAccessor: Ln 405 Temp bug fix");
     }
 }
 
 void
-ObjectAccessor::_buildPacket(Player *pl, Object *obj, UpdateDataMapType &update_players)
+ObjectAccessor::_buildPacket(Player *pl, Object *obj, UpdateDataMapType &update_players, ValuesUpdateCache &cache)
 {
     UpdateDataMapType::iterator iter = update_players.find(pl);
 
@@ -346,17 +349,17 @@ ObjectAccessor::_buildPacket(Player *pl, Object *obj, UpdateDataMapType &update_
         iter = p.first;
     }
 
-    obj->BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    obj->BuildValuesUpdateBlockForPlayer(&iter->second, iter->first, &cache);
 }
 
 void
-ObjectAccessor::_buildChangeObjectForPlayer(WorldObject *obj, UpdateDataMapType &update_players)
+ObjectAccessor::_buildChangeObjectForPlayer(WorldObject *obj, UpdateDataMapType &update_players, ValuesUpdateCache &cache)
 {
     CellPair p = MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY());
     Cell cell(p);
     cell.data.Part.reserved = ALL_DISTRICT;
     cell.SetNoCreate();
-    WorldObjectChangeAccumulator notifier(*obj, update_players);
+    WorldObjectChangeAccumulator notifier(*obj, update_players, cache);
     TypeContainerVisitor<WorldObjectChangeAccumulator, WorldTypeMapContainer > player_notifier(notifier);
     CellLock<GridReadGuard> cell_lock(cell, p);
     cell_lock->Visit(cell_lock, player_notifier, *MapManager::Instance().GetMap(obj->GetMapId(), obj));
@@ -503,108 +506,18 @@ ObjectAccessor::ConvertCorpseForPlayer(uint64 player_guid)
 }
 
 void
-ObjectAccessor::Update(uint32 diff)
+ObjectAccessor::Update(uint32 /*diff*/)
 {
-    {
-        typedef std::multimap<uint32, Player *> CreatureLocationHolderType;
-        CreatureLocationHolderType creature_locations;
-        //TODO: Player guard
-        HashMapHolder<Player>::MapType& playerMap = HashMapHolder<Player>::GetContainer();
-        for(HashMapHolder<Player>::MapType::iterator iter = playerMap.begin(); iter != playerMap.end(); ++iter)
-        {
-            if(iter->second->IsInWorld())
-            {
-                iter->second->Update(diff);
-                creature_locations.insert( CreatureLocationHolderType::value_type(iter->second->GetMapId(), iter->second) );
-            }
-        }
-
-        Map *map;
-
-        MaNGOS::ObjectUpdater updater(diff);
-        // for creature
-        TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
-        // for pets
-        TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
-
-        for(CreatureLocationHolderType::iterator iter=creature_locations.begin(); iter != creature_locations.end(); ++iter)
-        {
-            MapManager::Instance().GetMap((*iter).first, (*iter).second)->resetMarkedCells();
-        }
-
-        for(CreatureLocationHolderType::iterator iter=creature_locations.begin(); iter != creature_locations.end(); ++iter)
-        {
-            Player *player = (*iter).second;
-            map = MapManager::Instance().GetMap((*iter).first, player);
-
-            CellPair standing_cell(MaNGOS::ComputeCellPair(player->GetPositionX(), player->GetPositionY()));
-
-            // Check for correctness of standing_cell, it also avoids problems with update_cell
-            if (standing_cell.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || standing_cell.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
-                continue;
-
-            // the overloaded operators handle range checking
-            // so ther's no need for range checking inside the loop
-            CellPair begin_cell(standing_cell), end_cell(standing_cell);
-            begin_cell << 1; begin_cell -= 1;               // upper left
-            end_cell >> 1; end_cell += 1;                   // lower right
-
-            for(uint32 x = begin_cell.x_coord; x <= end_cell.x_coord; x++)
-            {
-                for(uint32 y = begin_cell.y_coord; y <= end_cell.y_coord; y++)
-                {
-                    uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                    if( !map->isCellMarked(cell_id) )
-                    {
-                        CellPair cell_pair(x,y);
-                        map->markCell(cell_id);
-                        Cell cell(cell_pair);
-                        cell.data.Part.reserved = CENTER_DISTRICT;
-                        cell.SetNoCreate();
-                        CellLock<NullGuard> cell_lock(cell, cell_pair);
-                        cell_lock->Visit(cell_lock, grid_object_update,  *map);
-                        cell_lock->Visit(cell_lock, world_object_update, *map);
-                    }
-                }
-            }
-        }
-    }
-
+    // players, creatures and pets already updated at their own Map::Update, only send the collected changes
     _update();
 }
 
-bool
-ObjectAccessor::PlayersNearGrid(uint32 x, uint32 y, uint32 m_id, uint32 i_id) const
-{
-    CellPair cell_min(x*MAX_NUMBER_OF_CELLS, y*MAX_NUMBER_OF_CELLS);
-    CellPair cell_max(cell_min.x_coord + MAX_NUMBER_OF_CELLS, cell_min.y_coord+MAX_NUMBER_OF_CELLS);
-    cell_min << 2;
-    cell_min -= 2;
-    cell_max >> 2;
-    cell_max += 2;
-
-    //TODO: Guard player
-    HashMapHolder<Player>::MapType& playerMap = HashMapHolder<Player>::GetContainer();
-    for(HashMapHolder<Player>::MapType::const_iterator iter=playerMap.begin(); iter != playerMap.end(); ++iter)
-    {
-        if( m_id != iter->second->GetMapId() || i_id != iter->second->GetInstanceId() )
-            continue;
-
-        CellPair p = MaNGOS::ComputeCellPair(iter->second->GetPositionX(), iter->second->GetPositionY());
-        if( (cell_min.x_coord <= p.x_coord && p.x_coord <= cell_max.x_coord) &&
-            (cell_min.y_coord <= p.y_coord && p.y_coord <= cell_max.y_coord) )
-            return true;
-    }
-
-    return false;
-}
-
 void
 ObjectAccessor::WorldObjectChangeAccumulator::Visit(PlayerMapType &m)
 {
     for(PlayerMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
         if(iter->getSource()->HaveAtClient(&i_object))
-            ObjectAccessor::_buildPacket(iter->getSource(), &i_object, i_updateDatas);
+            ObjectAccessor::_buildPacket(iter->getSource(), &i_object, i_updateDatas, i_cache);
 }
 
 void
@@ -51,7 +51,11 @@ class HashMapHolder
         typedef ZThread::FastMutex LockType;
         typedef MaNGOS::GeneralLock<LockType > Guard;
 
-        static void Insert(T* o) { m_objectMap[o->GetGUID()] = o; }
+        static void Insert(T* o)
+        {
+            Guard guard(i_lock);
+            m_objectMap[o->GetGUID()] = o;
+        }
 
         static void Remove(T* o)
         {
@@ -191,8 +195,6 @@ class MANGOS_DLL_DECL ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor,
         void AddCorpsesToGrid(GridPair const& gridpair,GridType& grid,Map* map);
         Corpse* ConvertCorpseForPlayer(uint64 player_guid);
 
-        bool PlayersNearGrid(uint32 x,uint32 y,uint32 m_id,uint32 i_id) const;
-
         static void UpdateObject(Object* obj, Player* exceptPlayer);
         static void _buildUpdateObject(Object* obj, UpdateDataMapType &);
 
@@ -203,7 +205,8 @@ class MANGOS_DLL_DECL ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor,
         {
             UpdateDataMapType &i_updateDatas;
             WorldObject &i_object;
-            WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataMapType &d) : i_updateDatas(d), i_object(obj) {}
+            ValuesUpdateCache &i_cache;
+            WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataMapType &d, ValuesUpdateCache &cache) : i_updateDatas(d), i_object(obj), i_cache(cache) {}
             void Visit(PlayerMapType &);
             template<class SKIP> void Visit(GridRefManager<SKIP> &) {}
         };
@@ -214,8 +217,8 @@ class MANGOS_DLL_DECL ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor,
         typedef ZThread::FastMutex LockType;
         typedef MaNGOS::GeneralLock<LockType > Guard;
 
-        static void _buildChangeObjectForPlayer(WorldObject *, UpdateDataMapType &);
-        static void _buildPacket(Player *, Object *, UpdateDataMapType &);
+        static void _buildChangeObjectForPlayer(WorldObject *, UpdateDataMapType &, ValuesUpdateCache &);
+        static void _buildPacket(Player *, Object *, UpdateDataMapType &, ValuesUpdateCache &);
         void _update(void);
         std::set<Object *> i_objects;
         LockType i_playerGuard;
@@ -107,6 +107,15 @@ template<> void addUnitState(Creature *obj, CellPair const& cell_pair)
         obj->setDeathState(DEAD);
 }
 
+template<class T> void addToUnitIndex(T* /*obj*/, Map* /*map*/)
+{
+}
+
+template<> void addToUnitIndex(Creature *obj, Map* map)
+{
+    map->GetUnitSpatialIndex().Add(obj);
+}
+
 template <class T>
 void LoadHelper(CellGuidSet const& guid_set, CellPair &cell, GridRefManager<T> &m, uint32 &count, Map* map)
 {
@@ -125,6 +134,7 @@ void LoadHelper(CellGuidSet const& guid_set, CellPair &cell, GridRefManager<T> &
 
         addUnitState(obj,cell);
         obj->AddToWorld();
+        addToUnitIndex(obj,map);
         ++count;
 
     }
@@ -39,6 +39,7 @@
 #include "Chat.h"
 #include "InstanceSaveMgr.h"
 #include "SpellAuras.h"
+#include "CharacterSnapshotCache.h"
 #include "Util.h"
 
 INSTANTIATE_SINGLETON_1(ObjectMgr);
@@ -890,13 +891,14 @@ void ObjectMgr::LoadCreatureModelInfo()
 void ObjectMgr::LoadCreatures()
 {
     uint32 count = 0;
+    static SqlStatementID selCreatures;
     //                                                0              1   2    3
-    QueryResult *result = WorldDatabase.Query("SELECT creature.guid, id, map, modelid,"
+    QueryResult *result = WorldDatabase.PreparedQuery(selCreatures, "SELECT creature.guid, id, map, modelid,"
     //   4             5           6           7           8            9              10         11
         "equipment_id, position_x, position_y, position_z, orientation, spawntimesecs, spawndist, currentwaypoint,"
     //   12         13       14          15            16         17
         "curhealth, curmana, DeathState, MovementType, spawnMask, event "
-        "FROM creature LEFT OUTER JOIN game_event_creature ON creature.guid = game_event_creature.guid");
+        "FROM creature LEFT OUTER JOIN game_event_creature ON creature.guid = game_event_creature.guid", SqlStmtParameters());
 
     if(!result)
     {
@@ -1049,11 +1051,12 @@ void ObjectMgr::LoadGameobjects()
 {
     uint32 count = 0;
 
+    static SqlStatementID selGameobjects;
     //                                                0                1   2    3           4           5           6
-    QueryResult *result = WorldDatabase.Query("SELECT gameobject.guid, id, map, position_x, position_y, position_z, orientation,"
+    QueryResult *result = WorldDatabase.PreparedQuery(selGameobjects, "SELECT gameobject.guid, id, map, position_x, position_y, position_z, orientation,"
     //   7          8          9          10         11             12            13     14         15
         "rotation0, rotation1, rotation2, rotation3, spawntimesecs, animprogress, state, spawnMask, event "
-        "FROM gameobject LEFT OUTER JOIN game_event_gameobject ON gameobject.guid = game_event_gameobject.guid");
+        "FROM gameobject LEFT OUTER JOIN game_event_gameobject ON gameobject.guid = game_event_gameobject.guid", SqlStmtParameters());
 
     if(!result)
     {
@@ -1151,7 +1154,8 @@ void ObjectMgr::LoadCreatureRespawnTimes()
 
     uint32 count = 0;
 
-    QueryResult *result = WorldDatabase.Query("SELECT guid,respawntime,instance FROM creature_respawn");
+    static SqlStatementID selRespawnTimes;
+    QueryResult *result = WorldDatabase.PreparedQuery(selRespawnTimes, "SELECT guid,respawntime,instance FROM creature_respawn", SqlStmtParameters());
 
     if(!result)
     {
@@ -1193,7 +1197,8 @@ void ObjectMgr::LoadGameobjectRespawnTimes()
 
     uint32 count = 0;
 
-    QueryResult *result = WorldDatabase.Query("SELECT guid,respawntime,instance FROM gameobject_respawn");
+    static SqlStatementID selRespawnTimes;
+    QueryResult *result = WorldDatabase.PreparedQuery(selRespawnTimes, "SELECT guid,respawntime,instance FROM gameobject_respawn", SqlStmtParameters());
 
     if(!result)
     {
@@ -4265,6 +4270,10 @@ void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
     QueryResult* result = CharacterDatabase.PQuery("SELECT id,messageType,sender,receiver,itemTextId,has_items,expire_time,cod,checked,mailTemplateId FROM mail WHERE expire_time < '" I64FMTD "'", (uint64)basetime);
     if ( !result )
         return;                                             // any mails need to be returned or deleted
+
+    // mail counts of offline receivers and senders are changed
+    sCharacterSnapshotCache.Clear();
+
     Field *fields;
     //std::ostringstream delitems, delmails; //will be here for optimization
     //bool deletemail = false, deleteitem = false;
@@ -5043,6 +5052,8 @@ void ObjectMgr::SetHighestGuids()
 
 uint32 ObjectMgr::GenerateAuctionID()
 {
+    ZThread::Guard<ZThread::FastMutex> guard(m_guidLock);
+
     ++m_auctionid;
     if(m_auctionid>=0xFFFFFFFF)
     {
@@ -5054,6 +5065,8 @@ uint32 ObjectMgr::GenerateAuctionID()
 
 uint32 ObjectMgr::GenerateMailID()
 {
+    ZThread::Guard<ZThread::FastMutex> guard(m_guidLock);
+
     ++m_mailid;
     if(m_mailid>=0xFFFFFFFF)
     {
@@ -5065,6 +5078,8 @@ uint32 ObjectMgr::GenerateMailID()
 
 uint32 ObjectMgr::GenerateItemTextID()
 {
+    ZThread::Guard<ZThread::FastMutex> guard(m_guidLock);
+
     ++m_ItemTextId;
     if(m_ItemTextId>=0xFFFFFFFF)
     {
@@ -5090,6 +5105,8 @@ uint32 ObjectMgr::CreateItemText(std::string text)
 
 uint32 ObjectMgr::GenerateLowGuid(HighGuid guidhigh)
 {
+    ZThread::Guard<ZThread::FastMutex> guard(m_guidLock);
+
     switch(guidhigh)
     {
         case HIGHGUID_ITEM:
@@ -5518,6 +5535,8 @@ std::string ObjectMgr::GeneratePetName(uint32 entry)
 
 uint32 ObjectMgr::GeneratePetNumber()
 {
+    ZThread::Guard<ZThread::FastMutex> guard(m_guidLock);
+
     return ++m_hiPetNumber;
 }
 
@@ -6697,7 +6716,8 @@ void ObjectMgr::LoadTrainerSpell()
 
     std::set<uint32> skip_trainers;
 
-    QueryResult *result = WorldDatabase.PQuery("SELECT entry, spell,spellcost,reqskill,reqskillvalue,reqlevel FROM npc_trainer");
+    static SqlStatementID selTrainerSpells;
+    QueryResult *result = WorldDatabase.PreparedQuery(selTrainerSpells, "SELECT entry, spell,spellcost,reqskill,reqskillvalue,reqlevel FROM npc_trainer", SqlStmtParameters());
 
     if( !result )
     {
@@ -6788,7 +6808,8 @@ void ObjectMgr::LoadVendors()
 
     std::set<uint32> skip_vendors;
 
-    QueryResult *result = WorldDatabase.PQuery("SELECT entry, item, maxcount, incrtime, ExtendedCost FROM npc_vendor");
+    static SqlStatementID selVendors;
+    QueryResult *result = WorldDatabase.PreparedQuery(selVendors, "SELECT entry, item, maxcount, incrtime, ExtendedCost FROM npc_vendor", SqlStmtParameters());
     if( !result )
     {
         barGoLink bar( 1 );
@@ -6834,7 +6855,8 @@ void ObjectMgr::LoadNpcTextId()
 
     m_mCacheNpcTextIdMap.clear();
 
-    QueryResult* result = WorldDatabase.PQuery("SELECT npc_guid, textid FROM npc_gossip");
+    static SqlStatementID selNpcTextIds;
+    QueryResult* result = WorldDatabase.PreparedQuery(selNpcTextIds, "SELECT npc_guid, textid FROM npc_gossip", SqlStmtParameters());
     if( !result )
     {
         barGoLink bar( 1 );
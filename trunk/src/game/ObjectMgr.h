@@ -39,6 +39,7 @@
 #include "ObjectDefines.h"
 #include "Policies/Singleton.h"
 #include "Database/SQLStorage.h"
+#include "zthread/FastMutex.h"
 
 #include <string>
 #include <map>
@@ -741,6 +742,7 @@ class ObjectMgr
         bool RemoveVendorItem(uint32 entry,uint32 item);
         bool IsVendorItemValid( uint32 vendor_entry, uint32 item, uint32 maxcount, uint32 ptime, uint32 ExtendedCost, Player* pl = NULL, std::set<uint32>* skip_vendors = NULL ) const;
     protected:
+        ZThread::FastMutex m_guidLock;                      // id generators are used from map update threads
         uint32 m_auctionid;
         uint32 m_mailid;
         uint32 m_ItemTextId;
@@ -58,10 +58,14 @@
 #include "Database/DatabaseImpl.h"
 #include "Spell.h"
 #include "SocialMgr.h"
+#include "CharacterSnapshotCache.h"
+#include "UpdateFieldsStorage.h"
+#include "Database/SqlBatch.h"
 
 #include <cmath>
 
 #define ZONE_UPDATE_INTERVAL 1000
+#define SAVE_DEFER_DELAY     10000                          // autosave retry time while character DB is busy
 
 #define PLAYER_SKILL_INDEX(x)       (PLAYER_SKILL_INFO_1_1 + ((x)*3))
 #define PLAYER_SKILL_VALUE_INDEX(x) (PLAYER_SKILL_INDEX(x)+1)
@@ -290,6 +294,7 @@ Player::Player (WorldSession *session): Unit()
     // randomize first save time in range [CONFIG_INTERVAL_SAVE] around [CONFIG_INTERVAL_SAVE]
     // this must help in case next save after mass player load after server startup
     m_nextSave = urand(m_nextSave/2,m_nextSave*3/2);
+    m_saveDeferTime = 0;
 
     clearResurrectRequestData();
 
@@ -328,6 +333,8 @@ Player::Player (WorldSession *session): Unit()
     m_DailyQuestChanged = false;
     m_lastDailyQuestTime = 0;
 
+    m_spellCooldownsChanged = false;
+
     m_regenTimer = 0;
     m_weaponChangeTimer = 0;
     m_breathTimer = 0;
@@ -419,6 +426,13 @@ Player::Player (WorldSession *session): Unit()
     m_bgAfkReportedTimer = 0;
     m_contestedPvPTimer = 0;
 
+    m_moveNotifyPending = false;
+    m_moveNotifyForced = false;
+    m_moveNotifyX = 0.0f;
+    m_moveNotifyY = 0.0f;
+    m_moveNotifyZ = 0.0f;
+    m_moveNotifyTime = 0;
+
     m_declinedname = NULL;
 }
 
@@ -1124,9 +1138,22 @@ void Player::Update( uint32 p_time )
     {
         if(p_time >= m_nextSave)
         {
-            // m_nextSave reseted in SaveToDB call
-            SaveToDB();
-            sLog.outDetail("Player '%s' (GUID: %u) saved", GetName(), GetGUIDLow());
+            // character DB writes are queued: delay autosave (spread to not retry all at once),
+            // but not longer than one save interval. Logout and other direct saves are not delayed
+            uint32 deferQueueSize = sWorld.getConfig(CONFIG_SAVE_DEFER_QUEUE_SIZE);
+            if(deferQueueSize && m_saveDeferTime < sWorld.getConfig(CONFIG_INTERVAL_SAVE) &&
+                CharacterDatabase.GetWriteQueueSize() > deferQueueSize)
+            {
+                m_nextSave = urand(SAVE_DEFER_DELAY/2, SAVE_DEFER_DELAY*3/2);
+                m_saveDeferTime += m_nextSave;
+                sLog.outDebug("Player '%s' (GUID: %u) autosave delayed, character DB write queue is full", GetName(), GetGUIDLow());
+            }
+            else
+            {
+                // m_nextSave reseted in SaveToDB call
+                SaveToDB();
+                sLog.outDetail("Player '%s' (GUID: %u) saved", GetName(), GetGUIDLow());
+            }
         }
         else
         {
@@ -2937,6 +2964,7 @@ void Player::RemoveArenaSpellCooldowns()
             GetSession()->SendPacket(&data);
             // remove cooldown
             m_spellCooldowns.erase(itr);
+            m_spellCooldownsChanged = true;
         }
     }
 }
@@ -2953,6 +2981,7 @@ void Player::RemoveAllSpellCooldown()
             GetSession()->SendPacket(&data);
         }
         m_spellCooldowns.clear();
+        m_spellCooldownsChanged = true;
     }
 }
 
@@ -2992,14 +3021,25 @@ void Player::_LoadSpellCooldowns(QueryResult *result)
 
         delete result;
     }
+
+    // outdated cooldowns left in DB are skipped at next load also
+    m_spellCooldownsChanged = false;
 }
 
 void Player::_SaveSpellCooldowns()
 {
+    // expired cooldowns not need DB update, they are skipped at load
+    if(!m_spellCooldownsChanged)
+        return;
+
+    m_spellCooldownsChanged = false;
+
     CharacterDatabase.PExecute("DELETE FROM character_spell_cooldown WHERE guid = '%u'", GetGUIDLow());
 
     time_t curTime = time(NULL);
 
+    SqlInsertBatch cooldowns(CharacterDatabase, "INSERT INTO character_spell_cooldown (guid,spell,item,time) VALUES ");
+
     // remove outdated and save active
     for(SpellCooldowns::iterator itr = m_spellCooldowns.begin();itr != m_spellCooldowns.end();)
     {
@@ -3007,10 +3047,12 @@ void Player::_SaveSpellCooldowns()
             m_spellCooldowns.erase(itr++);
         else
         {
-            CharacterDatabase.PExecute("INSERT INTO character_spell_cooldown (guid,spell,item,time) VALUES ('%u', '%u', '%u', '" I64FMTD "')", GetGUIDLow(), itr->first, itr->second.itemid, uint64(itr->second.end));
+            cooldowns.AddRow("'%u', '%u', '%u', '" I64FMTD "'", GetGUIDLow(), itr->first, itr->second.itemid, uint64(itr->second.end));
             ++itr;
         }
     }
+
+    cooldowns.Execute();
 }
 
 uint32 Player::resetTalentsCost() const
@@ -3425,6 +3467,9 @@ void Player::DeleteFromDB(uint64 playerguid, uint32 accountId, bool updateRealmC
 {
     uint32 guid = GUID_LOPART(playerguid);
 
+    // also friend lists of other characters and mails to senders of returned mails are changed
+    sCharacterSnapshotCache.Clear();
+
     // convert corpse to bones if exist (to prevent exiting Corpse in World without DB entry)
     // bones will be deleted by corpse/bones deleting thread shortly
     ObjectAccessor::Instance().ConvertCorpseForPlayer(playerguid);
@@ -3631,6 +3676,7 @@ void Player::BuildPlayerRepop()
     StopMirrorTimers();                                     //disable timers(bars)
 
     SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, (float)1.0);   //see radius of death player?
+    UpdateSpatialIndex();
 
     SetByteValue(UNIT_FIELD_BYTES_1, 3, PLAYER_STATE_FLAG_ALWAYS_STAND);
 }
@@ -5157,7 +5203,7 @@ bool Player::SetPosition(float x, float y, float z, float orientation, bool tele
             RemoveAurasWithInterruptFlags(AURA_INTERRUPT_FLAG_TURNING);
 
         // move and update visible state if need
-        m->PlayerRelocation(this, x, y, z, orientation);
+        m->PlayerRelocation(this, x, y, z, orientation, teleport);
 
         // reread after Map::Relocation
         m = MapManager::Instance().GetMap(GetMapId(), this);
@@ -13199,7 +13245,7 @@ bool Player::MinimalLoadFromDB( QueryResult *result, uint32 guid )
 
     Field *fields = result->Fetch();
 
-    if(!LoadValues( fields[0].GetString()))
+    if(!LoadValues(fields[0]))
     {
         sLog.outError("ERROR: Player #%d have broken data in `data` field. Can't be loaded.",GUID_LOPART(guid));
         if(delete_result) delete result;
@@ -13279,7 +13325,7 @@ bool Player::LoadValuesArrayFromDB(Tokens& data, uint64 guid)
 
     Field *fields = result->Fetch();
 
-    data = StrSplit(fields[0].GetCppString(), " ");
+    data = StrSplit(UpdateFieldsStorage::ToText(fields[0]), " ");
 
     delete result;
 
@@ -13358,7 +13404,7 @@ bool Player::LoadFromDB( uint32 guid, SqlQueryHolder *holder )
         return false;
     }
 
-    if(!LoadValues( fields[2].GetString()))
+    if(!LoadValues(fields[2]))
     {
         sLog.outError("ERROR: Player #%d have broken data in `data` field. Can't be loaded.",GUID_LOPART(guid));
         delete result;
@@ -14671,6 +14717,8 @@ void Player::ConvertInstancesToGroup(Player *player, Group *group, uint64 player
     if(!player || !group || has_binds) CharacterDatabase.PExecute("INSERT INTO group_instance SELECT guid, instance, permanent FROM character_instance WHERE guid = '%u'", GUID_LOPART(player_guid));
     // the following should not get executed when changing leaders
     if(!player || has_solo) CharacterDatabase.PExecute("DELETE FROM character_instance WHERE guid = '%d' AND permanent = 0", GUID_LOPART(player_guid));
+    // the binds of an offline character were changed in DB only, drop its cached login data
+    if(!player) sCharacterSnapshotCache.Invalidate(GUID_LOPART(player_guid));
 }
 
 bool Player::_LoadHomeBind(QueryResult *result)
@@ -14725,6 +14773,7 @@ void Player::SaveToDB()
 {
     // delay auto save at any saves (manual, in code, or autosave)
     m_nextSave = sWorld.getConfig(CONFIG_INTERVAL_SAVE);
+    m_saveDeferTime = 0;
 
     // first save/honor gain after midnight will also update the player's honor fields
     UpdateHonorFields();
@@ -14757,23 +14806,17 @@ void Player::SaveToDB()
 
     CharacterDatabase.BeginTransaction();
 
-    CharacterDatabase.PExecute("DELETE FROM characters WHERE guid = '%u'",GetGUIDLow());
+    static SqlStatementID delChar;
+    static SqlStatementID insChar;
 
-    std::string sql_name = m_name;
-    CharacterDatabase.escape_string(sql_name);
+    CharacterDatabase.PreparedExecute(delChar, "DELETE FROM characters WHERE guid = ?", SqlStmtParameters() << GetGUIDLow());
 
-    std::ostringstream ss;
-    ss << "INSERT INTO characters (guid,account,name,race,class,"
-        "map, dungeon_difficulty, position_x, position_y, position_z, orientation, data, "
-        "taximask, online, cinematic, "
-        "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost, resettalents_time, "
-        "trans_x, trans_y, trans_z, trans_o, transguid, gmstate, stable_slots, at_login, zone, "
-        "death_expire_time, taxi_path) VALUES ("
-        << GetGUIDLow() << ", "
-        << GetSession()->GetAccountId() << ", '"
-        << sql_name << "', "
-        << m_race << ", "
-        << m_class << ", ";
+    SqlStmtParameters params;
+    params << GetGUIDLow()
+        << GetSession()->GetAccountId()
+        << m_name
+        << m_race
+        << m_class;
 
     bool save_to_dest = false;
     if(IsBeingTeleported())
@@ -14786,90 +14829,57 @@ void Player::SaveToDB()
 
     if(!save_to_dest)
     {
-        ss << GetMapId() << ", "
-        << (uint32)GetDifficulty() << ", "
-        << finiteAlways(GetPositionX()) << ", "
-        << finiteAlways(GetPositionY()) << ", "
-        << finiteAlways(GetPositionZ()) << ", "
-        << finiteAlways(GetOrientation()) << ", '";
+        params << GetMapId()
+            << (uint32)GetDifficulty()
+            << finiteAlways(GetPositionX())
+            << finiteAlways(GetPositionY())
+            << finiteAlways(GetPositionZ())
+            << finiteAlways(GetOrientation());
     }
     else
     {
-        ss << GetTeleportDest().mapid << ", "
-        << (uint32)GetDifficulty() << ", "
-        << finiteAlways(GetTeleportDest().x) << ", "
-        << finiteAlways(GetTeleportDest().y) << ", "
-        << finiteAlways(GetTeleportDest().z) << ", "
-        << finiteAlways(GetTeleportDest().o) << ", '";
-    }
-
-    uint16 i;
-    for( i = 0; i < m_valuesCount; i++ )
-    {
-        ss << GetUInt32Value(i) << " ";
-    }
-
-    ss << "', '";
-
-    for( i = 0; i < 8; i++ )
-        ss << m_taxi.GetTaximask(i) << " ";
-
-    ss << "', ";
-    ss << (inworld ? 1 : 0);
-
-    ss << ", ";
-    ss << m_cinematic;
-
-    ss << ", ";
-    ss << m_Played_time[0];
-    ss << ", ";
-    ss << m_Played_time[1];
-
-    ss << ", ";
-    ss << finiteAlways(m_rest_bonus);
-    ss << ", ";
-    ss << (uint64)time(NULL);
-    ss << ", ";
-    ss << is_save_resting;
-    ss << ", ";
-    ss << m_resetTalentsCost;
-    ss << ", ";
-    ss << (uint64)m_resetTalentsTime;
-
-    ss << ", ";
-    ss << finiteAlways(m_movementInfo.t_x);
-    ss << ", ";
-    ss << finiteAlways(m_movementInfo.t_y);
-    ss << ", ";
-    ss << finiteAlways(m_movementInfo.t_z);
-    ss << ", ";
-    ss << finiteAlways(m_movementInfo.t_o);
-    ss << ", ";
-    if (m_transport)
-        ss << m_transport->GetGUIDLow();
-    else
-        ss << "0";
-
-    ss << ", ";
-    ss << m_ExtraFlags;
-
-    ss << ", ";
-    ss << uint32(m_stableSlots);                            // to prevent save uint8 as char
-
-    ss << ", ";
-    ss << uint32(m_atLoginFlags);
-
-    ss << ", ";
-    ss << GetZoneId();
-
-    ss << ", ";
-    ss << (uint64)m_deathExpireTime;
-
-    ss << ", '";
-    ss << m_taxi.SaveTaxiDestinationsToString();
-    ss << "' )";
-
-    CharacterDatabase.Execute( ss.str().c_str() );
+        params << GetTeleportDest().mapid
+            << (uint32)GetDifficulty()
+            << finiteAlways(GetTeleportDest().x)
+            << finiteAlways(GetTeleportDest().y)
+            << finiteAlways(GetTeleportDest().z)
+            << finiteAlways(GetTeleportDest().o);
+    }
+
+    UpdateFieldsStorage::Write(params, m_uint32Values, m_valuesCount);
+
+    std::ostringstream taximask;
+    for(uint16 i = 0; i < 8; i++ )
+        taximask << m_taxi.GetTaximask(i) << " ";
+
+    params << taximask.str()
+        << uint32(inworld ? 1 : 0)
+        << m_cinematic
+        << m_Played_time[0]
+        << m_Played_time[1]
+        << finiteAlways(m_rest_bonus)
+        << (uint64)time(NULL)
+        << is_save_resting
+        << m_resetTalentsCost
+        << (uint64)m_resetTalentsTime
+        << finiteAlways(m_movementInfo.t_x)
+        << finiteAlways(m_movementInfo.t_y)
+        << finiteAlways(m_movementInfo.t_z)
+        << finiteAlways(m_movementInfo.t_o)
+        << uint32(m_transport ? m_transport->GetGUIDLow() : 0)
+        << m_ExtraFlags
+        << uint32(m_stableSlots)
+        << uint32(m_atLoginFlags)
+        << GetZoneId()
+        << (uint64)m_deathExpireTime
+        << m_taxi.SaveTaxiDestinationsToString();
+
+    CharacterDatabase.PreparedExecute(insChar, "INSERT INTO characters (guid,account,name,race,class,"
+        "map, dungeon_difficulty, position_x, position_y, position_z, orientation, data, "
+        "taximask, online, cinematic, "
+        "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost, resettalents_time, "
+        "trans_x, trans_y, trans_z, trans_o, transguid, gmstate, stable_slots, at_login, zone, "
+        "death_expire_time, taxi_path) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)", params);
 
     if(m_mailsUpdated)                                      //save mails only when needed
         _SaveMail();
@@ -14884,6 +14894,8 @@ void Player::SaveToDB()
     _SaveAuras();
     _SaveReputation();
 
+    sLog.outDebug("Player %s (GUID: %u) saved by %u statements", m_name.c_str(), GetGUIDLow(), uint32(CharacterDatabase.GetTransactionSize()));
+
     CharacterDatabase.CommitTransaction();
 
     // restore state (before aura apply, if aura remove flag then aura must set it ack by self)
@@ -14907,24 +14919,25 @@ void Player::SaveInventoryAndGoldToDB()
 
 void Player::_SaveActions()
 {
+    // changed buttons are deleted and inserted again, so all rows are written by two statements
+    SqlDeleteBatch deleted(CharacterDatabase, "DELETE FROM character_action WHERE guid = '%u' AND button IN ", GetGUIDLow());
+    SqlInsertBatch inserted(CharacterDatabase, "INSERT INTO character_action (guid,button,action,type,misc) VALUES ", &deleted);
+
     for(ActionButtonList::iterator itr = m_actionButtons.begin(); itr != m_actionButtons.end(); )
     {
         switch (itr->second.uState)
         {
+            case ACTIONBUTTON_CHANGED:
+                deleted.AddKey((uint32)itr->first);
+                // no break, insert changed button
             case ACTIONBUTTON_NEW:
-                CharacterDatabase.PExecute("INSERT INTO character_action (guid,button,action,type,misc) VALUES ('%u', '%u', '%u', '%u', '%u')",
+                inserted.AddRow("'%u', '%u', '%u', '%u', '%u'",
                     GetGUIDLow(), (uint32)itr->first, (uint32)itr->second.action, (uint32)itr->second.type, (uint32)itr->second.misc );
                 itr->second.uState = ACTIONBUTTON_UNCHANGED;
                 ++itr;
                 break;
-            case ACTIONBUTTON_CHANGED:
-                CharacterDatabase.PExecute("UPDATE character_action  SET action = '%u', type = '%u', misc= '%u' WHERE guid= '%u' AND button= '%u' ",
-                    (uint32)itr->second.action, (uint32)itr->second.type, (uint32)itr->second.misc, GetGUIDLow(), (uint32)itr->first );
-                itr->second.uState = ACTIONBUTTON_UNCHANGED;
-                ++itr;
-                break;
             case ACTIONBUTTON_DELETED:
-                CharacterDatabase.PExecute("DELETE FROM character_action WHERE guid = '%u' and button = '%u'", GetGUIDLow(), (uint32)itr->first );
+                deleted.AddKey((uint32)itr->first);
                 m_actionButtons.erase(itr++);
                 break;
             default:
@@ -14932,12 +14945,19 @@ void Player::_SaveActions()
                 break;
         };
     }
+
+    deleted.Execute();
+    inserted.Execute();
 }
 
 void Player::_SaveAuras()
 {
     CharacterDatabase.PExecute("DELETE FROM character_aura WHERE guid = '%u'",GetGUIDLow());
 
+    // auras of same spell effect from different casters have same DB key: save only last of them
+    typedef std::map<uint32, Aura*> SavedAuraMap;
+    SavedAuraMap saved;
+
     AuraMap const& auras = GetAuras();
     for(AuraMap::const_iterator itr = auras.begin(); itr != auras.end(); ++itr)
     {
@@ -14959,13 +14979,17 @@ void Player::_SaveAuras()
                 break;
 
         if (i == 3)
-        {
-            CharacterDatabase.PExecute("DELETE FROM character_aura WHERE guid = '%u' and spell = '%u' and  effect_index= '%u'",GetGUIDLow(),(uint32)(*itr).second->GetId(), (uint32)(*itr).second->GetEffIndex());
-            CharacterDatabase.PExecute("INSERT INTO character_aura (guid,caster_guid,spell,effect_index,amount,maxduration,remaintime,remaincharges) "
-                "VALUES ('%u', '" I64FMTD "' ,'%u', '%u', '%d', '%d', '%d', '%d')",
-                GetGUIDLow(), itr->second->GetCasterGUID(), (uint32)(*itr).second->GetId(), (uint32)(*itr).second->GetEffIndex(), (*itr).second->GetModifier()->m_amount,int((*itr).second->GetAuraMaxDuration()),int((*itr).second->GetAuraDuration()),int((*itr).second->m_procCharges));
-        }
+            saved[itr->second->GetId() << 2 | itr->second->GetEffIndex()] = itr->second;
+    }
+
+    SqlInsertBatch inserted(CharacterDatabase, "INSERT INTO character_aura (guid,caster_guid,spell,effect_index,amount,maxduration,remaintime,remaincharges) VALUES ");
+    for(SavedAuraMap::const_iterator itr = saved.begin(); itr != saved.end(); ++itr)
+    {
+        Aura* aura = itr->second;
+        inserted.AddRow("'%u', '" I64FMTD "' ,'%u', '%u', '%d', '%d', '%d', '%d'",
+            GetGUIDLow(), aura->GetCasterGUID(), (uint32)aura->GetId(), (uint32)aura->GetEffIndex(), aura->GetModifier()->m_amount,int(aura->GetAuraMaxDuration()),int(aura->GetAuraDuration()),int(aura->m_procCharges));
     }
+    inserted.Execute();
 }
 
 void Player::_SaveInventory()
@@ -15017,6 +15041,10 @@ void Player::_SaveInventory()
         return;
     }
 
+    // changed inventory records are deleted and inserted again, so all are written by two statements
+    SqlDeleteBatch deleted(CharacterDatabase, "DELETE FROM character_inventory WHERE item IN ");
+    SqlInsertBatch inserted(CharacterDatabase, "INSERT INTO character_inventory (guid,bag,slot,item,item_template) VALUES ", &deleted);
+
     for(size_t i = 0; i < m_itemUpdateQueue.size(); i++)
     {
         Item *item = m_itemUpdateQueue[i];
@@ -15027,14 +15055,14 @@ void Player::_SaveInventory()
 
         switch(item->GetState())
         {
-            case ITEM_NEW:
-                CharacterDatabase.PExecute("INSERT INTO character_inventory (guid,bag,slot,item,item_template) VALUES ('%u', '%u', '%u', '%u', '%u')", GetGUIDLow(), bag_guid, item->GetSlot(), item->GetGUIDLow(), item->GetEntry());
-                break;
             case ITEM_CHANGED:
-                CharacterDatabase.PExecute("UPDATE character_inventory SET guid='%u', bag='%u', slot='%u', item_template='%u' WHERE item='%u'", GetGUIDLow(), bag_guid, item->GetSlot(), item->GetEntry(), item->GetGUIDLow());
+                deleted.AddKey(item->GetGUIDLow());
+                // no break, insert changed record
+            case ITEM_NEW:
+                inserted.AddRow("'%u', '%u', '%u', '%u', '%u'", GetGUIDLow(), bag_guid, item->GetSlot(), item->GetGUIDLow(), item->GetEntry());
                 break;
             case ITEM_REMOVED:
-                CharacterDatabase.PExecute("DELETE FROM character_inventory WHERE item = '%u'", item->GetGUIDLow());
+                deleted.AddKey(item->GetGUIDLow());
                 break;
             case ITEM_UNCHANGED:
                 break;
@@ -15043,6 +15071,9 @@ void Player::_SaveInventory()
         item->SaveToDB();                                   // item have unchanged inventory record and can be save standalone
     }
     m_itemUpdateQueue.clear();
+
+    deleted.Execute();
+    inserted.Execute();
 }
 
 void Player::_SaveMail()
@@ -15096,25 +15127,29 @@ void Player::_SaveMail()
 
 void Player::_SaveQuestStatus()
 {
-    // we don't need transactions here.
+    // changed quests are deleted and inserted again, so all rows are written by two statements
+    SqlDeleteBatch deleted(CharacterDatabase, "DELETE FROM character_queststatus WHERE guid = '%u' AND quest IN ", GetGUIDLow());
+    SqlInsertBatch inserted(CharacterDatabase, "INSERT INTO character_queststatus (guid,quest,status,rewarded,explored,timer,mobcount1,mobcount2,mobcount3,mobcount4,itemcount1,itemcount2,itemcount3,itemcount4) VALUES ", &deleted);
+
     for( QuestStatusMap::iterator i = mQuestStatus.begin( ); i != mQuestStatus.end( ); ++i )
     {
         switch (i->second.uState)
         {
+            case QUEST_CHANGED :
+                deleted.AddKey(i->first);
+                // no break, insert changed quest
             case QUEST_NEW :
-                CharacterDatabase.PExecute("INSERT INTO character_queststatus (guid,quest,status,rewarded,explored,timer,mobcount1,mobcount2,mobcount3,mobcount4,itemcount1,itemcount2,itemcount3,itemcount4) "
-                    "VALUES ('%u', '%u', '%u', '%u', '%u', '" I64FMTD "', '%u', '%u', '%u', '%u', '%u', '%u', '%u', '%u')",
+                inserted.AddRow("'%u', '%u', '%u', '%u', '%u', '" I64FMTD "', '%u', '%u', '%u', '%u', '%u', '%u', '%u', '%u'",
                     GetGUIDLow(), i->first, i->second.m_status, i->second.m_rewarded, i->second.m_explored, uint64(i->second.m_timer / 1000 + sWorld.GetGameTime()), i->second.m_creatureOrGOcount[0], i->second.m_creatureOrGOcount[1], i->second.m_creatureOrGOcount[2], i->second.m_creatureOrGOcount[3], i->second.m_itemcount[0], i->second.m_itemcount[1], i->second.m_itemcount[2], i->second.m_itemcount[3]);
                 break;
-            case QUEST_CHANGED :
-                CharacterDatabase.PExecute("UPDATE character_queststatus SET status = '%u',rewarded = '%u',explored = '%u',timer = '" I64FMTD "',mobcount1 = '%u',mobcount2 = '%u',mobcount3 = '%u',mobcount4 = '%u',itemcount1 = '%u',itemcount2 = '%u',itemcount3 = '%u',itemcount4 = '%u'  WHERE guid = '%u' AND quest = '%u' ",
-                    i->second.m_status, i->second.m_rewarded, i->second.m_explored, uint64(i->second.m_timer / 1000 + sWorld.GetGameTime()), i->second.m_creatureOrGOcount[0], i->second.m_creatureOrGOcount[1], i->second.m_creatureOrGOcount[2], i->second.m_creatureOrGOcount[3], i->second.m_itemcount[0], i->second.m_itemcount[1], i->second.m_itemcount[2], i->second.m_itemcount[3], GetGUIDLow(), i->first );
-                break;
             case QUEST_UNCHANGED:
                 break;
         };
         i->second.uState = QUEST_UNCHANGED;
     }
+
+    deleted.Execute();
+    inserted.Execute();
 }
 
 void Player::_SaveDailyQuestStatus()
@@ -15128,40 +15163,55 @@ void Player::_SaveDailyQuestStatus()
 
     // we don't need transactions here.
     CharacterDatabase.PExecute("DELETE FROM character_queststatus_daily WHERE guid = '%u'",GetGUIDLow());
+
+    SqlInsertBatch inserted(CharacterDatabase, "INSERT INTO character_queststatus_daily (guid,quest,time) VALUES ");
     for(uint32 quest_daily_idx = 0; quest_daily_idx < PLAYER_MAX_DAILY_QUESTS; ++quest_daily_idx)
         if(GetUInt32Value(PLAYER_FIELD_DAILY_QUESTS_1+quest_daily_idx))
-            CharacterDatabase.PExecute("INSERT INTO character_queststatus_daily (guid,quest,time) VALUES ('%u', '%u','" I64FMTD "')",
+            inserted.AddRow("'%u', '%u','" I64FMTD "'",
                 GetGUIDLow(), GetUInt32Value(PLAYER_FIELD_DAILY_QUESTS_1+quest_daily_idx),uint64(m_lastDailyQuestTime));
+    inserted.Execute();
 }
 
 void Player::_SaveReputation()
 {
+    SqlDeleteBatch deleted(CharacterDatabase, "DELETE FROM character_reputation WHERE guid = '%u' AND faction IN ", GetGUIDLow());
+    SqlInsertBatch inserted(CharacterDatabase, "INSERT INTO character_reputation (guid,faction,standing,flags) VALUES ", &deleted);
+
     for(FactionStateList::iterator itr = m_factions.begin(); itr != m_factions.end(); ++itr)
     {
         if (itr->second.Changed)
         {
-            CharacterDatabase.PExecute("DELETE FROM character_reputation WHERE guid = '%u' AND faction='%u'", GetGUIDLow(), itr->second.ID);
-            CharacterDatabase.PExecute("INSERT INTO character_reputation (guid,faction,standing,flags) VALUES ('%u', '%u', '%i', '%u')", GetGUIDLow(), itr->second.ID, itr->second.Standing, itr->second.Flags);
+            deleted.AddKey(itr->second.ID);
+            inserted.AddRow("'%u', '%u', '%i', '%u'", GetGUIDLow(), itr->second.ID, itr->second.Standing, itr->second.Flags);
             itr->second.Changed = false;
         }
     }
+
+    deleted.Execute();
+    inserted.Execute();
 }
 
 void Player::_SaveSpells()
 {
+    SqlDeleteBatch deleted(CharacterDatabase, "DELETE FROM character_spell WHERE guid = '%u' AND spell IN ", GetGUIDLow());
+    SqlInsertBatch inserted(CharacterDatabase, "INSERT INTO character_spell (guid,spell,slot,active,disabled) VALUES ", &deleted);
+
     for (PlayerSpellMap::const_iterator itr = m_spells.begin(), next = m_spells.begin(); itr != m_spells.end(); itr = next)
     {
         ++next;
         if (itr->second->state == PLAYERSPELL_REMOVED || itr->second->state == PLAYERSPELL_CHANGED)
-            CharacterDatabase.PExecute("DELETE FROM character_spell WHERE guid = '%u' and spell = '%u'", GetGUIDLow(), itr->first);
+            deleted.AddKey(itr->first);
         if (itr->second->state == PLAYERSPELL_NEW || itr->second->state == PLAYERSPELL_CHANGED)
-            CharacterDatabase.PExecute("INSERT INTO character_spell (guid,spell,slot,active,disabled) VALUES ('%u', '%u', '%u','%u','%u')", GetGUIDLow(), itr->first, itr->second->slotId,itr->second->active ? 1 : 0,itr->second->disabled ? 1 : 0);
+            inserted.AddRow("'%u', '%u', '%u','%u','%u'", GetGUIDLow(), itr->first, itr->second->slotId,itr->second->active ? 1 : 0,itr->second->disabled ? 1 : 0);
 
         if (itr->second->state == PLAYERSPELL_REMOVED)
             _removeSpell(itr->first);
         else
             itr->second->state = PLAYERSPELL_UNCHANGED;
     }
+
+    deleted.Execute();
+    inserted.Execute();
 }
 
 void Player::_SaveTutorials()
@@ -15188,6 +15238,9 @@ void Player::_SaveTutorials()
         CharacterDatabase.PExecute("INSERT INTO character_tutorial (account,realmid,tut0,tut1,tut2,tut3,tut4,tut5,tut6,tut7) VALUES ('%u', '%u', '%u', '%u', '%u', '%u', '%u', '%u', '%u', '%u')", GetSession()->GetAccountId(), realmID, m_Tutorials[0], m_Tutorials[1], m_Tutorials[2], m_Tutorials[3], m_Tutorials[4], m_Tutorials[5], m_Tutorials[6], m_Tutorials[7]);
     };
 
+    // tutorials are common for all characters of account
+    sCharacterSnapshotCache.InvalidateAccount(GetSession()->GetAccountId());
+
     m_TutorialsChanged = false;
 }
 
@@ -15268,19 +15321,24 @@ void Player::SavePositionInDB(uint32 mapid, float x,float y,float z,float o,uint
         << "transguid='0',taxi_path='' WHERE guid='"<< GUID_LOPART(guid) <<"'";
     sLog.outDebug(ss.str().c_str());
     CharacterDatabase.Execute(ss.str().c_str());
+    sCharacterSnapshotCache.Invalidate(GUID_LOPART(guid));
 }
 
 bool Player::SaveValuesArrayInDB(Tokens const& tokens, uint64 guid)
 {
+    if(tokens.empty())
+        return false;
+
+    std::vector<uint32> values(tokens.size());
+    for(size_t i = 0; i < tokens.size(); ++i)
+        values[i] = uint32(strtoul(tokens[i].c_str(), NULL, 10));
+
     std::ostringstream ss2;
-    ss2<<"UPDATE characters SET data='";
-    int i=0;
-    for (Tokens::const_iterator iter = tokens.begin(); iter != tokens.end(); ++iter, ++i)
-    {
-        ss2<<tokens[i]<<" ";
-    }
-    ss2<<"' WHERE guid='"<< GUID_LOPART(guid) <<"'";
+    ss2<<"UPDATE characters SET data=";
+    UpdateFieldsStorage::Write(ss2, &values[0], values.size());
+    ss2<<" WHERE guid='"<< GUID_LOPART(guid) <<"'";
 
+    sCharacterSnapshotCache.Invalidate(GUID_LOPART(guid));
     return CharacterDatabase.Execute(ss2.str().c_str());
 }
 
@@ -16656,6 +16714,7 @@ void Player::AddSpellCooldown(uint32 spellid, uint32 itemid, time_t end_time)
     sc.end = end_time;
     sc.itemid = itemid;
     m_spellCooldowns[spellid] = sc;
+    m_spellCooldownsChanged = true;
 }
 
 void Player::SendCooldownEvent(SpellEntry const *spellInfo)
@@ -16995,13 +17054,13 @@ void Player::UpdateVisibilityOf(WorldObject* target)
 }
 
 template<class T>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, T* target)
+inline void UpdateVisibilityOf_helper(Player::ClientGUIDs& s64, T* target)
 {
     s64.insert(target->GetGUID());
 }
 
 template<>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, GameObject* target)
+inline void UpdateVisibilityOf_helper(Player::ClientGUIDs& s64, GameObject* target)
 {
     if(!target->IsTransport())
         s64.insert(target->GetGUID());
@@ -32,6 +32,7 @@
 #include "WorldSession.h"
 #include "Pet.h"
 #include "Util.h"                                           // for Tokens typedef
+#include "GuidSet.h"
 
 #include<string>
 #include<vector>
@@ -1438,7 +1439,7 @@ class MANGOS_DLL_SPEC Player : public Unit
         void AddSpellCooldown(uint32 spell_id, uint32 itemid, time_t end_time);
         void SendCooldownEvent(SpellEntry const *spellInfo);
         void ProhibitSpellScholl(SpellSchoolMask idSchoolMask, uint32 unTimeMs );
-        void RemoveSpellCooldown(uint32 spell_id) { m_spellCooldowns.erase(spell_id); }
+        void RemoveSpellCooldown(uint32 spell_id) { if(m_spellCooldowns.erase(spell_id)) m_spellCooldownsChanged = true; }
         void RemoveArenaSpellCooldowns();
         void RemoveAllSpellCooldown();
         void _LoadSpellCooldowns(QueryResult *result);
@@ -1950,7 +1951,7 @@ class MANGOS_DLL_SPEC Player : public Unit
         float m_homebindZ;
 
         // currently visible objects at player client
-        typedef std::set<uint64> ClientGUIDs;
+        typedef GuidSet ClientGUIDs;
         ClientGUIDs m_clientGUIDs;
 
         bool HaveAtClient(WorldObject const* u) { return u==this || m_clientGUIDs.find(u->GetGUID())!=m_clientGUIDs.end(); }
@@ -1967,6 +1968,14 @@ class MANGOS_DLL_SPEC Player : public Unit
         uint32 m_DetectInvTimer;
         void HandleStealthedUnitsDetection();
 
+        // visibility and creature reactions at move, delayed to Map::UpdatePlayerMoveNotifies
+        bool   m_moveNotifyPending;
+        bool   m_moveNotifyForced;                          // not wait distance/time limits
+        float  m_moveNotifyX;                               // position and time of last done notify
+        float  m_moveNotifyY;
+        float  m_moveNotifyZ;
+        uint32 m_moveNotifyTime;
+
         uint8 m_forced_speed_changes[MAX_MOVE_TYPE];
 
         bool HasAtLoginFlag(AtLoginFlags f) const { return m_atLoginFlags & f; }
@@ -2126,6 +2135,7 @@ class MANGOS_DLL_SPEC Player : public Unit
         uint32 m_class;
         uint32 m_team;
         uint32 m_nextSave;
+        uint32 m_saveDeferTime;                             // autosave delay time summary since last save
         time_t m_speakTime;
         uint32 m_speakCount;
         uint32 m_dungeonDifficulty;
@@ -2152,6 +2162,7 @@ class MANGOS_DLL_SPEC Player : public Unit
         PlayerMails m_mail;
         PlayerSpellMap m_spells;
         SpellCooldowns m_spellCooldowns;
+        bool m_spellCooldownsChanged;                       // cooldowns in DB are outdated
 
         ActionButtonList m_actionButtons;
 
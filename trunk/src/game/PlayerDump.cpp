@@ -22,6 +22,8 @@
 #include "Database/SQLStorage.h"
 #include "UpdateFields.h"
 #include "ObjectMgr.h"
+#include "UpdateFieldsStorage.h"
+#include "CharacterSnapshotCache.h"
 
 // Character Dump tables
 #define DUMP_TABLE_COUNT 20
@@ -199,7 +201,8 @@ std::string CreateDumpString(char const* tableName, QueryResult *result)
         if (i == 0) ss << "'";
         else ss << ", '";
 
-        std::string s = fields[i].GetCppString();
+        // binary `data` values are dumped in text format, it's expected by loading code and portable
+        std::string s = UpdateFieldsStorage::ToText(fields[i]);
         CharacterDatabase.escape_string(s);
         ss << s;
 
@@ -249,7 +252,7 @@ void StoreGUID(QueryResult *result,uint32 field,std::set<uint32>& guids)
 void StoreGUID(QueryResult *result,uint32 data,uint32 field, std::set<uint32>& guids)
 {
     Field* fields = result->Fetch();
-    std::string dataStr = fields[data].GetCppString();
+    std::string dataStr = UpdateFieldsStorage::ToText(fields[data]);
     uint32 guid = atoi(gettoknth(dataStr, field).c_str());
     if(guid)
         guids.insert(guid);
@@ -593,6 +596,9 @@ bool PlayerDumpReader::LoadDump(std::string file, uint32 account, std::string na
 
     CharacterDatabase.CommitTransaction();
 
+    // all character data with this guid is replaced
+    sCharacterSnapshotCache.Invalidate(guid);
+
     objmgr.m_hiItemGuid += items.size();
     objmgr.m_mailid     += mails.size();
 
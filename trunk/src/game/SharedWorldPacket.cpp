@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "SharedWorldPacket.h"
+
+#include <ace/Message_Block.h>
+#include <ace/Lock_Adapter_T.h>
+#include <ace/Thread_Mutex.h>
+
+// body references are duplicated at the world thread and released at network threads
+static ACE_Lock_Adapter<ACE_Thread_Mutex> s_BodyRefLock;
+
+SharedWorldPacket::~SharedWorldPacket()
+{
+    if(m_body)
+        m_body->release();
+}
+
+ACE_Message_Block* SharedWorldPacket::DuplicateBody() const
+{
+    if(m_packet->empty())
+        return NULL;
+
+    if(!m_body)
+    {
+        m_body = new ACE_Message_Block(m_packet->size(), ACE_Message_Block::MB_DATA, 0, 0, 0, &s_BodyRefLock);
+        m_body->copy((char const*)m_packet->contents(), m_packet->size());
+    }
+
+    return m_body->duplicate();
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOSSERVER_SHAREDWORLDPACKET_H
+#define MANGOSSERVER_SHAREDWORLDPACKET_H
+
+#include "WorldPacket.h"
+
+class ACE_Message_Block;
+
+/// Packet sent unchanged to many players (broadcasts).
+/// The payload is copied once into a reference counted block at first send,
+/// every socket adds only its own encrypted header and keeps a reference to the body.
+class SharedWorldPacket
+{
+    public:
+        explicit SharedWorldPacket(WorldPacket const* packet) : m_packet(packet), m_body(NULL) {}
+        ~SharedWorldPacket();
+
+        WorldPacket const& GetPacket() const { return *m_packet; }
+
+        /// new reference to the packet payload (NULL for empty packets), must be release()d by caller
+        ACE_Message_Block* DuplicateBody() const;
+
+    private:
+        SharedWorldPacket(SharedWorldPacket const&);
+        SharedWorldPacket& operator=(SharedWorldPacket const&);
+
+        WorldPacket const* m_packet;
+        mutable ACE_Message_Block* m_body;
+};
+#endif
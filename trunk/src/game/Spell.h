@@ -592,83 +592,91 @@ namespace MaNGOS
         }
 
         template<class T> inline void Visit(GridRefManager<T>  &m)
+        {
+            for(typename GridRefManager<T>::iterator itr = m.begin(); itr != m.end(); ++itr)
+                Visit(itr->getSource());
+        }
+
+        // also called by UnitSpatialIndex::Visit
+        void Visit(Unit* target)
         {
             assert(i_data);
 
             if(!i_originalCaster)
                 return;
 
-            for(typename GridRefManager<T>::iterator itr = m.begin(); itr != m.end(); ++itr)
+            // position check first, it is cheap compared to faction checks
+            switch(i_push_type)
             {
-                if( !itr->getSource()->isAlive() || (itr->getSource()->GetTypeId() == TYPEID_PLAYER && ((Player*)itr->getSource())->isInFlight()))
-                    continue;
+                case PUSH_IN_FRONT:
+                    if(!i_spell.GetCaster()->isInFront(target, i_radius, 2*M_PI/3 ))
+                        return;
+                    break;
+                case PUSH_IN_BACK:
+                    if(!i_spell.GetCaster()->isInBack(target, i_radius, 2*M_PI/3 ))
+                        return;
+                    break;
+                case PUSH_SELF_CENTER:
+                    if(!i_spell.GetCaster()->IsWithinDistInMap(target, i_radius))
+                        return;
+                    break;
+                case PUSH_DEST_CENTER:
+                    if(target->GetDistance(i_spell.m_targets.m_destX, i_spell.m_targets.m_destY, i_spell.m_targets.m_destZ) >= i_radius)
+                        return;
+                    break;
+                case PUSH_TARGET_CENTER:
+                    if(!i_spell.m_targets.getUnitTarget()->IsWithinDistInMap(target, i_radius))
+                        return;
+                    break;
+                default: return;
+            }
+
+            if( !target->isAlive() || (target->GetTypeId() == TYPEID_PLAYER && ((Player*)target)->isInFlight()))
+                return;
 
-                switch (i_TargetType)
+            switch (i_TargetType)
+            {
+                case SPELL_TARGETS_HOSTILE:
+                    if (!target->isTargetableForAttack() || !i_originalCaster->IsHostileTo( target ))
+                        return;
+                    break;
+                case SPELL_TARGETS_NOT_FRIENDLY:
+                    if (!target->isTargetableForAttack() || i_originalCaster->IsFriendlyTo( target ))
+                        return;
+                    break;
+                case SPELL_TARGETS_NOT_HOSTILE:
+                    if (!target->isTargetableForAttack() || i_originalCaster->IsHostileTo( target ))
+                        return;
+                    break;
+                case SPELL_TARGETS_FRIENDLY:
+                    if (!target->isTargetableForAttack() || !i_originalCaster->IsFriendlyTo( target ))
+                        return;
+                    break;
+                case SPELL_TARGETS_AOE_DAMAGE:
                 {
-                    case SPELL_TARGETS_HOSTILE:
-                        if (!itr->getSource()->isTargetableForAttack() || !i_originalCaster->IsHostileTo( itr->getSource() ))
-                            continue;
-                        break;
-                    case SPELL_TARGETS_NOT_FRIENDLY:
-                        if (!itr->getSource()->isTargetableForAttack() || i_originalCaster->IsFriendlyTo( itr->getSource() ))
-                            continue;
-                        break;
-                    case SPELL_TARGETS_NOT_HOSTILE:
-                        if (!itr->getSource()->isTargetableForAttack() || i_originalCaster->IsHostileTo( itr->getSource() ))
-                            continue;
-                        break;
-                    case SPELL_TARGETS_FRIENDLY:
-                        if (!itr->getSource()->isTargetableForAttack() || !i_originalCaster->IsFriendlyTo( itr->getSource() ))
-                            continue;
-                        break;
-                    case SPELL_TARGETS_AOE_DAMAGE:
+                    if(target->GetTypeId()==TYPEID_UNIT && ((Creature*)target)->isTotem())
+                        return;
+                    if(!target->isTargetableForAttack())
+                        return;
+
+                    Unit* check = i_originalCaster->GetCharmerOrOwnerOrSelf();
+
+                    if( check->GetTypeId()==TYPEID_PLAYER )
                     {
-                        if(itr->getSource()->GetTypeId()==TYPEID_UNIT && ((Creature*)itr->getSource())->isTotem())
-                            continue;
-                        if(!itr->getSource()->isTargetableForAttack())
-                            continue;
-
-                        Unit* check = i_originalCaster->GetCharmerOrOwnerOrSelf();
-
-                        if( check->GetTypeId()==TYPEID_PLAYER )
-                        {
-                            if (check->IsFriendlyTo( itr->getSource() ))
-                                continue;
-                        }
-                        else
-                        {
-                            if (!check->IsHostileTo( itr->getSource() ))
-                                continue;
-                        }
+                        if (check->IsFriendlyTo( target ))
+                            return;
+                    }
+                    else
+                    {
+                        if (!check->IsHostileTo( target ))
+                            return;
                     }
-                    break;
-                    default: continue;
-                }
-
-                switch(i_push_type)
-                {
-                    case PUSH_IN_FRONT:
-                        if(i_spell.GetCaster()->isInFront((Unit*)(itr->getSource()), i_radius, 2*M_PI/3 ))
-                            i_data->push_back(itr->getSource());
-                        break;
-                    case PUSH_IN_BACK:
-                        if(i_spell.GetCaster()->isInBack((Unit*)(itr->getSource()), i_radius, 2*M_PI/3 ))
-                            i_data->push_back(itr->getSource());
-                        break;
-                    case PUSH_SELF_CENTER:
-                        if(i_spell.GetCaster()->IsWithinDistInMap((Unit*)(itr->getSource()), i_radius))
-                            i_data->push_back(itr->getSource());
-                        break;
-                    case PUSH_DEST_CENTER:
-                        if((itr->getSource()->GetDistance(i_spell.m_targets.m_destX, i_spell.m_targets.m_destY, i_spell.m_targets.m_destZ) < i_radius ))
-                            i_data->push_back(itr->getSource());
-                        break;
-                    case PUSH_TARGET_CENTER:
-                        if(i_spell.m_targets.getUnitTarget()->IsWithinDistInMap((Unit*)(itr->getSource()), i_radius))
-                            i_data->push_back(itr->getSource());
-                        break;
                 }
+                break;
+                default: return;
             }
+
+            i_data->push_back(target);
         }
 
         #ifdef WIN32
@@ -278,8 +278,9 @@ class MANGOS_DLL_SPEC Aura
 
         void TriggerSpell();
 
-        bool IsUpdated() { return m_updated; }
-        void SetUpdated(bool val) { m_updated = val; }
+        // position in target aura update list, valid only while Unit::_UpdateSpells
+        uint32 GetUpdateSlot() const { return m_updateSlot; }
+        void SetUpdateSlot(uint32 slot) { m_updateSlot = slot; }
         void SetRemoveMode(AuraRemoveMode mode) { m_removeMode = mode; }
 
         int32 m_procCharges;
@@ -324,9 +325,10 @@ class MANGOS_DLL_SPEC Aura
         bool m_isPersistent:1;
         bool m_isDeathPersist:1;
         bool m_isRemovedOnShapeLost:1;
-        bool m_updated:1;
         bool m_in_use:1;                                    // true while in Aura::ApplyModifier call
 
+        uint32 m_updateSlot;
+
         int32 m_periodicTimer;
         uint32 m_PeriodicEventId;
         DiminishingGroup m_AuraDRGroup;
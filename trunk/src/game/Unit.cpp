@@ -43,6 +43,7 @@
 #include "GridNotifiersImpl.h"
 #include "CellImpl.h"
 #include "Path.h"
+#include "VMapFactory.h"
 
 #include <math.h>
 
@@ -3146,52 +3147,42 @@ void Unit::_UpdateSpells( uint32 time )
         }
     }
 
-    // TODO: Find a better way to prevent crash when multiple auras are removed.
-    m_removedAuras = 0;
+    // auras are updated from list filled before update: several auras can be removed at one aura update,
+    // RemoveAura set them to NULL in list, and auras added at update are updated first time at next call
+    m_aurasUpdateList.clear();
     for (AuraMap::iterator i = m_Auras.begin(); i != m_Auras.end(); ++i)
-        if ((*i).second)
-            (*i).second->SetUpdated(false);
-
-    for (AuraMap::iterator i = m_Auras.begin(), next; i != m_Auras.end(); i = next)
     {
-        next = i;
-        ++next;
         if ((*i).second)
         {
-            // prevent double update
-            if ((*i).second->IsUpdated())
-                continue;
-            (*i).second->SetUpdated(true);
-            (*i).second->Update( time );
-            // several auras can be deleted due to update
-            if (m_removedAuras)
-            {
-                if (m_Auras.empty()) break;
-                next = m_Auras.begin();
-                m_removedAuras = 0;
-            }
+            (*i).second->SetUpdateSlot(m_aurasUpdateList.size());
+            m_aurasUpdateList.push_back((*i).second);
         }
     }
 
-    for (AuraMap::iterator i = m_Auras.begin(); i != m_Auras.end();)
+    for (size_t i = 0; i < m_aurasUpdateList.size(); ++i)
+        if (Aura* aura = m_aurasUpdateList[i])
+            aura->Update( time );
+
+    for (size_t i = 0; i < m_aurasUpdateList.size(); ++i)
     {
-        if ((*i).second)
+        Aura* aura = m_aurasUpdateList[i];
+        if (aura && !aura->GetAuraDuration() && !(aura->IsPermanent() || aura->IsPassive()))
         {
-            if ( !(*i).second->GetAuraDuration() && !((*i).second->IsPermanent() || ((*i).second->IsPassive())) )
-            {
-                RemoveAura(i);
-            }
-            else
+            AuraMap::iterator itr = m_Auras.lower_bound(spellEffectPair(aura->GetId(), aura->GetEffIndex()));
+            AuraMap::iterator end = m_Auras.upper_bound(spellEffectPair(aura->GetId(), aura->GetEffIndex()));
+            for (; itr != end; ++itr)
             {
-                ++i;
+                if (itr->second == aura)
+                {
+                    RemoveAura(itr);
+                    break;
+                }
             }
         }
-        else
-        {
-            ++i;
-        }
     }
 
+    m_aurasUpdateList.clear();
+
     if(!m_gameObj.empty())
     {
         std::list<GameObject*>::iterator ite1, dnext1;
@@ -4117,6 +4108,10 @@ void Unit::RemoveAura(AuraMap::iterator &i, AuraRemoveMode mode)
     m_Auras.erase(i);
     ++m_removedAuras;                                       // internal count used by unit update
 
+    // not update or access removed aura in current unit update
+    if (Aur->GetUpdateSlot() < m_aurasUpdateList.size() && m_aurasUpdateList[Aur->GetUpdateSlot()] == Aur)
+        m_aurasUpdateList[Aur->GetUpdateSlot()] = NULL;
+
     // Status unsummoned at aura remove
     Totem* statue = NULL;
     if(IsChanneledSpell(Aur->GetSpellProto()))
@@ -8710,7 +8705,7 @@ void Unit::SetVisibility(UnitVisibility x)
         Map *m = MapManager::Instance().GetMap(GetMapId(), this);
 
         if(GetTypeId()==TYPEID_PLAYER)
-            m->PlayerRelocation((Player*)this,GetPositionX(),GetPositionY(),GetPositionZ(),GetOrientation());
+            m->PlayerRelocation((Player*)this,GetPositionX(),GetPositionY(),GetPositionZ(),GetOrientation(),true);
         else
             m->CreatureRelocation((Creature*)this,GetPositionX(),GetPositionY(),GetPositionZ(),GetOrientation());
     }
@@ -9777,6 +9772,9 @@ void Unit::RemoveFromWorld()
         RemoveNotOwnSingleTargetAuras();
     }
 
+    if(m_spatialIndex)
+        m_spatialIndex->Remove(this);
+
     Object::RemoveFromWorld();
 }
 
@@ -10556,33 +10554,39 @@ void Unit::UpdateReactives( uint32 p_time )
 
 Unit* Unit::SelectNearbyTarget() const
 {
-    CellPair p(MaNGOS::ComputeCellPair(GetPositionX(), GetPositionY()));
-    Cell cell(p);
-    cell.data.Part.reserved = ALL_DISTRICT;
-    cell.SetNoCreate();
-
     std::list<Unit *> targets;
 
     {
         MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck u_check(this, this, ATTACK_DISTANCE);
         MaNGOS::UnitListSearcher<MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck> searcher(targets, u_check);
 
-        TypeContainerVisitor<MaNGOS::UnitListSearcher<MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck>, WorldTypeMapContainer > world_unit_searcher(searcher);
-        TypeContainerVisitor<MaNGOS::UnitListSearcher<MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck>, GridTypeMapContainer >  grid_unit_searcher(searcher);
-
-        CellLock<GridReadGuard> cell_lock(cell, p);
-        cell_lock->Visit(cell_lock, world_unit_searcher, *MapManager::Instance().GetMap(GetMapId(), this));
-        cell_lock->Visit(cell_lock, grid_unit_searcher, *MapManager::Instance().GetMap(GetMapId(), this));
+        GetMap()->GetUnitSpatialIndex().Visit(this, ATTACK_DISTANCE, searcher);
     }
 
     // remove current target
     if(getVictim())
         targets.remove(getVictim());
 
-    // remove not LoS targets
-    for(std::list<Unit *>::iterator tIter = targets.begin(); tIter != targets.end();)
+    // remove not LoS targets, all checked at once
+    if(targets.empty())
+        return NULL;
+
+    std::vector<float> positions;
+    positions.reserve(targets.size()*3);
+    for(std::list<Unit *>::const_iterator tIter = targets.begin(); tIter != targets.end(); ++tIter)
+    {
+        positions.push_back((*tIter)->GetPositionX());
+        positions.push_back((*tIter)->GetPositionY());
+        positions.push_back((*tIter)->GetPositionZ()+2.0f);
+    }
+
+    std::vector<bool> inLoS;
+    VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetMapId(), GetPositionX(), GetPositionY(), GetPositionZ()+2.0f, &positions[0], targets.size(), inLoS);
+
+    size_t idx = 0;
+    for(std::list<Unit *>::iterator tIter = targets.begin(); tIter != targets.end(); ++idx)
     {
-        if(!IsWithinLOSInMap(*tIter))
+        if(!inLoS[idx])
         {
             std::list<Unit *>::iterator tIter2 = tIter;
             ++tIter;
@@ -1292,6 +1292,7 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
         bool m_isSorted;
         uint32 m_transform;
         uint32 m_removedAuras;
+        std::vector<Aura*> m_aurasUpdateList;               // auras updated at _UpdateSpells call, removed ones set to NULL
 
         AuraList m_modAuras[TOTAL_AURAS];
         float m_auraModifiersGroup[UNIT_MOD_END][MODIFIER_TYPE_END];
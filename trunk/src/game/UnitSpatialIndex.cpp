@@ -0,0 +1,313 @@
+/* 
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "UnitSpatialIndex.h"
+#include "Unit.h"
+
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define UNITSPATIALINDEX_SSE
+#include <xmmintrin.h>
+#endif
+
+// arc borders are tested by cosine here and by angle in WorldObject::HasInArc, keep a bit more
+#define SPATIAL_CONE_TOLERANCE 0.01f
+
+uint32 UnitSpatialCell::Add(Unit* unit, float x, float y, float size, uint8 type)
+{
+    m_x.push_back(x);
+    m_y.push_back(y);
+    m_size.push_back(size);
+    m_type.push_back(type);
+    m_units.push_back(unit);
+    return m_units.size() - 1;
+}
+
+Unit* UnitSpatialCell::Erase(uint32 slot)
+{
+    size_t last = m_units.size() - 1;
+    Unit* moved = NULL;
+    if(slot != last)
+    {
+        m_x[slot] = m_x[last];
+        m_y[slot] = m_y[last];
+        m_size[slot] = m_size[last];
+        m_type[slot] = m_type[last];
+        m_units[slot] = moved = m_units[last];
+    }
+
+    m_x.pop_back();
+    m_y.pop_back();
+    m_size.pop_back();
+    m_type.pop_back();
+    m_units.pop_back();
+    return moved;
+}
+
+void UnitSpatialCell::FilterRadius(float x, float y, float radius, uint32 typeMask, UnitVector& result) const
+{
+    size_t count = m_units.size();
+    size_t i = 0;
+
+#ifdef UNITSPATIALINDEX_SSE
+    __m128 cx = _mm_set1_ps(x);
+    __m128 cy = _mm_set1_ps(y);
+    __m128 r = _mm_set1_ps(radius);
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(&m_x[i]), cx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(&m_y[i]), cy);
+        __m128 dist = _mm_add_ps(r, _mm_loadu_ps(&m_size[i]));
+        __m128 in = _mm_cmple_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dist, dist));
+
+        int mask = _mm_movemask_ps(in);
+        for(; mask; mask &= mask - 1)
+        {
+            size_t j = i + (mask & 1 ? 0 : mask & 2 ? 1 : mask & 4 ? 2 : 3);
+            if(m_type[j] & typeMask)
+                result.push_back(m_units[j]);
+        }
+    }
+#endif
+
+    for(; i < count; ++i)
+    {
+        float dx = m_x[i] - x;
+        float dy = m_y[i] - y;
+        float dist = radius + m_size[i];
+        if(dx*dx + dy*dy <= dist*dist && (m_type[i] & typeMask))
+            result.push_back(m_units[i]);
+    }
+}
+
+void UnitSpatialCell::FilterCone(float x, float y, float radius, float dir_x, float dir_y, float cos_half_arc, uint32 typeMask, UnitVector& result) const
+{
+    size_t first = result.size();
+    FilterRadius(x, y, radius, typeMask, result);
+
+    // candidates are in slot order, so the arrays are read forward again
+    size_t j = 0;
+    size_t kept = first;
+    for(size_t i = first; i < result.size(); ++i)
+    {
+        while(m_units[j] != result[i])
+            ++j;
+
+        float dx = m_x[j] - x;
+        float dy = m_y[j] - y;
+        float dot = dx*dir_x + dy*dir_y;
+        if(dot >= cos_half_arc * sqrt(dx*dx + dy*dy))
+            result[kept++] = result[i];
+    }
+    result.resize(kept);
+}
+
+void UnitSpatialCell::FilterRect(float x_min, float y_min, float x_max, float y_max, uint32 typeMask, UnitVector& result) const
+{
+    size_t count = m_units.size();
+    size_t i = 0;
+
+#ifdef UNITSPATIALINDEX_SSE
+    __m128 lx = _mm_set1_ps(x_min);
+    __m128 ly = _mm_set1_ps(y_min);
+    __m128 hx = _mm_set1_ps(x_max);
+    __m128 hy = _mm_set1_ps(y_max);
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128 ux = _mm_loadu_ps(&m_x[i]);
+        __m128 uy = _mm_loadu_ps(&m_y[i]);
+        __m128 size = _mm_loadu_ps(&m_size[i]);
+        __m128 in = _mm_and_ps(
+            _mm_and_ps(_mm_cmpge_ps(_mm_add_ps(ux, size), lx), _mm_cmple_ps(_mm_sub_ps(ux, size), hx)),
+            _mm_and_ps(_mm_cmpge_ps(_mm_add_ps(uy, size), ly), _mm_cmple_ps(_mm_sub_ps(uy, size), hy)));
+
+        int mask = _mm_movemask_ps(in);
+        for(; mask; mask &= mask - 1)
+        {
+            size_t j = i + (mask & 1 ? 0 : mask & 2 ? 1 : mask & 4 ? 2 : 3);
+            if(m_type[j] & typeMask)
+                result.push_back(m_units[j]);
+        }
+    }
+#endif
+
+    for(; i < count; ++i)
+    {
+        float size = m_size[i];
+        if(m_x[i] + size >= x_min && m_x[i] - size <= x_max &&
+            m_y[i] + size >= y_min && m_y[i] - size <= y_max && (m_type[i] & typeMask))
+            result.push_back(m_units[i]);
+    }
+}
+
+UnitSpatialIndex::~UnitSpatialIndex()
+{
+    // units must be removed from map before, but not leave them with a dangling index
+    for(CellMap::iterator itr = m_cells.begin(); itr != m_cells.end(); ++itr)
+    {
+        UnitSpatialCell const& cell = itr->second;
+        for(size_t i = 0; i < cell.size(); ++i)
+            ((WorldObject*)cell[i])->m_spatialIndex = NULL;
+    }
+}
+
+uint32 UnitSpatialIndex::GetCellKey(float x, float y)
+{
+    MaNGOS::NormalizeMapCoord(x);
+    MaNGOS::NormalizeMapCoord(y);
+    CellPair p = MaNGOS::ComputeCellPair(x, y);
+    return p.x_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP + p.y_coord;
+}
+
+void UnitSpatialIndex::GetCellRange(float x_min, float y_min, float x_max, float y_max, CellPair& begin, CellPair& end)
+{
+    MaNGOS::NormalizeMapCoord(x_min);
+    MaNGOS::NormalizeMapCoord(y_min);
+    MaNGOS::NormalizeMapCoord(x_max);
+    MaNGOS::NormalizeMapCoord(y_max);
+    begin = MaNGOS::ComputeCellPair(x_min, y_min);
+    end = MaNGOS::ComputeCellPair(x_max, y_max);
+}
+
+void UnitSpatialIndex::Add(Unit* unit)
+{
+    WorldObject* obj = unit;
+    if(obj->m_spatialIndex)
+    {
+        if(obj->m_spatialIndex == this)
+            return;
+        obj->m_spatialIndex->Remove(obj);
+    }
+
+    float size = obj->GetObjectSize();
+    if(size > m_maxSize)
+        m_maxSize = size;
+
+    uint8 type = obj->GetTypeId() == TYPEID_PLAYER ? SPATIAL_UNIT_PLAYER : SPATIAL_UNIT_CREATURE;
+    obj->m_spatialCell = GetCellKey(obj->GetPositionX(), obj->GetPositionY());
+    obj->m_spatialSlot = m_cells[obj->m_spatialCell].Add(unit, obj->GetPositionX(), obj->GetPositionY(), size, type);
+    obj->m_spatialIndex = this;
+    ++m_count;
+}
+
+void UnitSpatialIndex::Remove(WorldObject* obj)
+{
+    if(obj->m_spatialIndex != this)
+        return;
+
+    CellMap::iterator itr = m_cells.find(obj->m_spatialCell);
+    assert(itr != m_cells.end());
+    if(WorldObject* moved = itr->second.Erase(obj->m_spatialSlot))
+        moved->m_spatialSlot = obj->m_spatialSlot;
+
+    obj->m_spatialIndex = NULL;
+    --m_count;
+}
+
+void UnitSpatialIndex::Relocate(WorldObject* obj)
+{
+    assert(obj->m_spatialIndex == this);
+
+    float size = obj->GetObjectSize();
+    if(size > m_maxSize)
+        m_maxSize = size;
+
+    uint32 key = GetCellKey(obj->GetPositionX(), obj->GetPositionY());
+    if(key == obj->m_spatialCell)
+    {
+        m_cells[key].Update(obj->m_spatialSlot, obj->GetPositionX(), obj->GetPositionY(), size);
+        return;
+    }
+
+    CellMap::iterator itr = m_cells.find(obj->m_spatialCell);
+    assert(itr != m_cells.end());
+    if(WorldObject* moved = itr->second.Erase(obj->m_spatialSlot))
+        moved->m_spatialSlot = obj->m_spatialSlot;
+
+    uint8 type = obj->GetTypeId() == TYPEID_PLAYER ? SPATIAL_UNIT_PLAYER : SPATIAL_UNIT_CREATURE;
+    obj->m_spatialCell = key;
+    obj->m_spatialSlot = m_cells[key].Add((Unit*)obj, obj->GetPositionX(), obj->GetPositionY(), size, type);
+}
+
+void UnitSpatialIndex::QueryRadius(float x, float y, float radius, uint32 typeMask, UnitVector& result) const
+{
+    float margin = radius + m_maxSize;
+    CellPair begin, end;
+    GetCellRange(x - margin, y - margin, x + margin, y + margin, begin, end);
+
+    for(uint32 cx = begin.x_coord; cx <= end.x_coord; ++cx)
+    {
+        for(uint32 cy = begin.y_coord; cy <= end.y_coord; ++cy)
+        {
+            CellMap::const_iterator itr = m_cells.find(cx * TOTAL_NUMBER_OF_CELLS_PER_MAP + cy);
+            if(itr != m_cells.end())
+                itr->second.FilterRadius(x, y, radius, typeMask, result);
+        }
+    }
+}
+
+void UnitSpatialIndex::QueryCone(float x, float y, float radius, float orientation, float arc, uint32 typeMask, UnitVector& result) const
+{
+    // move arc to range 0.. 2*pi as WorldObject::HasInArc
+    while( arc >= 2.0f * M_PI )
+        arc -=  2.0f * M_PI;
+    while( arc < 0 )
+        arc +=  2.0f * M_PI;
+
+    float half_arc = arc / 2.0f + SPATIAL_CONE_TOLERANCE;
+    if(half_arc >= M_PI)
+    {
+        QueryRadius(x, y, radius, typeMask, result);
+        return;
+    }
+
+    float dir_x = cos(orientation);
+    float dir_y = sin(orientation);
+    float cos_half_arc = cos(half_arc);
+
+    float margin = radius + m_maxSize;
+    CellPair begin, end;
+    GetCellRange(x - margin, y - margin, x + margin, y + margin, begin, end);
+
+    for(uint32 cx = begin.x_coord; cx <= end.x_coord; ++cx)
+    {
+        for(uint32 cy = begin.y_coord; cy <= end.y_coord; ++cy)
+        {
+            CellMap::const_iterator itr = m_cells.find(cx * TOTAL_NUMBER_OF_CELLS_PER_MAP + cy);
+            if(itr != m_cells.end())
+                itr->second.FilterCone(x, y, radius, dir_x, dir_y, cos_half_arc, typeMask, result);
+        }
+    }
+}
+
+void UnitSpatialIndex::QueryRect(float x_min, float y_min, float x_max, float y_max, uint32 typeMask, UnitVector& result) const
+{
+    CellPair begin, end;
+    GetCellRange(x_min - m_maxSize, y_min - m_maxSize, x_max + m_maxSize, y_max + m_maxSize, begin, end);
+
+    for(uint32 cx = begin.x_coord; cx <= end.x_coord; ++cx)
+    {
+        for(uint32 cy = begin.y_coord; cy <= end.y_coord; ++cy)
+        {
+            CellMap::const_iterator itr = m_cells.find(cx * TOTAL_NUMBER_OF_CELLS_PER_MAP + cy);
+            if(itr != m_cells.end())
+                itr->second.FilterRect(x_min, y_min, x_max, y_max, typeMask, result);
+        }
+    }
+}
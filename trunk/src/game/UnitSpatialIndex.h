@@ -0,0 +1,122 @@
+/* 
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_UNITSPATIALINDEX_H
+#define MANGOS_UNITSPATIALINDEX_H
+
+#include "Common.h"
+#include "Object.h"
+#include "GridDefines.h"
+#include "Utilities/HashMap.h"
+
+class Unit;
+
+enum SpatialUnitType
+{
+    SPATIAL_UNIT_PLAYER     = 0x01,
+    SPATIAL_UNIT_CREATURE   = 0x02,
+    SPATIAL_UNIT_ANY        = SPATIAL_UNIT_PLAYER | SPATIAL_UNIT_CREATURE
+};
+
+/// Units of one map cell with positions, sizes and types in separate arrays, so distance
+/// filters read only a few floats per unit (4 units at once with SSE) and not the units.
+class MANGOS_DLL_DECL UnitSpatialCell
+{
+    public:
+        typedef std::vector<Unit*> UnitVector;
+
+        /// returns the slot of the unit
+        uint32 Add(Unit* unit, float x, float y, float size, uint8 type);
+        /// the last unit moves to the freed slot, returns it (NULL if the erased unit was the last)
+        Unit* Erase(uint32 slot);
+        void Update(uint32 slot, float x, float y, float size) { m_x[slot] = x; m_y[slot] = y; m_size[slot] = size; }
+
+        /// appends units with 2d distance of center to x,y not more than radius + unit size
+        void FilterRadius(float x, float y, float radius, uint32 typeMask, UnitVector& result) const;
+        /// FilterRadius units in arc (centered at direction dir_x,dir_y of length 1) as seen from x,y
+        void FilterCone(float x, float y, float radius, float dir_x, float dir_y, float cos_half_arc, uint32 typeMask, UnitVector& result) const;
+        /// appends units with center in the rectangle extended by unit size
+        void FilterRect(float x_min, float y_min, float x_max, float y_max, uint32 typeMask, UnitVector& result) const;
+
+        Unit* operator[](size_t slot) const { return m_units[slot]; }
+        bool empty() const { return m_units.empty(); }
+        size_t size() const { return m_units.size(); }
+
+    private:
+        std::vector<float> m_x;
+        std::vector<float> m_y;
+        std::vector<float> m_size;
+        std::vector<uint8> m_type;
+        std::vector<Unit*> m_units;
+};
+
+/// Players and creatures in a map, by map cell. Units are added with the map and the position
+/// is updated by WorldObject::Relocate, so the index is exact also for moves not reported to
+/// the map. Queries return candidates by 2d distance only, callers do the exact checks.
+class MANGOS_DLL_DECL UnitSpatialIndex
+{
+    public:
+        typedef UnitSpatialCell::UnitVector UnitVector;
+
+        UnitSpatialIndex() : m_maxSize(0.0f), m_count(0) {}
+        ~UnitSpatialIndex();
+
+        void Add(Unit* unit);
+        void Remove(WorldObject* obj);
+        void Relocate(WorldObject* obj);
+
+        /// units with center not farther than radius + unit size from x,y (radius must include searcher size)
+        void QueryRadius(float x, float y, float radius, uint32 typeMask, UnitVector& result) const;
+        /// QueryRadius units in arc (centered at orientation) as seen from x,y, see WorldObject::HasInArc
+        void QueryCone(float x, float y, float radius, float orientation, float arc, uint32 typeMask, UnitVector& result) const;
+        /// units crossing the rectangle
+        void QueryRect(float x_min, float y_min, float x_max, float y_max, uint32 typeMask, UnitVector& result) const;
+
+        /// calls notifier.Visit(Unit*) for QueryRadius units around obj (obj size added to radius)
+        template<class NOTIFIER>
+            void Visit(WorldObject const* obj, float radius, NOTIFIER& notifier, uint32 typeMask = SPATIAL_UNIT_ANY) const
+        {
+            Visit(obj->GetPositionX(), obj->GetPositionY(), radius + obj->GetObjectSize(), notifier, typeMask);
+        }
+
+        /// calls notifier.Visit(Unit*) for QueryRadius units
+        template<class NOTIFIER>
+            void Visit(float x, float y, float radius, NOTIFIER& notifier, uint32 typeMask = SPATIAL_UNIT_ANY) const
+        {
+            UnitVector units;
+            QueryRadius(x, y, radius, typeMask, units);
+            for(UnitVector::const_iterator itr = units.begin(); itr != units.end(); ++itr)
+                notifier.Visit(*itr);
+        }
+
+        size_t size() const { return m_count; }
+
+    private:
+        typedef HM_NAMESPACE::hash_map<uint32, UnitSpatialCell> CellMap;
+
+        static uint32 GetCellKey(float x, float y);
+        static void GetCellRange(float x_min, float y_min, float x_max, float y_max, CellPair& begin, CellPair& end);
+
+        UnitSpatialIndex(const UnitSpatialIndex&);
+        UnitSpatialIndex& operator=(const UnitSpatialIndex&);
+
+        CellMap m_cells;
+        float m_maxSize;                                    // largest unit size since creation, margin for cells crossing a search area
+        size_t m_count;
+};
+#endif
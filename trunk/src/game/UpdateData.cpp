@@ -24,86 +24,185 @@
 #include "Opcodes.h"
 #include "World.h"
 #include <zlib/zlib.h>
+#include <ace/TSS_T.h>
+#include <ace/High_Res_Timer.h>
 
-UpdateData::UpdateData() : m_blockCount(0)
-{
-}
+/// Number of compressed packets between compression stats log lines (per thread)
+#define UPDATE_COMPRESS_STATS_PACKETS 10000
 
-void UpdateData::AddOutOfRangeGUID(std::set<uint64>& guids)
+/// Deflate stream and scratch buffer owned by one thread.
+/// The stream is reset for every packet instead of initialized again.
+class UpdatePacketCompressor
 {
-    m_outOfRangeGUIDs.insert(guids.begin(),guids.end());
-}
+    public:
+        UpdatePacketCompressor();
+        ~UpdatePacketCompressor();
 
-void UpdateData::AddOutOfRangeGUID(const uint64 &guid)
+        /// returns compressed size, 0 at error
+        uint32 Compress(void* dst, uint32 dst_size, void const* src, uint32 src_size, int level);
+
+        /// buffer to serialize update data before compression
+        ByteBuffer& GetScratch() { return m_scratch; }
+
+    private:
+        void UpdateStats(uint32 src_size, uint32 dst_size, ACE_hrtime_t usec);
+
+        z_stream m_stream;
+        bool m_initialized;
+        int m_level;
+
+        ByteBuffer m_scratch;
+
+        uint32 m_statPackets;
+        uint64 m_statRawBytes;
+        uint64 m_statCompressedBytes;
+        uint64 m_statTime;                                  // in microseconds
+};
+
+UpdatePacketCompressor::UpdatePacketCompressor() : m_initialized(false), m_level(0),
+    m_statPackets(0), m_statRawBytes(0), m_statCompressedBytes(0), m_statTime(0)
 {
-    m_outOfRangeGUIDs.insert(guid);
+    memset(&m_stream, 0, sizeof(m_stream));
 }
 
-void UpdateData::AddUpdateBlock(const ByteBuffer &block)
+UpdatePacketCompressor::~UpdatePacketCompressor()
 {
-    m_data.append(block);
-    ++m_blockCount;
+    if (m_initialized)
+        deflateEnd(&m_stream);
 }
 
-void UpdateData::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
+uint32 UpdatePacketCompressor::Compress(void* dst, uint32 dst_size, void const* src, uint32 src_size, int level)
 {
-    z_stream c_stream;
+    ACE_High_Res_Timer timer;
+    timer.start();
 
-    c_stream.zalloc = (alloc_func)0;
-    c_stream.zfree = (free_func)0;
-    c_stream.opaque = (voidpf)0;
+    int z_res;
 
-    // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld.getConfig(CONFIG_COMPRESSION));
-    if (z_res != Z_OK)
+    if (!m_initialized)
     {
-        sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)",z_res,zError(z_res));
-        *dst_size = 0;
-        return;
+        z_res = deflateInit(&m_stream, level);
+        if (z_res != Z_OK)
+        {
+            sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)",z_res,zError(z_res));
+            return 0;
+        }
+
+        m_initialized = true;
+        m_level = level;
     }
+    else
+    {
+        z_res = deflateReset(&m_stream);
+        if (z_res != Z_OK)
+        {
+            sLog.outError("Can't compress update packet (zlib: deflateReset) Error code: %i (%s)",z_res,zError(z_res));
+            return 0;
+        }
 
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
+        // no data was deflated since reset, so changing params is a cheap call
+        if (m_level != level)
+        {
+            z_res = deflateParams(&m_stream, level, Z_DEFAULT_STRATEGY);
+            if (z_res != Z_OK)
+            {
+                sLog.outError("Can't compress update packet (zlib: deflateParams) Error code: %i (%s)",z_res,zError(z_res));
+                return 0;
+            }
 
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)",z_res,zError(z_res));
-        *dst_size = 0;
-        return;
+            m_level = level;
+        }
     }
 
-    if (c_stream.avail_in != 0)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflate not greedy)");
-        *dst_size = 0;
-        return;
-    }
+    m_stream.next_out = (Bytef*)dst;
+    m_stream.avail_out = dst_size;
+    m_stream.next_in = (Bytef*)src;
+    m_stream.avail_in = (uInt)src_size;
 
-    z_res = deflate(&c_stream, Z_FINISH);
+    // all input is available, so compress it in one call
+    z_res = deflate(&m_stream, Z_FINISH);
     if (z_res != Z_STREAM_END)
     {
         sLog.outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)",z_res,zError(z_res));
-        *dst_size = 0;
-        return;
+        return 0;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)",z_res,zError(z_res));
-        *dst_size = 0;
+    timer.stop();
+
+    ACE_hrtime_t usec;
+    timer.elapsed_microseconds(usec);
+
+    UpdateStats(src_size, m_stream.total_out, usec);
+
+    return m_stream.total_out;
+}
+
+void UpdatePacketCompressor::UpdateStats(uint32 src_size, uint32 dst_size, ACE_hrtime_t usec)
+{
+    ++m_statPackets;
+    m_statRawBytes += src_size;
+    m_statCompressedBytes += dst_size;
+    m_statTime += usec;
+
+    if (m_statPackets < UPDATE_COMPRESS_STATS_PACKETS)
         return;
-    }
 
-    *dst_size = c_stream.total_out;
+    uint64 saved = m_statRawBytes > m_statCompressedBytes ? m_statRawBytes - m_statCompressedBytes : 0;
+
+    sLog.outDetail("Update packet compression: %u packets, " I64FMTD " -> " I64FMTD " bytes in " I64FMTD " us, %.2f bytes saved/us",
+        m_statPackets, m_statRawBytes, m_statCompressedBytes, m_statTime,
+        m_statTime ? double(saved) / double(m_statTime) : 0.0);
+
+    m_statPackets = 0;
+    m_statRawBytes = 0;
+    m_statCompressedBytes = 0;
+    m_statTime = 0;
 }
 
-bool UpdateData::BuildPacket(WorldPacket *packet, bool hasTransport)
+/// Update packets are built at map update threads, every one uses own compressor
+static ACE_TSS<UpdatePacketCompressor> s_compressor;
+
+
+UpdateData::UpdateData() : m_blockCount(0)
 {
-    ByteBuffer buf(m_data.size() + 10 + m_outOfRangeGUIDs.size()*8);
+}
+
+void UpdateData::AddOutOfRangeGUID(GuidSet const& guids)
+{
+    if(m_outOfRangeGUIDs.empty())
+        m_outOfRangeGUIDs = guids;
+    else
+        m_outOfRangeGUIDs.insert(guids.begin(),guids.end());
+}
+
+void UpdateData::AddOutOfRangeGUID(const uint64 &guid)
+{
+    m_outOfRangeGUIDs.insert(guid);
+}
+
+void UpdateData::AddUpdateBlock(const ByteBuffer &block)
+{
+    m_data.append(block);
+    ++m_blockCount;
+}
+
+int UpdateData::GetCompressionLevel(size_t size)
+{
+    // small updates are not worth the deflate call
+    if (size <= sWorld.getConfig(CONFIG_COMPRESSION_MIN_SIZE))
+        return 0;
+
+    // big create bursts (login, teleport) cost the most CPU time at high levels
+    uint32 fastSize = sWorld.getConfig(CONFIG_COMPRESSION_FAST_SIZE);
+    if (fastSize && size >= fastSize)
+        return Z_BEST_SPEED;
+
+    // default Z_BEST_SPEED (1)
+    return sWorld.getConfig(CONFIG_COMPRESSION);
+}
+
+void UpdateData::BuildUpdateBlocks(ByteBuffer& buf, bool hasTransport)
+{
+    buf.reserve(m_data.size() + 10 + m_outOfRangeGUIDs.size()*9);
 
     buf << (uint32) (!m_outOfRangeGUIDs.empty() ? m_blockCount + 1 : m_blockCount);
     buf << (uint8) (hasTransport ? 1 : 0);
@@ -113,7 +212,7 @@ bool UpdateData::BuildPacket(WorldPacket *packet, bool hasTransport)
         buf << (uint8) UPDATETYPE_OUT_OF_RANGE_OBJECTS;
         buf << (uint32) m_outOfRangeGUIDs.size();
 
-        for(std::set<uint64>::const_iterator i = m_outOfRangeGUIDs.begin();
+        for(GuidSet::const_iterator i = m_outOfRangeGUIDs.begin();
             i != m_outOfRangeGUIDs.end(); i++)
         {
             //buf.appendPackGUID(*i);
@@ -123,32 +222,55 @@ bool UpdateData::BuildPacket(WorldPacket *packet, bool hasTransport)
     }
 
     buf.append(m_data);
+}
 
+bool UpdateData::BuildPacket(WorldPacket *packet, bool hasTransport)
+{
     packet->clear();
 
-    if (m_data.size() > 50 )
+    int level = GetCompressionLevel(m_data.size());
+
+    if (!level)
     {
-        uint32 destsize = buf.size() + buf.size()/10 + 16;
-        packet->resize( destsize );
+        BuildUpdateBlocks(*packet, hasTransport);
+        packet->SetOpcode( SMSG_UPDATE_OBJECT );
+        return true;
+    }
 
-        packet->put(0, (uint32)buf.size());
+    UpdatePacketCompressor* compressor = s_compressor;
+    if (!compressor)
+        return false;
 
-        Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32),
-            &destsize,
-            (void*)buf.contents(),
-            buf.size());
-        if (destsize == 0)
-            return false;
+    // scratch buffer keeps its storage between packets
+    ByteBuffer& buf = compressor->GetScratch();
+    buf.clear();
+    BuildUpdateBlocks(buf, hasTransport);
 
-        packet->resize( destsize + sizeof(uint32) );
-        packet->SetOpcode( SMSG_COMPRESSED_UPDATE_OBJECT );
-    }
-    else
+    uint32 destsize = buf.size() + buf.size()/10 + 16;
+    packet->resize( destsize + sizeof(uint32) );
+
+    packet->put(0, (uint32)buf.size());
+
+    destsize = compressor->Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32),
+        destsize,
+        buf.contents(),
+        buf.size(),
+        level);
+    if (destsize == 0)
+        return false;
+
+    // incompressible data, send it as is
+    if (destsize + sizeof(uint32) >= buf.size())
     {
+        packet->clear();
         packet->append( buf );
         packet->SetOpcode( SMSG_UPDATE_OBJECT );
+        return true;
     }
 
+    packet->resize( destsize + sizeof(uint32) );
+    packet->SetOpcode( SMSG_COMPRESSED_UPDATE_OBJECT );
+
     return true;
 }
 
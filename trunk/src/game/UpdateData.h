@@ -19,6 +19,8 @@
 #ifndef __UPDATEDATA_H
 #define __UPDATEDATA_H
 
+#include "GuidSet.h"
+
 class WorldPacket;
 
 enum OBJECT_UPDATE_TYPE
@@ -48,20 +50,47 @@ class UpdateData
     public:
         UpdateData();
 
-        void AddOutOfRangeGUID(std::set<uint64>& guids);
+        void AddOutOfRangeGUID(GuidSet const& guids);
         void AddOutOfRangeGUID(const uint64 &guid);
         void AddUpdateBlock(const ByteBuffer &block);
         bool BuildPacket(WorldPacket *packet, bool hasTransport = false);
         bool HasData() { return m_blockCount > 0 || !m_outOfRangeGUIDs.empty(); }
         void Clear();
 
-        std::set<uint64> const& GetOutOfRangeGUIDs() const { return m_outOfRangeGUIDs; }
+        GuidSet const& GetOutOfRangeGUIDs() const { return m_outOfRangeGUIDs; }
 
     protected:
         uint32 m_blockCount;
-        std::set<uint64> m_outOfRangeGUIDs;
+        GuidSet m_outOfRangeGUIDs;
         ByteBuffer m_data;
 
-        void Compress(void* dst, uint32 *dst_size, void* src, int src_size);
+        void BuildUpdateBlocks(ByteBuffer& buf, bool hasTransport);
+
+        /// zlib level for update data of this size, 0 to send it uncompressed
+        static int GetCompressionLevel(size_t size);
+};
+
+/// Values update blocks of one object built in one update pass.
+/// Observers with the same view key (see Object::GetValuesUpdateViewKey) get the same block.
+class ValuesUpdateCache
+{
+    public:
+        ByteBuffer const* Find(uint8 key) const
+        {
+            for(Blocks::const_iterator itr = m_blocks.begin(); itr != m_blocks.end(); ++itr)
+                if(itr->first == key)
+                    return &itr->second;
+            return NULL;
+        }
+
+        ByteBuffer& Add(uint8 key)
+        {
+            m_blocks.push_back(std::pair<uint8, ByteBuffer>(key, ByteBuffer(500)));
+            return m_blocks.back().second;
+        }
+
+    private:
+        typedef std::list<std::pair<uint8, ByteBuffer> > Blocks;
+        Blocks m_blocks;
 };
 #endif
@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "UpdateFieldsStorage.h"
+#include "Database/DatabaseEnv.h"
+#include "World.h"
+#include "Utilities/ByteConverter.h"
+
+#define BINARY_MARKER        0x01
+#define BINARY_VERSION       1
+#define BINARY_HEADER_SIZE   4                              // marker, version, uint16 values count
+
+// rows selected at once by ConvertTable
+#define CONVERT_BATCH_SIZE   1000
+
+bool UpdateFieldsStorage::IsBinaryEnabled()
+{
+    #ifdef DO_POSTGRESQL
+    return false;                                           // hex literals are MySQL syntax
+    #else
+    return sWorld.getConfig(CONFIG_BINARY_VALUES_DATA);
+    #endif
+}
+
+bool UpdateFieldsStorage::IsBinarySupportedByDB()
+{
+    return CharacterDatabase.IsBlobColumn("characters", "data") && CharacterDatabase.IsBlobColumn("item_instance", "data");
+}
+
+bool UpdateFieldsStorage::IsBinary(Field const& data)
+{
+    char const* value = data.GetString();
+    return value && data.GetLength() >= BINARY_HEADER_SIZE &&
+        uint8(value[0]) == BINARY_MARKER && uint8(value[1]) == BINARY_VERSION;
+}
+
+uint32 UpdateFieldsStorage::GetCount(Field const& data)
+{
+    char const* value = data.GetString();
+    if(!value)
+        return 0;
+
+    if(IsBinary(data))
+    {
+        uint16 count;
+        memcpy(&count, value + 2, sizeof(count));
+        EndianConvert(count);
+        return count;
+    }
+
+    uint32 count = 0;
+    for(char const* c = value; *c; ++c)
+        if(*c != ' ' && (c == value || c[-1] == ' '))
+            ++count;
+
+    return count;
+}
+
+bool UpdateFieldsStorage::Read(Field const& data, uint32* values, uint32 count)
+{
+    char const* value = data.GetString();
+    if(!value)
+        return false;
+
+    if(IsBinary(data))
+    {
+        if(GetCount(data) != count || data.GetLength() != BINARY_HEADER_SIZE + count * sizeof(uint32))
+            return false;
+
+        memcpy(values, value + BINARY_HEADER_SIZE, count * sizeof(uint32));
+        for(uint32 i = 0; i < count; ++i)
+            EndianConvert(values[i]);
+        return true;
+    }
+
+    uint32 index = 0;
+    while(*value)
+    {
+        if(*value == ' ')
+        {
+            ++value;
+            continue;
+        }
+
+        if(index >= count)
+            return false;
+
+        values[index++] = uint32(strtoul(value, NULL, 10));
+
+        while(*value && *value != ' ')
+            ++value;
+    }
+
+    return index == count;
+}
+
+static std::string MakeText(uint32 const* values, uint32 count)
+{
+    std::ostringstream ss;
+    for(uint32 i = 0; i < count; ++i)
+        ss << values[i] << " ";
+    return ss.str();
+}
+
+static std::string MakeBinary(uint32 const* values, uint32 count)
+{
+    std::string data;
+    data.reserve(BINARY_HEADER_SIZE + count * sizeof(uint32));
+
+    data += char(BINARY_MARKER);
+    data += char(BINARY_VERSION);
+    data += char(uint8(count));
+    data += char(uint8(count >> 8));
+
+    // little-endian byte order at any host
+    for(uint32 i = 0; i < count; ++i)
+        for(uint32 shift = 0; shift < 32; shift += 8)
+            data += char(uint8(values[i] >> shift));
+
+    return data;
+}
+
+void UpdateFieldsStorage::Write(std::ostringstream& ss, uint32 const* values, uint32 count, bool binary)
+{
+    if(!binary)
+    {
+        ss << "'" << MakeText(values, count) << "'";
+        return;
+    }
+
+    static char const hexDigits[] = "0123456789ABCDEF";
+
+    std::string data = MakeBinary(values, count);
+
+    std::string hex;
+    hex.reserve(2 + 2 * data.size());
+    hex += "0x";
+
+    for(size_t i = 0; i < data.size(); ++i)
+    {
+        uint8 byte = uint8(data[i]);
+        hex += hexDigits[byte >> 4];
+        hex += hexDigits[byte & 0x0F];
+    }
+
+    ss << hex;
+}
+
+void UpdateFieldsStorage::Write(SqlStmtParameters& params, uint32 const* values, uint32 count, bool binary)
+{
+    if(!binary)
+    {
+        params << MakeText(values, count);
+        return;
+    }
+
+    std::string data = MakeBinary(values, count);
+    params.AddBinary(data.data(), data.size());
+}
+
+std::string UpdateFieldsStorage::ToText(Field const& data)
+{
+    if(!IsBinary(data))
+        return data.GetCppString();
+
+    uint32 count = GetCount(data);
+    if(!count)
+        return "";
+
+    std::vector<uint32> values(count);
+    if(!Read(data, &values[0], count))
+        return "";
+
+    return MakeText(&values[0], count);
+}
+
+std::string UpdateFieldsStorage::GetValueSelectSQL(uint16 index)
+{
+    std::ostringstream ss;
+    ss << "IF(ASCII(data) = " << BINARY_MARKER << ", "
+        // little-endian uint32 at header + index * 4
+        << "CONV(HEX(REVERSE(SUBSTRING(data, " << (BINARY_HEADER_SIZE + index * sizeof(uint32) + 1) << ", 4))), 16, 10), "
+        // text between spaces index and index+1
+        << "SUBSTRING(data, LENGTH(SUBSTRING_INDEX(data, ' ', " << index << "))+2, "
+        << "LENGTH(SUBSTRING_INDEX(data, ' ', " << (index + 1) << ")) - LENGTH(SUBSTRING_INDEX(data, ' ', " << index << "))-1))";
+    return ss.str();
+}
+
+uint32 UpdateFieldsStorage::ConvertTable(char const* table, bool binary)
+{
+    uint32 converted = 0;
+    uint32 lastGuid = 0;
+
+    while(QueryResult* result = CharacterDatabase.PQuery("SELECT guid, data FROM %s WHERE guid > '%u' ORDER BY guid LIMIT %u", table, lastGuid, CONVERT_BATCH_SIZE))
+    {
+        do
+        {
+            Field* fields = result->Fetch();
+            lastGuid = fields[0].GetUInt32();
+
+            if(IsBinary(fields[1]) == binary)
+                continue;
+
+            uint32 count = GetCount(fields[1]);
+            if(!count)
+                continue;
+
+            std::vector<uint32> values(count);
+            if(!Read(fields[1], &values[0], count))
+            {
+                sLog.outError("Table `%s` has broken data for guid %u, not converted", table, lastGuid);
+                continue;
+            }
+
+            std::ostringstream ss;
+            ss << "UPDATE " << table << " SET data = ";
+            Write(ss, &values[0], count, binary);
+            ss << " WHERE guid = '" << lastGuid << "'";
+
+            if(CharacterDatabase.DirectExecute(ss.str().c_str()))
+                ++converted;
+        }
+        while(result->NextRow());
+
+        delete result;
+    }
+
+    return converted;
+}
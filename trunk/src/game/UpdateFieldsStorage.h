@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_UPDATEFIELDSSTORAGE_H
+#define MANGOS_UPDATEFIELDSSTORAGE_H
+
+#include "Common.h"
+
+class Field;
+class SqlStmtParameters;
+
+/// Format of object values arrays in `data` columns (characters, item_instance, corpse).
+/// Both formats are loaded, the format for saving is selected in config:
+///  - text: decimal values separated by spaces (old format, also used in player dumps and sql updates)
+///  - binary: marker byte, format version byte, uint16 values count and the uint32 values,
+///    all little-endian, so loading at little-endian hosts is a single memcpy
+class UpdateFieldsStorage
+{
+    public:
+        /// binary format is saved only if enabled in config and supported by the DB backend
+        static bool IsBinaryEnabled();
+
+        /// `data` columns can store binary format (sql/updates/6762_* applied, not supported by sqlite and postgresql)
+        static bool IsBinarySupportedByDB();
+
+        static bool IsBinary(Field const& data);
+
+        /// number of values stored in data, any format
+        static uint32 GetCount(Field const& data);
+
+        /// fill values[0..count) from data in any format, false if data holds another number of values
+        static bool Read(Field const& data, uint32* values, uint32 count);
+
+        /// append values to query as SQL value: hex literal for binary format, quoted string for text
+        static void Write(std::ostringstream& ss, uint32 const* values, uint32 count, bool binary);
+        static void Write(std::ostringstream& ss, uint32 const* values, uint32 count)
+        {
+            Write(ss, values, count, IsBinaryEnabled());
+        }
+
+        /// add values as prepared statement param: blob for binary format, string for text
+        static void Write(SqlStmtParameters& params, uint32 const* values, uint32 count, bool binary);
+        static void Write(SqlStmtParameters& params, uint32 const* values, uint32 count)
+        {
+            Write(params, values, count, IsBinaryEnabled());
+        }
+
+        /// data in text format, any stored format
+        static std::string ToText(Field const& data);
+
+        /// SQL expression selecting value index from `data` column in any format
+        static std::string GetValueSelectSQL(uint16 index);
+
+        /// rewrite `data` of all rows in table to binary or text format, returns count of changed rows
+        static uint32 ConvertTable(char const* table, bool binary);
+};
+#endif
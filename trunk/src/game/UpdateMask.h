@@ -49,6 +49,28 @@ class UpdateMask
             return ( ( (uint8 *)mUpdateMask)[ index >> 3 ] & ( 1 << ( index & 0x7 ) )) != 0;
         }
 
+        /// first set bit at index or after it, GetCount() if none (zero blocks are skipped at once)
+        inline uint32 GetNextSetBit (uint32 index)
+        {
+            while (index < mCount)
+            {
+                uint32 block = mUpdateMask[ index >> 5 ] >> ( index & 0x1F );
+                if (!block)
+                {
+                    index = ( index | 0x1F ) + 1;
+                    continue;
+                }
+
+                while (!(block & 1))
+                {
+                    block >>= 1;
+                    ++index;
+                }
+                return index < mCount ? index : mCount;
+            }
+            return mCount;
+        }
+
         inline uint32 GetBlockCount() { return mBlocks; }
         inline uint32 GetLength() { return mBlocks << 2; }
         inline uint32 GetCount() { return mCount; }
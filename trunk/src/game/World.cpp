@@ -55,6 +55,8 @@
 #include "CellImpl.h"
 #include "InstanceSaveMgr.h"
 #include "WaypointManager.h"
+#include "CharacterSnapshotCache.h"
+#include "UpdateFieldsStorage.h"
 #include "Util.h"
 
 INSTANTIATE_SINGLETON_1( World );
@@ -100,6 +102,7 @@ World::World()
     m_maxQueuedSessionCount = 0;
     m_resultQueue = NULL;
     m_NextDailyQuestReset = 0;
+    m_expiredAuctionsLeft = false;
 
     m_defaultDbcLocale = LOCALE_enUS;
     m_availableDbcLocaleMask = 0;
@@ -516,9 +519,20 @@ void World::LoadConfigSettings(bool reload)
         sLog.outError("Compression level (%i) must be in range 1..9. Using default compression level (1).",m_configs[CONFIG_COMPRESSION]);
         m_configs[CONFIG_COMPRESSION] = 1;
     }
+    m_configs[CONFIG_COMPRESSION_MIN_SIZE] = sConfig.GetIntDefault("Compression.MinSize", 50);
+    m_configs[CONFIG_COMPRESSION_FAST_SIZE] = sConfig.GetIntDefault("Compression.FastSize", 0);
     m_configs[CONFIG_ADDON_CHANNEL] = sConfig.GetBoolDefault("AddonChannel", true);
     m_configs[CONFIG_GRID_UNLOAD] = sConfig.GetBoolDefault("GridUnload", true);
     m_configs[CONFIG_INTERVAL_SAVE] = sConfig.GetIntDefault("PlayerSaveInterval", 900000);
+    m_configs[CONFIG_BINARY_VALUES_DATA] = sConfig.GetBoolDefault("PlayerSave.BinaryData", false);
+    if(m_configs[CONFIG_BINARY_VALUES_DATA] && !UpdateFieldsStorage::IsBinarySupportedByDB())
+    {
+        sLog.outError("PlayerSave.BinaryData enabled but `data` columns of `characters` and `item_instance` are not blob (sql/updates/6762_* not applied or database without binary support), text format used.");
+        m_configs[CONFIG_BINARY_VALUES_DATA] = false;
+    }
+    m_configs[CONFIG_CHARACTER_SNAPSHOT_COUNT] = sConfig.GetIntDefault("PlayerSave.SnapshotCount", 0);
+    m_configs[CONFIG_CHARACTER_SNAPSHOT_EXPIRE_TIME] = sConfig.GetIntDefault("PlayerSave.SnapshotExpireTime", 600);
+    m_configs[CONFIG_SAVE_DEFER_QUEUE_SIZE] = sConfig.GetIntDefault("PlayerSave.DeferQueueSize", 100);
 
     m_configs[CONFIG_INTERVAL_GRIDCLEAN] = sConfig.GetIntDefault("GridCleanUpDelay", 300000);
     if(m_configs[CONFIG_INTERVAL_GRIDCLEAN] < MIN_GRID_DELAY)
@@ -538,6 +552,21 @@ void World::LoadConfigSettings(bool reload)
     if(reload)
         MapManager::Instance().SetMapUpdateInterval(m_configs[CONFIG_INTERVAL_MAPUPDATE]);
 
+    if(reload)
+    {
+        uint32 val = sConfig.GetIntDefault("MapUpdate.Threads", 0);
+        if(val!=m_configs[CONFIG_NUMTHREADS])
+            sLog.outError("MapUpdate.Threads option can't be changed at mangosd.conf reload, using current value (%u).",m_configs[CONFIG_NUMTHREADS]);
+    }
+    else
+        m_configs[CONFIG_NUMTHREADS] = sConfig.GetIntDefault("MapUpdate.Threads", 0);
+
+    m_configs[CONFIG_GRID_PRELOAD_TIME] = sConfig.GetIntDefault("MapUpdate.GridPreloadTime", 5000);
+
+    m_configs[CONFIG_SESSION_UPDATE_MAX_PACKETS] = sConfig.GetIntDefault("SessionUpdate.MaxPackets", 100);
+    m_configs[CONFIG_SESSION_UPDATE_MAX_TIME] = sConfig.GetIntDefault("SessionUpdate.MaxTime", 20);
+    m_configs[CONFIG_SESSION_MAX_QUEUED_PACKETS] = sConfig.GetIntDefault("SessionUpdate.MaxQueuedPackets", 2000);
+
     m_configs[CONFIG_INTERVAL_CHANGEWEATHER] = sConfig.GetIntDefault("ChangeWeatherInterval", 600000);
 
     if(reload)
@@ -676,8 +705,11 @@ void World::LoadConfigSettings(bool reload)
     m_configs[CONFIG_GM_LOG_TRADE]         = sConfig.GetBoolDefault("GM.LogTrade", false);
 
     m_configs[CONFIG_GROUP_VISIBILITY] = sConfig.GetIntDefault("Visibility.GroupMode",0);
+    m_configs[CONFIG_RELOCATION_LOWER_LIMIT] = sConfig.GetIntDefault("Visibility.RelocationLowerLimit",10);
+    m_configs[CONFIG_RELOCATION_NOTIFY_DELAY] = sConfig.GetIntDefault("Visibility.RelocationNotifyDelay",500);
 
     m_configs[CONFIG_MAIL_DELIVERY_DELAY] = sConfig.GetIntDefault("MailDeliveryDelay",HOUR);
+    m_configs[CONFIG_AUCTION_EXPIRED_PER_UPDATE] = sConfig.GetIntDefault("Auction.ExpiredPerUpdate",100);
 
     m_configs[CONFIG_UPTIME_UPDATE] = sConfig.GetIntDefault("UpdateUptimeInterval", 10);
     if(m_configs[CONFIG_UPTIME_UPDATE]<=0)
@@ -1240,6 +1272,68 @@ void World::DetectDBCLang()
     sLog.outString("Using %s DBC Locale as default. All available DBC locales: %s",localeNames[m_defaultDbcLocale],availableLocalsStr.empty() ? "<none>" : availableLocalsStr.c_str());
 }
 
+/// Send mails for expired auctions and remove them, returns true if some expired auctions left due to update limit
+bool World::UpdateExpiredAuctions()
+{
+    static uint32 const locations[3] = { 6, 2, 7 };         // horde, alliance, neutral
+
+    uint32 limit = getConfig(CONFIG_AUCTION_EXPIRED_PER_UPDATE);
+    uint32 count = 0;
+    bool left = false;
+
+    // all handled auctions deleted by one query
+    std::ostringstream ss;
+    ss << "DELETE FROM auctionhouse WHERE id IN (";
+
+    for (int i = 0; i < 3 && !left; ++i)
+    {
+        AuctionHouseObject* auctions = objmgr.GetAuctionsMap( locations[i] );
+
+        // auctions in expire time order, only expired ones are touched
+        while (AuctionEntry* auction = auctions->GetExpiredAuction(m_gameTime))
+        {
+            if (limit && count >= limit)
+            {
+                left = true;
+                break;
+            }
+
+            ///- Either cancel the auction if there was no bidder
+            if (auction->bidder == 0)
+            {
+                objmgr.SendAuctionExpiredMail( auction );
+            }
+            ///- Or perform the transaction
+            else
+            {
+                //we should send an "item sold" message if the seller is online
+                //we send the item to the winner
+                //we send the money to the seller
+                objmgr.SendAuctionSuccessfulMail( auction );
+                objmgr.SendAuctionWonMail( auction );
+            }
+
+            ///- In any case clear the auction
+            ss << (count ? "," : "") << auction->Id;
+            ++count;
+
+            objmgr.RemoveAItem(auction->item_guidlow);
+            auctions->RemoveAuction(auction->Id);
+            delete auction;
+        }
+    }
+
+    if (count)
+    {
+        ss << ")";
+        CharacterDatabase.Execute(ss.str().c_str());
+
+        sLog.outDetail("Handled %u expired auctions%s", count, left ? ", rest at next updates" : "");
+    }
+
+    return left;
+}
+
 /// Update the World !
 void World::Update(time_t diff)
 {
@@ -1272,56 +1366,13 @@ void World::Update(time_t diff)
             objmgr.ReturnOrDeleteOldMails(true);
         }
 
-        AuctionHouseObject* AuctionMap;
-        for (int i = 0; i < 3; i++)
-        {
-            switch (i)
-            {
-                case 0:
-                    AuctionMap = objmgr.GetAuctionsMap( 6 );//horde
-                    break;
-                case 1:
-                    AuctionMap = objmgr.GetAuctionsMap( 2 );//alliance
-                    break;
-                case 2:
-                    AuctionMap = objmgr.GetAuctionsMap( 7 );//neutral
-                    break;
-            }
-
-            ///- Handle expired auctions
-            AuctionHouseObject::AuctionEntryMap::iterator itr,next;
-            for (itr = AuctionMap->GetAuctionsBegin(); itr != AuctionMap->GetAuctionsEnd();itr = next)
-            {
-                next = itr;
-                ++next;
-                if (m_gameTime > (itr->second->time))
-                {
-                    ///- Either cancel the auction if there was no bidder
-                    if (itr->second->bidder == 0)
-                    {
-                        objmgr.SendAuctionExpiredMail( itr->second );
-                    }
-                    ///- Or perform the transaction
-                    else
-                    {
-                        //we should send an "item sold" message if the seller is online
-                        //we send the item to the winner
-                        //we send the money to the seller
-                        objmgr.SendAuctionSuccessfulMail( itr->second );
-                        objmgr.SendAuctionWonMail( itr->second );
-                    }
-
-                    ///- In any case clear the auction
-                    //No SQL injection (Id is integer)
-                    CharacterDatabase.PExecute("DELETE FROM auctionhouse WHERE id = '%u'",itr->second->Id);
-                    objmgr.RemoveAItem(itr->second->item_guidlow);
-                    delete itr->second;
-                    AuctionMap->RemoveAuction(itr->first);
-                }
-            }
-        }
+        m_expiredAuctionsLeft = true;
     }
 
+    ///- Handle expired auctions, big amount (after server downtime) handled at several updates
+    if (m_expiredAuctionsLeft)
+        m_expiredAuctionsLeft = UpdateExpiredAuctions();
+
     /// <li> Handle session updates when the timer has passed
     if (m_timers[WUPDATE_SESSIONS].Passed())
     {
@@ -2544,6 +2595,7 @@ void World::ResetDailyQuests()
 {
     sLog.outDetail("Daily quests reset for all characters.");
     CharacterDatabase.Execute("DELETE FROM character_queststatus_daily");
+    sCharacterSnapshotCache.Clear();
     for(SessionMap::iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
         if(itr->second->GetPlayer())
             itr->second->GetPlayer()->ResetDailyQuestStatus();
@@ -66,10 +66,21 @@ enum WorldTimers
 enum WorldConfigs
 {
     CONFIG_COMPRESSION = 0,
+    CONFIG_COMPRESSION_MIN_SIZE,
+    CONFIG_COMPRESSION_FAST_SIZE,
     CONFIG_GRID_UNLOAD,
     CONFIG_INTERVAL_SAVE,
+    CONFIG_BINARY_VALUES_DATA,
+    CONFIG_CHARACTER_SNAPSHOT_COUNT,
+    CONFIG_CHARACTER_SNAPSHOT_EXPIRE_TIME,
+    CONFIG_SAVE_DEFER_QUEUE_SIZE,
     CONFIG_INTERVAL_GRIDCLEAN,
     CONFIG_INTERVAL_MAPUPDATE,
+    CONFIG_NUMTHREADS,
+    CONFIG_GRID_PRELOAD_TIME,
+    CONFIG_SESSION_UPDATE_MAX_PACKETS,
+    CONFIG_SESSION_UPDATE_MAX_TIME,
+    CONFIG_SESSION_MAX_QUEUED_PACKETS,
     CONFIG_INTERVAL_CHANGEWEATHER,
     CONFIG_PORT_WORLD,
     CONFIG_SOCKET_SELECTTIME,
@@ -116,7 +127,10 @@ enum WorldConfigs
     CONFIG_GM_IN_WHO_LIST,
     CONFIG_GM_LOG_TRADE,
     CONFIG_GROUP_VISIBILITY,
+    CONFIG_RELOCATION_LOWER_LIMIT,
+    CONFIG_RELOCATION_NOTIFY_DELAY,
     CONFIG_MAIL_DELIVERY_DELAY,
+    CONFIG_AUCTION_EXPIRED_PER_UPDATE,
     CONFIG_UPTIME_UPDATE,
     CONFIG_SKILL_CHANCE_ORANGE,
     CONFIG_SKILL_CHANCE_YELLOW,
@@ -480,12 +494,15 @@ class World
 
         void InitDailyQuestResetTime();
         void ResetDailyQuests();
+
+        bool UpdateExpiredAuctions();
     private:
         time_t m_startTime;
         time_t m_gameTime;
         IntervalTimer m_timers[WUPDATE_COUNT];
         uint32 mail_timer;
         uint32 mail_timer_expires;
+        bool m_expiredAuctionsLeft;                         // expired auctions must be checked at next update
 
         typedef HM_NAMESPACE::hash_map<uint32, Weather*> WeatherMap;
         WeatherMap m_weathers;
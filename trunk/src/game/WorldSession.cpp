@@ -69,12 +69,12 @@ WorldSession::~WorldSession()
       m_Socket = NULL;
     }
 
-    ///- empty incoming packet queue
-    while(!_recvQueue.empty())
-    {
-        WorldPacket *packet = _recvQueue.next();
-        delete packet;
-    }
+    ///- empty incoming packet queues
+    for(PacketQueue::iterator itr = _recvBatch.begin(); itr != _recvBatch.end(); ++itr)
+        delete *itr;
+
+    for(PacketQueue::iterator itr = _recvQueue.begin(); itr != _recvQueue.end(); ++itr)
+        delete *itr;
     
     sWorld.RemoveQueuedPlayer(this);
 }
@@ -136,10 +136,40 @@ void WorldSession::SendPacket(WorldPacket const* packet)
     }
 }
 
-/// Add an incoming packet to the queue
-void WorldSession::QueuePacket(WorldPacket* new_packet)
+/// Send a broadcast packet, the payload is shared with other sessions
+void WorldSession::SendPacket(SharedWorldPacket const* packet)
 {
-    _recvQueue.add(new_packet);
+    if (!m_Socket)
+        return;
+
+    if (m_Socket->SendPacket (*packet) == -1)
+        m_Socket->CloseSocket ();
+}
+
+/// Get outbound queue statistics of the session socket
+bool WorldSession::GetSendStats(WorldSocketSendStats& stats) const
+{
+    if (!m_Socket)
+        return false;
+
+    m_Socket->GetSendStats (stats);
+    return true;
+}
+
+/// Add an incoming packet to the queue, false (and packet deleted) if the client sends faster than it is handled
+bool WorldSession::QueuePacket(WorldPacket* new_packet)
+{
+    uint32 maxQueued = sWorld.getConfig(CONFIG_SESSION_MAX_QUEUED_PACKETS);
+
+    RecvQueueGuard guard(_recvQueueLock);
+    if (maxQueued && _recvQueue.size() >= maxQueued)
+    {
+        delete new_packet;
+        return false;
+    }
+
+    _recvQueue.push_back(new_packet);
+    return true;
 }
 
 /// Logging helper for unexpected opcodes
@@ -163,12 +193,33 @@ bool WorldSession::Update(uint32 /*diff*/)
   
     WorldPacket *packet;
 
+    ///- Take all received packets at once, packets left by the previous update are handled first
+    if (_recvBatch.empty())
+    {
+        RecvQueueGuard guard(_recvQueueLock);
+        _recvBatch.swap(_recvQueue);
+    }
+
+    ///- Limit packets and time per update, so a flooding client can't delay other sessions
+    uint32 maxPackets = sWorld.getConfig(CONFIG_SESSION_UPDATE_MAX_PACKETS);
+    uint32 maxTime = sWorld.getConfig(CONFIG_SESSION_UPDATE_MAX_TIME);
+    uint32 startTime = maxTime ? getMSTime() : 0;
+    uint32 processed = 0;
+
     ///- Retrieve packets from the receive queue and call the appropriate handlers
     /// \todo Is there a way to consolidate the OpcondeHandlerTable and the g_worldOpcodeNames to only maintain 1 list?
     /// answer : there is a way, but this is better, because it would use redundant RAM
-    while (!_recvQueue.empty())
+    while (!_recvBatch.empty())
     {
-        packet = _recvQueue.next();
+        if (maxPackets && processed >= maxPackets)
+            break;
+
+        if (maxTime && getMSTimeDiff(startTime, getMSTime()) >= maxTime)
+            break;
+
+        packet = _recvBatch.front();
+        _recvBatch.pop_front();
+        ++processed;
 
         /*#if 1
         sLog.outError( "MOEP: %s (0x%.4X)",
@@ -375,6 +426,7 @@ void WorldSession::LogoutPlayer(bool Save)
         sSocialMgr.SendFriendStatus(_player, FRIEND_OFFLINE, _player->GetGUIDLow(), "", true);
 
         ///- Delete the player object
+        uint64 guid = _player->GetGUID();
         _player->CleanupsBeforeDelete();                    // do some cleanup before deleting to prevent crash at crossreferences to already deleted data
 
         delete _player;
@@ -388,6 +440,9 @@ void WorldSession::LogoutPlayer(bool Save)
         //No SQL injection as AccountId is uint32
         CharacterDatabase.PExecute("UPDATE characters SET online = 0 WHERE account = '%u'", GetAccountId());
         sLog.outDebug( "SESSION: Sent SMSG_LOGOUT_COMPLETE Message" );
+
+        if(Save)
+            LoadCharacterSnapshot(guid);
     }
 
     m_playerLogout = false;
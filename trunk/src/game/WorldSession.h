@@ -36,7 +36,9 @@ class Object;
 class Player;
 class Unit;
 class WorldPacket;
+class SharedWorldPacket;
 class WorldSocket;
+struct WorldSocketSendStats;
 class WorldSession;
 class QueryResult;
 class LoginQueryHolder;
@@ -79,6 +81,8 @@ class MANGOS_DLL_SPEC WorldSession
         void SizeError(WorldPacket const& packet, uint32 size) const;
 
         void SendPacket(WorldPacket const* packet);
+        void SendPacket(SharedWorldPacket const* packet);
+        bool GetSendStats(WorldSocketSendStats& stats) const;
         void SendNotification(const char *format,...) ATTR_PRINTF(2,3);
         void SendNotification(int32 string_id,...);
         void SendPetNameInvalid(uint32 error, std::string name, DeclinedName *declinedName);
@@ -113,7 +117,7 @@ class MANGOS_DLL_SPEC WorldSession
         void LogoutPlayer(bool Save);
         void KickPlayer();
 
-        void QueuePacket(WorldPacket* new_packet);
+        bool QueuePacket(WorldPacket* new_packet);
         bool Update(uint32 diff);
         
         /// Handle the authentication waiting queue (to be completed)
@@ -214,6 +218,7 @@ class MANGOS_DLL_SPEC WorldSession
         void HandlePlayerLoginOpcode(WorldPacket& recvPacket);
         void HandleCharEnum(QueryResult * result);
         void HandlePlayerLogin(LoginQueryHolder * holder);
+        void LoadCharacterSnapshot(uint64 guid);            // for fast next login of the character
 
         // played time
         void HandlePlayedTime(WorldPacket& recvPacket);
@@ -640,7 +645,12 @@ class MANGOS_DLL_SPEC WorldSession
         int m_sessionDbLocaleIndex;
         uint32 m_latency;
 
-        ZThread::LockedQueue<WorldPacket*,ZThread::FastMutex> _recvQueue;
+        typedef std::deque<WorldPacket*> PacketQueue;
+        typedef MaNGOS::GeneralLock<ZThread::FastMutex> RecvQueueGuard;
+
+        ZThread::FastMutex _recvQueueLock;
+        PacketQueue _recvQueue;                             // filled by network threads, guarded by _recvQueueLock
+        PacketQueue _recvBatch;                             // taken from _recvQueue in one swap, used only by Update
 };
 #endif
 /// @}
@@ -40,6 +40,7 @@
 #include "Auth/Sha1.h"
 #include "WorldSession.h"
 #include "WorldSocketMgr.h"
+#include "SharedWorldPacket.h"
 #include "Log.h"
 #include "WorldLog.h"
 
@@ -67,6 +68,85 @@ struct ClientPktHeader
 #pragma pack(pop)
 #endif
 
+/// Shared packets up to this size are copied to the output buffer,
+/// bigger ones are queued by refference to the shared body.
+static const size_t SharedPacketCopyLimit = 512;
+
+/// Max number of iovec entries written by one handle_output call.
+static const int MaxSendIov = 64;
+
+/// Broadcasts which may be dropped when the client can't keep up,
+/// next movement packet of the same object corrects its position.
+static bool IsLowPriorityOpcode (uint16 opcode)
+{
+    switch (opcode)
+    {
+        case MSG_MOVE_HEARTBEAT:
+        case MSG_MOVE_SET_FACING:
+        case MSG_MOVE_SET_PITCH:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static void BuildServerHeader (AuthCrypt& crypt, const WorldPacket& pct, ServerPktHeader& header)
+{
+    header.cmd = pct.GetOpcode ();
+
+#if ACE_BYTE_ORDER == ACE_BIG_ENDIAN
+    header.cmd = ACE_SWAP_WORD (header.cmd)
+#endif
+
+    header.size = (uint16) pct.size () + 2;
+    header.size = ACE_HTONS (header.size);
+
+    crypt.EncryptSend ((uint8*) & header, sizeof (header));
+}
+
+WorldSocketAcceptor::WorldSocketAcceptor (void) :
+m_Backlog (ACE_DEFAULT_BACKLOG),
+m_ReusePort (false)
+{
+}
+
+void WorldSocketAcceptor::SetOptions (int backlog, bool reuse_port)
+{
+    m_Backlog = backlog;
+    m_ReusePort = reuse_port;
+}
+
+int WorldSocketAcceptor::open (const ACE_Addr &local_sap,
+                               int reuse_addr,
+                               int protocol_family,
+                               int /*backlog*/,
+                               int protocol)
+{
+    if (local_sap != ACE_Addr::sap_any)
+        protocol_family = local_sap.get_type ();
+    else if (protocol_family == PF_UNSPEC)
+        protocol_family = PF_INET;
+
+    if (ACE_SOCK::open (SOCK_STREAM, protocol_family, protocol, reuse_addr) == -1)
+        return -1;
+
+#ifdef SO_REUSEPORT
+    if (m_ReusePort)
+    {
+        int one = 1;
+
+        if (this->set_option (SOL_SOCKET, SO_REUSEPORT, &one, sizeof (one)) == -1)
+        {
+            sLog.outError ("WorldSocketAcceptor::open: set_option SO_REUSEPORT errno = %s", ACE_OS::strerror (errno));
+            this->close ();
+            return -1;
+        }
+    }
+#endif // SO_REUSEPORT
+
+    return this->shared_open (local_sap, protocol_family, m_Backlog);
+}
+
 WorldSocket::WorldSocket (void) :
 WorldHandler (),
 m_Session (0),
@@ -75,12 +155,20 @@ m_RecvPct (),
 m_Header (sizeof (ClientPktHeader)),
 m_OutBuffer (0),
 m_OutBufferSize (65536),
+m_QueuedBytes (0),
+m_OutQueueHighWatermark (262144),
+m_OutQueueLowWatermark (65536),
+m_OutQueueLimit (4194304),
+m_OutCongested (false),
+m_QueueStartTime (ACE_Time_Value::zero),
 m_OutActive (false),
 m_Seed (static_cast<uint32> (rand32 ())),
 m_OverSpeedPings (0),
 m_LastPingTime (ACE_Time_Value::zero)
 {
     this->reference_counting_policy ().value (ACE_Event_Handler::Reference_Counting_Policy::ENABLED);
+
+    ACE_OS::memset (&m_SendStats, 0, sizeof (m_SendStats));
 }
 
 WorldSocket::~WorldSocket (void)
@@ -95,9 +183,9 @@ WorldSocket::~WorldSocket (void)
 
     this->peer ().close ();
 
-    WorldPacket* pct;
-    while (m_PacketQueue.dequeue_head (pct) == 0)
-        delete pct;
+    ACE_Message_Block* mb;
+    while (m_PacketQueue.dequeue_head (mb) == 0)
+        mb->release ();
 }
 
 bool WorldSocket::IsClosed (void) const
@@ -130,14 +218,8 @@ const std::string& WorldSocket::GetRemoteAddress (void) const
     return m_Address;
 }
 
-int WorldSocket::SendPacket (const WorldPacket& pct)
+void WorldSocket::LogOutgoingPacket (const WorldPacket& pct)
 {
-    ACE_GUARD_RETURN (LockType, Guard, m_OutBufferLock, -1);
-
-    if (this->closing_)
-        return -1;
-
-    // Dump outgoing packet.
     if (sWorldLog.LogWorld ())
     {
         sWorldLog.Log ("SERVER:\nSOCKET: %u\nLENGTH: %u\nOPCODE: %s (0x%.4X)\nDATA:\n",
@@ -157,24 +239,61 @@ int WorldSocket::SendPacket (const WorldPacket& pct)
 
         sWorldLog.Log ("\n\n");
     }
+}
+
+int WorldSocket::SendPacket (const WorldPacket& pct)
+{
+    ACE_GUARD_RETURN (LockType, Guard, m_OutBufferLock, -1);
+
+    if (this->closing_)
+        return -1;
+
+    // Dump outgoing packet.
+    LogOutgoingPacket (pct);
+
+    // Packets must go out in the order their headers are encrypted,
+    // so the buffer is used only when nothing waits in the queue.
+    if (m_PacketQueue.is_empty () && iSendPacket (pct) == 0)
+        return 0;
+
+    return iQueuePacket (pct, NULL);
+}
+
+void WorldSocket::GetSendStats (WorldSocketSendStats& stats)
+{
+    ACE_GUARD (LockType, Guard, m_OutBufferLock);
+
+    stats = m_SendStats;
+    stats.QueuedBytes = m_QueuedBytes;
+}
+
+int WorldSocket::SendPacket (const SharedWorldPacket& spct)
+{
+    ACE_GUARD_RETURN (LockType, Guard, m_OutBufferLock, -1);
+
+    if (this->closing_)
+        return -1;
+
+    const WorldPacket& pct = spct.GetPacket ();
 
-    if (iSendPacket (pct) == -1)
+    if (m_OutCongested && IsLowPriorityOpcode (pct.GetOpcode ()))
     {
-        WorldPacket* npct;
+        iDropPacket (pct);
+        return 0;
+    }
 
-        ACE_NEW_RETURN (npct, WorldPacket (pct), -1);
+    // Dump outgoing packet.
+    LogOutgoingPacket (pct);
 
-        // NOTE maybe check of the size of the queue can be good ?
-        // to make it bounded instead of unbounded
-        if (m_PacketQueue.enqueue_tail (npct) == -1)
-        {
-            delete npct;
-            sLog.outError ("WorldSocket::SendPacket: m_PacketQueue.enqueue_tail failed");
-            return -1;
-        }
+    if (pct.size () <= SharedPacketCopyLimit)
+    {
+        if (m_PacketQueue.is_empty () && iSendPacket (pct) == 0)
+            return 0;
+
+        return iQueuePacket (pct, NULL);
     }
 
-    return 0;
+    return iQueuePacket (pct, spct.DuplicateBody ());
 }
 
 long WorldSocket::AddReference (void)
@@ -291,17 +410,26 @@ int WorldSocket::handle_output (ACE_HANDLE)
     if (this->closing_)
         return -1;
 
-    const size_t send_len = m_OutBuffer->length ();
+    iovec iov[MaxSendIov];
+    size_t send_len = 0;
+
+    const int iovcnt = iFillSendVector (iov, MaxSendIov, send_len);
 
     if (send_len == 0)
         return this->cancel_wakeup_output (Guard);
 
+    // Buffer and queued packets go out with one gather write.
 #ifdef MSG_NOSIGNAL
-    ssize_t n = this->peer ().send (m_OutBuffer->rd_ptr (), send_len, MSG_NOSIGNAL);
+    msghdr msg;
+    ACE_OS::memset (&msg, 0, sizeof (msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iovcnt;
+
+    ssize_t n = ACE_OS::sendmsg (this->get_handle (), &msg, MSG_NOSIGNAL);
 #else
-    ssize_t n = this->peer ().send (m_OutBuffer->rd_ptr (), send_len);
+    ssize_t n = this->peer ().sendv (iov, iovcnt);
 #endif // MSG_NOSIGNAL
-          
+
     if (n == 0)
         return -1;
     else if (n == -1)
@@ -311,26 +439,14 @@ int WorldSocket::handle_output (ACE_HANDLE)
 
         return -1;
     }
-    else if (n < send_len) //now n > 0
-    {
-        m_OutBuffer->rd_ptr (static_cast<size_t> (n));
 
-        // move the data to the base of the buffer
-        m_OutBuffer->crunch ();
+    //now n > 0
+    iConsumeSent (static_cast<size_t> (n));
 
+    if (m_OutBuffer->length () == 0 && m_PacketQueue.is_empty ())
+        return this->cancel_wakeup_output (Guard);
+    else
         return this->schedule_wakeup_output (Guard);
-    }
-    else //now n == send_len
-    {
-        m_OutBuffer->reset ();
-
-        if (!iFlushPacketQueue ())
-            return this->cancel_wakeup_output (Guard);
-        else
-            return this->schedule_wakeup_output (Guard);
-    }
-
-    ACE_NOTREACHED (return 0);
 }
 
 int WorldSocket::handle_close (ACE_HANDLE h, ACE_Reactor_Mask)
@@ -360,7 +476,7 @@ int WorldSocket::Update (void)
     if (this->closing_)
         return -1;
 
-    if (m_OutActive || m_OutBuffer->length () == 0)
+    if (m_OutActive || (m_OutBuffer->length () == 0 && m_PacketQueue.is_empty ()))
         return 0;
 
     return this->handle_output (this->get_handle ());
@@ -626,7 +742,14 @@ int WorldSocket::ProcessIncoming (WorldPacket* new_pct)
             aptr.release ();
             // WARNINIG here we call it with locks held.
             // Its possible to cause deadlock if QueuePacket calls back
-            m_Session->QueuePacket (new_pct);
+            if (!m_Session->QueuePacket (new_pct))
+            {
+                sLog.outError ("WorldSocket::ProcessIncoming: receive queue of %s (account %u) is full, closing connection",
+                               GetRemoteAddress ().c_str (),
+                               m_Session->GetAccountId ());
+                return -1;
+            }
+
             return 0;
         }
         else
@@ -971,17 +1094,7 @@ int WorldSocket::iSendPacket (const WorldPacket& pct)
     }
 
     ServerPktHeader header;
-
-    header.cmd = pct.GetOpcode ();
-
-#if ACE_BYTE_ORDER == ACE_BIG_ENDIAN
-    header.cmd = ACE_SWAP_WORD (header.cmd)
-#endif
-          
-    header.size = (uint16) pct.size () + 2;
-    header.size = ACE_HTONS (header.size);
-
-    m_Crypt.EncryptSend ((uint8*) & header, sizeof (header));
+    BuildServerHeader (m_Crypt, pct, header);
 
     if (m_OutBuffer->copy ((char*) & header, sizeof (header)) == -1)
         ACE_ASSERT (false);
@@ -993,30 +1106,164 @@ int WorldSocket::iSendPacket (const WorldPacket& pct)
     return 0;
 }
 
-bool WorldSocket::iFlushPacketQueue ()
+int WorldSocket::iQueuePacket (const WorldPacket& pct, ACE_Message_Block* body)
+{
+    const size_t pct_size = sizeof (ServerPktHeader) + pct.size ();
+
+    if (m_OutQueueLimit && m_QueuedBytes + pct_size > m_OutQueueLimit)
+    {
+        sLog.outError ("WorldSocket::iQueuePacket: output queue of %s is over %u bytes, closing connection",
+                       GetRemoteAddress ().c_str (),
+                       (uint32) m_OutQueueLimit);
+
+        if (body)
+            body->release ();
+
+        errno = ENOBUFS;
+        return -1;
+    }
+
+    ACE_Message_Block* mb;
+
+    const size_t mb_size = sizeof (ServerPktHeader) + (body ? 0 : pct.size ());
+
+    ACE_NEW_NORETURN (mb, ACE_Message_Block (mb_size));
+
+    if (mb == NULL)
+    {
+        if (body)
+            body->release ();
+
+        return -1;
+    }
+
+    ServerPktHeader header;
+    BuildServerHeader (m_Crypt, pct, header);
+
+    mb->copy ((char*) & header, sizeof (header));
+
+    if (body)
+        mb->cont (body);
+    else if (!pct.empty ())
+        mb->copy ((char*) pct.contents (), pct.size ());
+
+    if (m_PacketQueue.enqueue_tail (mb) == -1)
+    {
+        mb->release ();
+        sLog.outError ("WorldSocket::iQueuePacket: m_PacketQueue.enqueue_tail failed");
+        return -1;
+    }
+
+    if (m_PacketQueue.size () == 1)
+        m_QueueStartTime = ACE_OS::gettimeofday ();
+
+    m_QueuedBytes += pct_size;
+
+    if (m_QueuedBytes > m_SendStats.QueuedBytesPeak)
+        m_SendStats.QueuedBytesPeak = m_QueuedBytes;
+
+    if (!m_OutCongested && m_QueuedBytes >= m_OutQueueHighWatermark)
+    {
+        m_OutCongested = true;
+        ++m_SendStats.CongestedCount;
+
+        DEBUG_LOG ("WorldSocket::iQueuePacket: output queue of %s reached %u bytes, dropping low priority packets",
+                   GetRemoteAddress ().c_str (),
+                   (uint32) m_QueuedBytes);
+    }
+
+    return 0;
+}
+
+int WorldSocket::iFillSendVector (iovec* iov, int max_iov, size_t& total)
 {
-    WorldPacket *pct;
-    bool haveone = false;
+    int cnt = 0;
+    total = 0;
 
-    while (m_PacketQueue.dequeue_head (pct) == 0)
+    if (m_OutBuffer->length () > 0)
     {
-        if (iSendPacket (*pct) == -1)
+        iov[cnt].iov_base = m_OutBuffer->rd_ptr ();
+        iov[cnt].iov_len = m_OutBuffer->length ();
+        total += m_OutBuffer->length ();
+        ++cnt;
+    }
+
+    ACE_Unbounded_Queue_Iterator<ACE_Message_Block*> itr (m_PacketQueue);
+
+    for (ACE_Message_Block** entry; cnt < max_iov && itr.next (entry); itr.advance ())
+    {
+        for (ACE_Message_Block* mb = *entry; mb && cnt < max_iov; mb = mb->cont ())
         {
-            if (m_PacketQueue.enqueue_head (pct) == -1)
-            {
-                delete pct;
-                sLog.outError ("WorldSocket::iFlushPacketQueue m_PacketQueue->enqueue_head");
-                return false;
-            }
+            if (mb->length () == 0)
+                continue;
 
-            break;
+            iov[cnt].iov_base = mb->rd_ptr ();
+            iov[cnt].iov_len = mb->length ();
+            total += mb->length ();
+            ++cnt;
         }
+    }
+
+    return cnt;
+}
+
+void WorldSocket::iConsumeSent (size_t n)
+{
+    const size_t buf_sent = ACE_MIN (n, m_OutBuffer->length ());
+
+    if (buf_sent > 0)
+    {
+        m_OutBuffer->rd_ptr (buf_sent);
+        n -= buf_sent;
+
+        if (m_OutBuffer->length () == 0)
+            m_OutBuffer->reset ();
         else
+            // move the data to the base of the buffer
+            m_OutBuffer->crunch ();
+    }
+
+    ACE_Message_Block** entry;
+
+    // fully sent entries are released, the first partially sent one stops the loop
+    while (m_PacketQueue.get (entry) == 0)
+    {
+        ACE_Message_Block* head = *entry;
+
+        for (ACE_Message_Block* mb = head; mb && n > 0; mb = mb->cont ())
         {
-            haveone = true;
-            delete pct;
+            const size_t mb_sent = ACE_MIN (n, mb->length ());
+
+            mb->rd_ptr (mb_sent);
+            n -= mb_sent;
+            m_QueuedBytes -= mb_sent;
         }
+
+        if (head->total_length () > 0)
+            break;
+
+        m_PacketQueue.dequeue_head (head);
+        head->release ();
     }
 
-    return haveone;
+    if (m_OutCongested && m_QueuedBytes <= m_OutQueueLowWatermark)
+        m_OutCongested = false;
+
+    if (m_PacketQueue.is_empty () && m_QueueStartTime != ACE_Time_Value::zero)
+    {
+        const uint32 flush_time = (ACE_OS::gettimeofday () - m_QueueStartTime).msec ();
+
+        m_SendStats.LastFlushTime = flush_time;
+
+        if (flush_time > m_SendStats.MaxFlushTime)
+            m_SendStats.MaxFlushTime = flush_time;
+
+        m_QueueStartTime = ACE_Time_Value::zero;
+    }
+}
+
+void WorldSocket::iDropPacket (const WorldPacket& pct)
+{
+    ++m_SendStats.DroppedPackets;
+    m_SendStats.DroppedBytes += sizeof (ServerPktHeader) + pct.size ();
 }
@@ -35,6 +35,7 @@
 #include <ace/Guard_T.h>
 #include <ace/Unbounded_Queue.h>
 #include <ace/Message_Block.h>
+#include <ace/os_include/sys/os_uio.h>
 
 #if !defined (ACE_LACKS_PRAGMA_ONCE)
 #pragma once
@@ -45,11 +46,60 @@
 
 class ACE_Message_Block;
 class WorldPacket;
+class SharedWorldPacket;
 class WorldSession;
 
+/// Outbound queue statistics of one socket.
+struct WorldSocketSendStats
+{
+  /// Bytes waiting in the packet queue now and at most.
+  size_t QueuedBytes;
+  size_t QueuedBytesPeak;
+
+  /// Low priority packets dropped while the queue was over the high watermark.
+  uint32 DroppedPackets;
+  uint64 DroppedBytes;
+
+  /// How many times the queue crossed the high watermark.
+  uint32 CongestedCount;
+
+  /// Time in ms from first queued packet to empty queue, last and max.
+  uint32 LastFlushTime;
+  uint32 MaxFlushTime;
+};
+
 /// Handler that can communicate over stream sockets.
 typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> WorldHandler;
 
+/**
+ * Listening socket for WorldSocket connections.
+ *
+ * Unlike ACE_SOCK_Acceptor the listen backlog is configurable 
+ * (ACE default of 5 is too low for login storms after restart), 
+ * and the socket can be bound with SO_REUSEPORT so every network 
+ * thread listens on the same port and the kernel shares 
+ * incoming connections between them.
+ */
+class WorldSocketAcceptor : public ACE_SOCK_Acceptor
+{
+public:
+  WorldSocketAcceptor (void);
+
+  /// Set options used by next open ().
+  void SetOptions (int backlog, bool reuse_port);
+
+  /// Called by ACE_Acceptor, backlog argument is replaced by SetOptions value.
+  int open (const ACE_Addr &local_sap,
+            int reuse_addr = 0,
+            int protocol_family = PF_UNSPEC,
+            int backlog = ACE_DEFAULT_BACKLOG,
+            int protocol = 0);
+
+private:
+  int m_Backlog;
+  bool m_ReusePort;
+};
+
 /**
  * WorldSocket.
  * 
@@ -62,7 +112,15 @@ typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> WorldHandler;
  * a queue where it stores packet if there is no place on 
  * the queue. The reason this is done, is because the server 
  * does realy a lot of small-size writes to it, and it doesn't 
- * scale well to allocate memory for every. When something is 
+ * scale well to allocate memory for every. Big broadcast 
+ * packets (SharedWorldPacket) are not copied to the buffer, 
+ * only a refference to their body is queued after own header, 
+ * the buffer and the queue are written with one writev call. 
+ * The queue is bounded: above the high watermark low priority 
+ * broadcasts (movement of other objects) are dropped until it 
+ * drains to the low watermark, above the hard limit the 
+ * connection is closed. 
+ * When something is 
  * writen to the output buffer the socket is not immideately 
  * activated for output (again for the same reason), there 
  * is 10ms celling (thats why there is Update() method). 
@@ -90,19 +148,21 @@ class WorldSocket : protected WorldHandler
 {
 public:
   /// Declare some friends
-  friend class ACE_Acceptor< WorldSocket, ACE_SOCK_ACCEPTOR >;
+  friend class ACE_Acceptor< WorldSocket, WorldSocketAcceptor >;
   friend class WorldSocketMgr;
   friend class ReactorRunnable;
 
   /// Declare the acceptor for this class
-  typedef ACE_Acceptor< WorldSocket, ACE_SOCK_ACCEPTOR > Acceptor;
+  typedef ACE_Acceptor< WorldSocket, WorldSocketAcceptor > Acceptor;
 
   /// Mutex type used for various syncronizations.
   typedef ACE_Thread_Mutex LockType;
   typedef ACE_Guard<LockType> GuardType;
 
   /// Queue for storing packets for which there is no space.
-  typedef ACE_Unbounded_Queue< WorldPacket* > PacketQueueT;
+  /// Every entry is the encrypted header block, with the payload
+  /// in the same block or chained as cont() refference.
+  typedef ACE_Unbounded_Queue< ACE_Message_Block* > PacketQueueT;
 
   /// Check if socket is closed.
   bool IsClosed (void) const;
@@ -118,6 +178,14 @@ public:
   /// @return -1 of failure
   int SendPacket (const WorldPacket& pct);
 
+  /// Get outbound queue statistics, this function is reentrant.
+  void GetSendStats (WorldSocketSendStats& stats);
+
+  /// Send a packet body shared with other sockets, this function is reentrant.
+  /// @param pct packet to send
+  /// @return -1 of failure
+  int SendPacket (const SharedWorldPacket& pct);
+
   /// Add refference to this object.
   long AddReference (void);
 
@@ -169,15 +237,30 @@ private:
   /// Called by ProcessIncoming() on CMSG_PING.
   int HandlePing (WorldPacket& recvPacket);
 
+  /// Dump outgoing packet to world log if enabled.
+  void LogOutgoingPacket (const WorldPacket& pct);
+
   /// Try to write WorldPacket to m_OutBuffer ,return -1 if no space
   /// Need to be called with m_OutBufferLock lock held
   int iSendPacket (const WorldPacket& pct);
 
-  /// Flush m_PacketQueue if there are packets in it
+  /// Append packet to m_PacketQueue, if body is not NULL it is
+  /// used (refference taken) instead of copy of the payload.
+  /// Need to be called with m_OutBufferLock lock held
+  int iQueuePacket (const WorldPacket& pct, ACE_Message_Block* body);
+
+  /// Fill iovec array with m_OutBuffer and queued data.
+  /// Need to be called with m_OutBufferLock lock held
+  /// @return number of used iovec entries
+  int iFillSendVector (iovec* iov, int max_iov, size_t& total);
+
+  /// Consume sent bytes from m_OutBuffer and m_PacketQueue.
+  /// Need to be called with m_OutBufferLock lock held
+  void iConsumeSent (size_t n);
+
+  /// Count a packet dropped by the congestion policy.
   /// Need to be called with m_OutBufferLock lock held
-  /// @return true if it wrote to the buffer ( AKA you need 
-  /// to mark the socket for output ).
-  bool iFlushPacketQueue ();
+  void iDropPacket (const WorldPacket& pct);
 
 private:
   /// Time in which the last ping was received
@@ -222,6 +305,23 @@ private:
   /// this alows not-to kick player if its buffer is overflowed.
   PacketQueueT m_PacketQueue;
 
+  /// Bytes waiting in m_PacketQueue.
+  size_t m_QueuedBytes;
+
+  /// m_PacketQueue limits, set by WorldSocketMgr.
+  size_t m_OutQueueHighWatermark;
+  size_t m_OutQueueLowWatermark;
+  size_t m_OutQueueLimit;
+
+  /// Set between crossing high watermark and draining to low watermark.
+  bool m_OutCongested;
+
+  /// Time when first packet was added to empty m_PacketQueue.
+  ACE_Time_Value m_QueueStartTime;
+
+  /// Outbound statistics, protected by m_OutBufferLock.
+  WorldSocketSendStats m_SendStats;
+
   /// True if the socket is registered with the reactor for output
   bool m_OutActive;
 
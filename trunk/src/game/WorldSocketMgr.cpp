@@ -221,15 +221,18 @@ m_NetThreads (0),
 m_SockOutKBuff (-1),
 m_SockOutUBuff (65536),
 m_UseNoDelay (true),
-m_Acceptor (0) {}
+m_OutQueueHighWatermark (262144),
+m_OutQueueLowWatermark (65536),
+m_OutQueueLimit (4194304),
+m_UseReusePort (false) {}
 
 WorldSocketMgr::~WorldSocketMgr ()
 {
   if (m_NetThreads)
     delete [] m_NetThreads;
-  
-  if(m_Acceptor)
-    delete m_Acceptor;
+
+  for (AcceptorList::iterator i = m_Acceptors.begin (); i != m_Acceptors.end (); ++i)
+    delete *i;
 }
 
 int
@@ -261,18 +264,60 @@ WorldSocketMgr::StartReactiveIO (ACE_UINT16 port, const char* address)
       return -1;
     }
 
-  WorldSocket::Acceptor *acc = new WorldSocket::Acceptor;
-  m_Acceptor = acc;
+  int high_watermark = sConfig.GetIntDefault ("Network.OutQueue.HighWatermark", 262144);
+  int low_watermark = sConfig.GetIntDefault ("Network.OutQueue.LowWatermark", 65536);
+  int queue_limit = sConfig.GetIntDefault ("Network.OutQueue.Limit", 4194304);
 
-  ACE_INET_Addr listen_addr (port, address);
+  if (high_watermark <= 0 || low_watermark < 0 || low_watermark > high_watermark || queue_limit < 0)
+    {
+      sLog.outError ("Network.OutQueue settings are wrong in your config file");
+      return -1;
+    }
+
+  m_OutQueueHighWatermark = static_cast<size_t> (high_watermark);
+  m_OutQueueLowWatermark = static_cast<size_t> (low_watermark);
+  m_OutQueueLimit = static_cast<size_t> (queue_limit);
+
+  int backlog = sConfig.GetIntDefault ("Network.Backlog", 128);
 
-  if (acc->open (listen_addr, m_NetThreads[0].GetReactor (), ACE_NONBLOCK) == -1)
+  if (backlog <= 0)
     {
-      sLog.outError ("Failed to open acceptor ,check if the port is free");
+      sLog.outError ("Network.Backlog is wrong in your config file");
       return -1;
     }
 
-  for (size_t i = 0; i < m_NetThreadsCount; ++i)
+  m_UseReusePort = sConfig.GetBoolDefault ("Network.ReusePort", false);
+
+#ifndef SO_REUSEPORT
+  if (m_UseReusePort)
+    {
+      sLog.outError ("Network.ReusePort is not supported on this platform, using one listener");
+      m_UseReusePort = false;
+    }
+#endif // SO_REUSEPORT
+
+  ACE_INET_Addr listen_addr (port, address);
+
+  // Without SO_REUSEPORT thread 0 only accepts and hands sockets to others,
+  // with it every other thread accepts and keeps its own connections.
+  const size_t first_acceptor = m_UseReusePort ? 1 : 0;
+  const size_t last_acceptor = m_UseReusePort ? m_NetThreadsCount : 1;
+
+  for (size_t i = first_acceptor; i < last_acceptor; ++i)
+    {
+      WorldSocket::Acceptor *acc = new WorldSocket::Acceptor;
+      m_Acceptors.push_back (acc);
+
+      acc->acceptor ().SetOptions (backlog, m_UseReusePort);
+
+      if (acc->open (listen_addr, m_NetThreads[i].GetReactor (), ACE_NONBLOCK) == -1)
+        {
+          sLog.outError ("Failed to open acceptor ,check if the port is free");
+          return -1;
+        }
+    }
+
+  for (size_t i = m_UseReusePort ? 1 : 0; i < m_NetThreadsCount; ++i)
     m_NetThreads[i].Start ();
 
   return 0;
@@ -293,9 +338,9 @@ WorldSocketMgr::StartNetwork (ACE_UINT16 port, const char* address)
 void
 WorldSocketMgr::StopNetwork ()
 {
-  if (m_Acceptor)
+  for (AcceptorList::iterator i = m_Acceptors.begin (); i != m_Acceptors.end (); ++i)
     {
-      WorldSocket::Acceptor* acc = dynamic_cast<WorldSocket::Acceptor*> (m_Acceptor);
+      WorldSocket::Acceptor* acc = dynamic_cast<WorldSocket::Acceptor*> (*i);
 
       if (acc)
         acc->close ();
@@ -348,19 +393,31 @@ WorldSocketMgr::OnSocketOpen (WorldSocket* sock)
       }
   
   sock->m_OutBufferSize = static_cast<size_t> (m_SockOutUBuff);
+  sock->m_OutQueueHighWatermark = m_OutQueueHighWatermark;
+  sock->m_OutQueueLowWatermark = m_OutQueueLowWatermark;
+  sock->m_OutQueueLimit = m_OutQueueLimit;
+
+  ACE_ASSERT (m_NetThreadsCount >= 1);
+
+  // socket stays at the network thread which accepted it
+  if (m_UseReusePort)
+    {
+      for (size_t i = 1; i < m_NetThreadsCount; ++i)
+        if (m_NetThreads[i].GetReactor () == sock->reactor ())
+          return m_NetThreads[i].AddSocket (sock);
+
+      sLog.outError ("WorldSocketMgr::OnSocketOpen: socket accepted by unknown reactor");
+      return -1;
+    }
 
   // we skip the Acceptor Thread
   size_t min = 1;
 
-  ACE_ASSERT (m_NetThreadsCount >= 1);
-
   for (size_t i = 1; i < m_NetThreadsCount; ++i)
     if (m_NetThreads[i].Connections () < m_NetThreads[min].Connections ())
       min = i;
 
   return m_NetThreads[min].AddSocket (sock);
-
-  return 0;
 }
 
 WorldSocketMgr*
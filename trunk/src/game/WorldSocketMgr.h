@@ -29,6 +29,8 @@
 #include <ace/Singleton.h>
 #include <ace/Thread_Mutex.h>
 
+#include <vector>
+
 class WorldSocket;
 class ReactorRunnable;
 class ACE_Event_Handler;
@@ -67,8 +69,16 @@ private:
   int m_SockOutKBuff;
   int m_SockOutUBuff;
   bool m_UseNoDelay;
-  
-  ACE_Event_Handler* m_Acceptor;
+
+  size_t m_OutQueueHighWatermark;
+  size_t m_OutQueueLowWatermark;
+  size_t m_OutQueueLimit;
+
+  /// Every network thread has own listener (SO_REUSEPORT).
+  bool m_UseReusePort;
+
+  typedef std::vector<ACE_Event_Handler*> AcceptorList;
+  AcceptorList m_Acceptors;
 };
 
 #define sWorldSocketMgr WorldSocketMgr::Instance ()
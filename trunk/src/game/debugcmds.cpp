@@ -30,6 +30,9 @@
 #include "GossipDef.h"
 #include "Language.h"
 #include "MapManager.h"
+#include "ObjectMgr.h"
+#include "WorldSocket.h"
+#include "VMapFactory.h"
 #include <fstream>
 
 bool ChatHandler::HandleDebugInArcCommand(const char* /*args*/)
@@ -515,3 +518,55 @@ bool ChatHandler::HandleGetItemState(const char* args)
 
     return true;
 }
+
+bool ChatHandler::HandleDebugNetStatsCommand(const char* args)
+{
+    Player* player = NULL;
+
+    if (*args)
+    {
+        std::string name = args;
+
+        if(!normalizePlayerName(name))
+        {
+            SendSysMessage(LANG_PLAYER_NOT_FOUND);
+            SetSentErrorMessage(true);
+            return false;
+        }
+
+        player = objmgr.GetPlayer(name.c_str());
+    }
+    else
+        player = getSelectedPlayer();
+
+    if(!player)
+    {
+        SendSysMessage(LANG_PLAYER_NOT_FOUND);
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    WorldSocketSendStats stats;
+    if(!player->GetSession()->GetSendStats(stats))
+    {
+        PSendSysMessage("Player %s has no connection.", player->GetName());
+        return true;
+    }
+
+    PSendSysMessage("Send queue of %s: %u bytes (peak %u), congested %u times",
+        player->GetName(), uint32(stats.QueuedBytes), uint32(stats.QueuedBytesPeak), stats.CongestedCount);
+    PSendSysMessage("Dropped: %u packets, " I64FMTD " bytes. Flush time: last %u ms, max %u ms",
+        stats.DroppedPackets, stats.DroppedBytes, stats.LastFlushTime, stats.MaxFlushTime);
+
+    return true;
+}
+
+bool ChatHandler::HandleDebugVMapStatsCommand(const char* /*args*/)
+{
+    uint32 hits, misses;
+    VMAP::VMapFactory::createOrGetVMapManager()->getLineOfSightCacheStats(hits, misses);
+
+    uint32 total = hits + misses;
+    PSendSysMessage("Line of sight cache: %u hits, %u misses (%u%% hits)", hits, misses, total ? uint32(uint64(hits) * 100 / total) : 0);
+    return true;
+}
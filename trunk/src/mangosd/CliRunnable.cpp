@@ -36,6 +36,7 @@
 #include "MapManager.h"
 #include "PlayerDump.h"
 #include "Player.h"
+#include "UpdateFieldsStorage.h"
 
 //CliCommand and CliCommandHolder are defined in World.h to avoid cyclic deps
 
@@ -72,6 +73,7 @@ void CliSave(char*,pPrintf);
 void CliSend(char*,pPrintf);
 void CliPLimit(char*,pPrintf);
 void CliSetPassword(char*,pPrintf);
+void CliConvertData(char*,pPrintf);
 /// Table of known commands
 const CliCommand Commands[]=
 {
@@ -105,7 +107,8 @@ const CliCommand Commands[]=
     {"saveall", &CliSave,"Save all players"},
     {"send", &CliSend,"Send message to a player"},
     {"tele", &CliTele,"Teleport player to location"},
-    {"plimit", &CliPLimit,"Show or set player login limitations"}
+    {"plimit", &CliPLimit,"Show or set player login limitations"},
+    {"convertdata", &CliConvertData,"Convert characters and items data to binary or text format"}
 };
 /// \todo Need some pragma pack? Else explain why in a comment.
 #define CliTotalCmds sizeof(Commands)/sizeof(CliCommand)
@@ -1192,6 +1195,36 @@ void CliPLimit(char *args,pPrintf zprintf)
     zprintf("Player limits: amount %u, min. security level %s.\r\n",pLimit,secName);
 }
 
+/// Convert `data` of all characters and items to binary or text format
+void CliConvertData(char *args,pPrintf zprintf)
+{
+    char* format = strtok(args, " ");
+    if(!format || (strcmp(format,"binary") != 0 && strcmp(format,"text") != 0))
+    {
+        zprintf("Syntax is: convertdata binary|text\r\n");
+        return;
+    }
+
+    // rows of online players would be overwritten by their saves
+    if(sWorld.GetActiveAndQueuedSessionCount())
+    {
+        zprintf("Convert data only without players online (use plimit to close the server)\r\n");
+        return;
+    }
+
+    bool binary = strcmp(format,"binary") == 0;
+    if(binary && !UpdateFieldsStorage::IsBinarySupportedByDB())
+    {
+        zprintf("Binary data requires sql/updates/6762_* applied to character DB\r\n");
+        return;
+    }
+
+    uint32 characters = UpdateFieldsStorage::ConvertTable("characters", binary);
+    uint32 items = UpdateFieldsStorage::ConvertTable("item_instance", binary);
+
+    zprintf("Converted to %s format: %u characters, %u items\r\n", format, characters, items);
+}
+
 /// @}
 
 #ifdef linux
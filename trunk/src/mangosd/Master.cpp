@@ -133,9 +133,9 @@ public:
       {
         loopCounter = 0;
         sLog.outDetail ("Ping MySQL to keep connection alive");
-        delete WorldDatabase.Query ("SELECT 1 FROM command LIMIT 1");
-        delete loginDatabase.Query ("SELECT 1 FROM realmlist LIMIT 1");
-        delete CharacterDatabase.Query ("SELECT 1 FROM bugreport LIMIT 1");
+        WorldDatabase.Ping ("SELECT 1 FROM command LIMIT 1");
+        loginDatabase.Ping ("SELECT 1 FROM realmlist LIMIT 1");
+        CharacterDatabase.Ping ("SELECT 1 FROM bugreport LIMIT 1");
       }
   }
 
@@ -344,6 +344,7 @@ int Master::Run()
     clearOnlineAccounts();
 
     ///- Wait for delay threads to end
+    CharacterDatabase.CloseQueryPool();
     CharacterDatabase.HaltDelayThread();
     WorldDatabase.HaltDelayThread();
     loginDatabase.HaltDelayThread();
@@ -430,6 +431,22 @@ bool Master::_StartDB()
         return false;
     }
 
+    ///- Open extra Character database connections for async queries
+    int queryConnections = sConfig.GetIntDefault("CharacterDatabase.QueryConnections", 1);
+    for(int i = 0; i < queryConnections; ++i)
+    {
+        DatabaseType* queryDatabase = new DatabaseType;
+        if(!queryDatabase->Initialize(dbstring.c_str()))
+        {
+            sLog.outError("Cannot connect to Character database %s for async queries",dbstring.c_str());
+            delete queryDatabase;
+            return false;
+        }
+        CharacterDatabase.AddQueryConnection(queryDatabase);
+    }
+    if(queryConnections > 0)
+        sLog.outString("Character Database: %i connections for async queries", queryConnections);
+
     ///- Get login database info from configuration file
     if(!sConfig.GetString("LoginDatabaseInfo", &dbstring))
     {
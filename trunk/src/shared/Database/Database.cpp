@@ -18,16 +18,92 @@
 
 #include "DatabaseEnv.h"
 #include "Config/ConfigEnv.h"
+#include "Database/SqlOperations.h"
 
 #include <ctime>
 #include <iostream>
 #include <fstream>
 
+/// Ids of prepared statement sql texts, same for all connections
+typedef std::map<std::string, uint32> SqlStatementIDs;
+static SqlStatementIDs sSqlStatementIDs;
+static ZThread::FastMutex sSqlStatementIDsLock;
+
 Database::~Database()
 {
     /*Delete objects*/
 }
 
+void Database::AddQueryConnection(Database* db)
+{
+    ASSERT(db->m_threadBody && m_threadBody);
+
+    db->m_threadBody->SetWriteThread(m_threadBody);
+    m_queryPool.push_back(db);
+}
+
+void Database::CloseQueryPool()
+{
+    // each connection finishes its queue at destruction
+    for(QueryPool::iterator itr = m_queryPool.begin(); itr != m_queryPool.end(); ++itr)
+        delete *itr;
+
+    m_queryPool.clear();
+}
+
+void Database::Ping(const char *sql)
+{
+    delete Query(sql);
+
+    for(QueryPool::iterator itr = m_queryPool.begin(); itr != m_queryPool.end(); ++itr)
+        delete (*itr)->Query(sql);
+}
+
+SqlDelayThread* Database::GetQueryThread()
+{
+    if(m_queryPool.empty())
+        return m_threadBody;
+
+    SqlDelayThread* thread = m_queryPool[0]->m_threadBody;
+    size_t minSize = thread->GetQueueSize();
+
+    for(size_t i = 1; i < m_queryPool.size() && minSize > 0; ++i)
+    {
+        size_t size = m_queryPool[i]->m_threadBody->GetQueueSize();
+        if(size < minSize)
+        {
+            thread = m_queryPool[i]->m_threadBody;
+            minSize = size;
+        }
+    }
+
+    return thread;
+}
+
+SqlTransaction* Database::GetThreadTransaction()
+{
+    ZThread::Guard<ZThread::FastMutex> guard(m_tranQueuesLock);
+
+    TransactionQueues::const_iterator itr = m_tranQueues.find(ZThread::ThreadImpl::current());
+    return itr != m_tranQueues.end() ? itr->second : NULL;
+}
+
+SqlTransaction* Database::SetThreadTransaction(SqlTransaction* tran)
+{
+    ZThread::Guard<ZThread::FastMutex> guard(m_tranQueuesLock);
+
+    SqlTransaction*& current = m_tranQueues[ZThread::ThreadImpl::current()];
+    SqlTransaction* old = current;
+    current = tran;
+    return old;
+}
+
+size_t Database::GetTransactionSize()
+{
+    SqlTransaction* tran = GetThreadTransaction();
+    return tran ? tran->GetSize() : 0;
+}
+
 bool Database::Initialize(const char *)
 {
     // Enable logging of SQL commands (usally only GM commands)
@@ -106,6 +182,56 @@ bool Database::PExecuteLog(const char * format,...)
     return Execute(szQuery);
 }
 
+void Database::InitStatement(SqlStatementID& id, const char *sql)
+{
+    ZThread::Guard<ZThread::FastMutex> guard(sSqlStatementIDsLock);
+
+    if(id.m_id)
+        return;
+
+    SqlStatementIDs::const_iterator itr = sSqlStatementIDs.find(sql);
+    if(itr == sSqlStatementIDs.end())
+        itr = sSqlStatementIDs.insert(SqlStatementIDs::value_type(sql, uint32(sSqlStatementIDs.size() + 1))).first;
+
+    id.m_sql = itr->first.c_str();
+    id.m_id = itr->second;
+}
+
+QueryResult* Database::PreparedQuery(SqlStatementID& id, const char *sql, SqlStmtParameters const& params)
+{
+    InitStatement(id, sql);
+    return DoPreparedQuery(id.m_id, id.m_sql, params);
+}
+
+bool Database::PreparedExecute(SqlStatementID& id, const char *sql, SqlStmtParameters const& params)
+{
+    if (!*this)
+        return false;
+
+    InitStatement(id, sql);
+
+    // don't use queued execution if it has not been initialized
+    if (!m_threadBody) return DoPreparedExecute(id.m_id, id.m_sql, params);
+
+    if (SqlTransaction* tran = GetThreadTransaction())
+    {                                                       // Statement for transaction
+        tran->DelayExecute(id, params);
+    }
+    else
+    {
+        // Simple sql statement
+        m_threadBody->Delay(new SqlPreparedStatement(id, params));
+    }
+
+    return true;
+}
+
+bool Database::DirectPreparedExecute(SqlStatementID& id, const char *sql, SqlStmtParameters const& params)
+{
+    InitStatement(id, sql);
+    return DoPreparedExecute(id.m_id, id.m_sql, params);
+}
+
 void Database::SetResultQueue(SqlResultQueue * queue)
 {
     m_queryQueues[ZThread::ThreadImpl::current()] = queue;
@@ -20,6 +20,7 @@
 #define DATABASE_H
 
 #include "zthread/Thread.h"
+#include "zthread/FastMutex.h"
 #include "../src/zthread/ThreadImpl.h"
 #include "Utilities/HashMap.h"
 #include "Database/SqlDelayThread.h"
@@ -27,6 +28,8 @@
 class SqlTransaction;
 class SqlResultQueue;
 class SqlQueryHolder;
+class SqlStatementID;
+class SqlStmtParameters;
 
 typedef HM_NAMESPACE::hash_map<ZThread::ThreadImpl*, SqlTransaction*> TransactionQueues;
 typedef HM_NAMESPACE::hash_map<ZThread::ThreadImpl*, SqlResultQueue*> QueryQueues;
@@ -39,10 +42,27 @@ class MANGOS_DLL_SPEC Database
         Database() : m_threadBody(NULL), m_delayThread(NULL) {};
 
         TransactionQueues m_tranQueues;                     ///< Transaction queues from diff. threads
+        ZThread::FastMutex m_tranQueuesLock;                ///< Guards m_tranQueues, changed by map update threads also
         QueryQueues m_queryQueues;                          ///< Query queues from diff threads
         SqlDelayThread* m_threadBody;                       ///< Pointer to delay sql executer
         ZThread::Thread* m_delayThread;                     ///< Pointer to executer thread
 
+        typedef std::vector<Database*> QueryPool;
+        QueryPool m_queryPool;                              ///< Extra connections for async queries
+
+        /// Delay thread for async queries: least loaded pool connection, or own one without pool
+        SqlDelayThread* GetQueryThread();
+
+        /// Queued transaction of current thread or NULL
+        SqlTransaction* GetThreadTransaction();
+        /// Set queued transaction of current thread (NULL to end it), returns previous one
+        SqlTransaction* SetThreadTransaction(SqlTransaction* tran);
+
+        /// Backend part of prepared statements: prepare sql of id at first use on this connection,
+        /// then bind params and run it
+        virtual QueryResult* DoPreparedQuery(uint32 id, const char *sql, SqlStmtParameters const& params) = 0;
+        virtual bool DoPreparedExecute(uint32 id, const char *sql, SqlStmtParameters const& params) = 0;
+
     public:
 
         virtual ~Database();
@@ -51,6 +71,14 @@ class MANGOS_DLL_SPEC Database
         virtual void InitDelayThread() = 0;
         virtual void HaltDelayThread() = 0;
 
+        /// Async queries and query holders will run also at db (own connection and delay thread),
+        /// db is deleted by CloseQueryPool
+        void AddQueryConnection(Database* db);
+        void CloseQueryPool();
+
+        /// Run sql at own and query pool connections to keep them from server idle timeout
+        void Ping(const char *sql);
+
         virtual QueryResult* Query(const char *sql) = 0;
         QueryResult* PQuery(const char *format,...) ATTR_PRINTF(2,3);
 
@@ -80,6 +108,15 @@ class MANGOS_DLL_SPEC Database
         // Writes SQL commands to a LOG file (see mangosd.conf "LogSQL")
         bool PExecuteLog(const char *format,...) ATTR_PRINTF(2,3);
 
+        /// Prepared statements, sql uses '?' for params: id is assigned at first use of sql (see SqlStatementID)
+        /// PreparedExecute is queued like Execute (also to transaction of current thread)
+        QueryResult* PreparedQuery(SqlStatementID& id, const char *sql, SqlStmtParameters const& params);
+        bool PreparedExecute(SqlStatementID& id, const char *sql, SqlStmtParameters const& params);
+        bool DirectPreparedExecute(SqlStatementID& id, const char *sql, SqlStmtParameters const& params);
+
+        /// Assign id to sql if not done yet, same sql gets same id
+        static void InitStatement(SqlStatementID& id, const char *sql);
+
         virtual bool BeginTransaction()                     // nothing do if DB not support transactions
         {
             return true;
@@ -92,10 +129,18 @@ class MANGOS_DLL_SPEC Database
         {
             return false;
         }
+        /// count of statements in transaction of current thread (0 if no transaction or it isn't queued)
+        size_t GetTransactionSize();
+
+        /// count of async statements and transactions waiting in delay thread of main connection
+        size_t GetWriteQueueSize() { return m_threadBody ? m_threadBody->GetQueueSize() : 0; }
 
         virtual operator bool () const = 0;
 
         virtual unsigned long escape_string(char *to, const char *from, unsigned long length) { strncpy(to,from,length); return length; }
+
+        /// column can store binary strings, false for backends without binary support (sqlite 2 strings end at 0)
+        virtual bool IsBlobColumn(const char * /*table*/, const char * /*column*/) { return false; }
         void escape_string(std::string& str);
 
         // must be called before first query in thread (one time for thread using one from existed Database objects)
@@ -26,6 +26,8 @@
 #include "Database/DBCStores.h"
 #include "Database/Field.h"
 #include "Database/QueryResult.h"
+#include "Database/QueryResultStmt.h"
+#include "Database/SqlPreparedStatement.h"
 
 #ifdef DO_POSTGRESQL
 #include "Database/QueryResultPostgre.h"
@@ -29,7 +29,7 @@ Database::AsyncQuery(Class *object, void (Class::*method)(QueryResult*), const c
     ZThread::ThreadImpl * queryThread = ZThread::ThreadImpl::current();
     QueryQueues::iterator itr = m_queryQueues.find(queryThread);
     if (itr == m_queryQueues.end()) return false;
-    m_threadBody->Delay(new SqlQuery(sql, new MaNGOS::QueryCallback<Class>(object, method), itr->second));
+    GetQueryThread()->Delay(new SqlQuery(sql, new MaNGOS::QueryCallback<Class>(object, method), itr->second));
     return true;
 }
 
@@ -41,7 +41,7 @@ Database::AsyncQuery(Class *object, void (Class::*method)(QueryResult*, ParamTyp
     ZThread::ThreadImpl * queryThread = ZThread::ThreadImpl::current();
     QueryQueues::iterator itr = m_queryQueues.find(queryThread);
     if (itr == m_queryQueues.end()) return false;
-    m_threadBody->Delay(new SqlQuery(sql, new MaNGOS::QueryCallback<Class, ParamType1>(object, method, (QueryResult*)NULL, param1), itr->second));
+    GetQueryThread()->Delay(new SqlQuery(sql, new MaNGOS::QueryCallback<Class, ParamType1>(object, method, (QueryResult*)NULL, param1), itr->second));
     return true;
 }
 
@@ -53,7 +53,7 @@ Database::AsyncQuery(void (*method)(QueryResult*, ParamType1), ParamType1 param1
     ZThread::ThreadImpl * queryThread = ZThread::ThreadImpl::current();
     QueryQueues::iterator itr = m_queryQueues.find(queryThread);
     if (itr == m_queryQueues.end()) return false;
-    m_threadBody->Delay(new SqlQuery(sql, new MaNGOS::SQueryCallback<ParamType1>(method, (QueryResult*)NULL, param1), itr->second));
+    GetQueryThread()->Delay(new SqlQuery(sql, new MaNGOS::SQueryCallback<ParamType1>(method, (QueryResult*)NULL, param1), itr->second));
     return true;
 }
 
@@ -128,7 +128,7 @@ Database::DelayQueryHolder(Class *object, void (Class::*method)(QueryResult*, Sq
     ZThread::ThreadImpl * queryThread = ZThread::ThreadImpl::current();
     QueryQueues::iterator itr = m_queryQueues.find(queryThread);
     if (itr == m_queryQueues.end()) return false;
-    holder->Execute(new MaNGOS::QueryCallback<Class, SqlQueryHolder*>(object, method, (QueryResult*)NULL, holder), m_threadBody, itr->second);
+    holder->Execute(new MaNGOS::QueryCallback<Class, SqlQueryHolder*>(object, method, (QueryResult*)NULL, holder), GetQueryThread(), itr->second);
     return true;
 }
 
@@ -140,6 +140,6 @@ Database::DelayQueryHolder(Class *object, void (Class::*method)(QueryResult*, Sq
     ZThread::ThreadImpl * queryThread = ZThread::ThreadImpl::current();
     QueryQueues::iterator itr = m_queryQueues.find(queryThread);
     if (itr == m_queryQueues.end()) return false;
-    holder->Execute(new MaNGOS::QueryCallback<Class, SqlQueryHolder*, ParamType1>(object, method, (QueryResult*)NULL, holder, param1), m_threadBody, itr->second);
+    holder->Execute(new MaNGOS::QueryCallback<Class, SqlQueryHolder*, ParamType1>(object, method, (QueryResult*)NULL, holder, param1), GetQueryThread(), itr->second);
     return true;
 }
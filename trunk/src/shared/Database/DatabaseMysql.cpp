@@ -57,9 +57,14 @@ DatabaseMysql::DatabaseMysql() : Database(), mMysql(0)
 
 DatabaseMysql::~DatabaseMysql()
 {
+    CloseQueryPool();
+
     if (m_delayThread)
         HaltDelayThread();
 
+    for(StmtCache::const_iterator itr = m_stmtCache.begin(); itr != m_stmtCache.end(); ++itr)
+        mysql_stmt_close(itr->second);
+
     if (mMysql)
         mysql_close(mMysql);
 
@@ -235,11 +240,9 @@ bool DatabaseMysql::Execute(const char *sql)
     // don't use queued execution if it has not been initialized
     if (!m_threadBody) return DirectExecute(sql);
 
-    tranThread = ZThread::ThreadImpl::current();            // owner of this transaction
-    TransactionQueues::iterator i = m_tranQueues.find(tranThread);
-    if (i != m_tranQueues.end() && i->second != NULL)
+    if (SqlTransaction* tran = GetThreadTransaction())
     {                                                       // Statement for transaction
-        i->second->DelayExecute(sql);
+        tran->DelayExecute(sql);
     }
     else
     {
@@ -279,6 +282,236 @@ bool DatabaseMysql::DirectExecute(const char* sql)
     return true;
 }
 
+MYSQL_STMT* DatabaseMysql::_GetStatement(uint32 id, const char *sql)
+{
+    StmtCache::const_iterator itr = m_stmtCache.find(id);
+    if (itr != m_stmtCache.end())
+        return itr->second;
+
+    MYSQL_STMT* stmt = mysql_stmt_init(mMysql);
+    if (!stmt)
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("SQL ERROR: %s", mysql_error(mMysql));
+        return NULL;
+    }
+
+    if (mysql_stmt_prepare(stmt, sql, strlen(sql)))
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("SQL ERROR: %s", mysql_stmt_error(stmt));
+        mysql_stmt_close(stmt);
+        return NULL;
+    }
+
+    // stored results get max_length of columns, it sizes the string fetch buffers
+    my_bool updateMaxLength = 1;
+    mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength);
+
+    m_stmtCache[id] = stmt;
+    return stmt;
+}
+
+bool DatabaseMysql::_ExecuteStatement(MYSQL_STMT* stmt, const char *sql, SqlStmtParameters const& params)
+{
+    if (mysql_stmt_param_count(stmt) != params.size())
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("SQL ERROR: statement has %u params, %u given", uint32(mysql_stmt_param_count(stmt)), uint32(params.size()));
+        return false;
+    }
+
+    std::vector<MYSQL_BIND> bind(params.size());
+    if (!bind.empty())
+    {
+        memset(&bind[0], 0, bind.size() * sizeof(MYSQL_BIND));
+
+        for (size_t i = 0; i < params.size(); ++i)
+        {
+            SqlStmtParameters::Value const& value = params[i];
+            switch (value.type)
+            {
+                case SqlStmtParameters::VALUE_INT64:
+                case SqlStmtParameters::VALUE_UINT64:
+                    bind[i].buffer_type = MYSQL_TYPE_LONGLONG;
+                    bind[i].buffer = (void*)&value.number;
+                    bind[i].is_unsigned = value.type == SqlStmtParameters::VALUE_UINT64;
+                    break;
+                case SqlStmtParameters::VALUE_DOUBLE:
+                    bind[i].buffer_type = MYSQL_TYPE_DOUBLE;
+                    bind[i].buffer = (void*)&value.number;
+                    break;
+                case SqlStmtParameters::VALUE_STRING:
+                case SqlStmtParameters::VALUE_BINARY:
+                    bind[i].buffer_type = value.type == SqlStmtParameters::VALUE_STRING ? MYSQL_TYPE_STRING : MYSQL_TYPE_BLOB;
+                    bind[i].buffer = (void*)value.str.data();
+                    bind[i].buffer_length = value.str.size();
+                    bind[i].length = &bind[i].buffer_length;
+                    break;
+            }
+        }
+
+        if (mysql_stmt_bind_param(stmt, &bind[0]))
+        {
+            sLog.outErrorDb("SQL: %s", sql);
+            sLog.outErrorDb("SQL ERROR: %s", mysql_stmt_error(stmt));
+            return false;
+        }
+    }
+
+    #ifdef MANGOS_DEBUG
+    uint32 _s = getMSTime();
+    #endif
+    if (mysql_stmt_execute(stmt))
+    {
+        sLog.outErrorDb("SQL: %s [%s]", sql, params.ToString().c_str());
+        sLog.outErrorDb("SQL ERROR: %s", mysql_stmt_error(stmt));
+        return false;
+    }
+    else
+    {
+        #ifdef MANGOS_DEBUG
+        sLog.outDebug("[%u ms] SQL: %s [%s]", getMSTimeDiff(_s,getMSTime()), sql, params.ToString().c_str());
+        #endif
+    }
+
+    return true;
+}
+
+QueryResult* DatabaseMysql::DoPreparedQuery(uint32 id, const char *sql, SqlStmtParameters const& params)
+{
+    if (!mMysql)
+        return NULL;
+
+    // guarded block for thread-safe mySQL request, statement is used until all rows are copied
+    ZThread::Guard<ZThread::FastMutex> query_connection_guard(mMutex);
+
+    MYSQL_STMT* stmt = _GetStatement(id, sql);
+    if (!stmt || !_ExecuteStatement(stmt, sql, params))
+        return NULL;
+
+    if (mysql_stmt_store_result(stmt))
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("query ERROR: %s", mysql_stmt_error(stmt));
+        return NULL;
+    }
+
+    // fields of stored result, with max_length
+    MYSQL_RES* metadata = mysql_stmt_result_metadata(stmt);
+    if (!metadata)
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("query ERROR: statement returns no result set");
+        mysql_stmt_free_result(stmt);
+        return NULL;
+    }
+
+    uint32 fieldCount = mysql_num_fields(metadata);
+    MYSQL_FIELD* fields = mysql_fetch_fields(metadata);
+
+    QueryResultStmt* queryResult = new QueryResultStmt(fieldCount);
+
+    // one fetch buffer for a row: numbers are fetched binary, other columns as strings
+    // (decimals and dates keep their text form)
+    std::vector<MYSQL_BIND> bind(fieldCount);
+    std::vector<uint64> numbers(fieldCount);
+    std::vector<my_bool> nulls(fieldCount);
+    std::vector<unsigned long> lengths(fieldCount);
+    std::vector<std::vector<char> > strings(fieldCount);
+
+    if (fieldCount)
+        memset(&bind[0], 0, fieldCount * sizeof(MYSQL_BIND));
+
+    for (uint32 i = 0; i < fieldCount; ++i)
+    {
+        queryResult->SetField(i, fields[i].name, QueryResultMysql::ConvertNativeType(fields[i].type));
+
+        switch (fields[i].type)
+        {
+            case MYSQL_TYPE_TINY:
+            case MYSQL_TYPE_SHORT:
+            case MYSQL_TYPE_LONG:
+            case MYSQL_TYPE_INT24:
+            case MYSQL_TYPE_LONGLONG:
+                bind[i].buffer_type = MYSQL_TYPE_LONGLONG;
+                bind[i].buffer = &numbers[i];
+                bind[i].is_unsigned = (fields[i].flags & UNSIGNED_FLAG) != 0;
+                break;
+            case MYSQL_TYPE_FLOAT:
+            case MYSQL_TYPE_DOUBLE:
+                bind[i].buffer_type = MYSQL_TYPE_DOUBLE;
+                bind[i].buffer = &numbers[i];
+                break;
+            default:
+                strings[i].resize(fields[i].max_length + 1);
+                bind[i].buffer_type = MYSQL_TYPE_STRING;
+                bind[i].buffer = &strings[i][0];
+                bind[i].buffer_length = strings[i].size();
+                break;
+        }
+
+        bind[i].is_null = &nulls[i];
+        bind[i].length = &lengths[i];
+    }
+
+    if (fieldCount && mysql_stmt_bind_result(stmt, &bind[0]))
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("query ERROR: %s", mysql_stmt_error(stmt));
+        delete queryResult;
+        queryResult = NULL;
+    }
+    else
+    {
+        int fetchResult;
+        while ((fetchResult = mysql_stmt_fetch(stmt)) == 0 || fetchResult == MYSQL_DATA_TRUNCATED)
+        {
+            for (uint32 i = 0; i < fieldCount; ++i)
+            {
+                if (nulls[i])
+                    queryResult->AddNull();
+                else if (bind[i].buffer_type == MYSQL_TYPE_DOUBLE)
+                {
+                    double value;
+                    memcpy(&value, &numbers[i], sizeof(value));
+                    queryResult->AddDouble(value);
+                }
+                else if (bind[i].buffer_type != MYSQL_TYPE_LONGLONG)
+                    queryResult->AddString(&strings[i][0], lengths[i]);
+                else if (bind[i].is_unsigned)
+                    queryResult->AddUInt64(numbers[i]);
+                else
+                    queryResult->AddInt64(int64(numbers[i]));
+            }
+        }
+    }
+
+    mysql_stmt_free_result(stmt);
+    mysql_free_result(metadata);
+    // end guarded block
+
+    if (queryResult && !queryResult->EndRows())
+    {
+        delete queryResult;
+        return NULL;
+    }
+
+    return queryResult;
+}
+
+bool DatabaseMysql::DoPreparedExecute(uint32 id, const char *sql, SqlStmtParameters const& params)
+{
+    if (!mMysql)
+        return false;
+
+    // guarded block for thread-safe mySQL request
+    ZThread::Guard<ZThread::FastMutex> query_connection_guard(mMutex);
+
+    MYSQL_STMT* stmt = _GetStatement(id, sql);
+    return stmt && _ExecuteStatement(stmt, sql, params);
+}
+
 bool DatabaseMysql::_TransactionCmd(const char *sql)
 {
     if (mysql_query(mMysql, sql))
@@ -313,14 +546,9 @@ bool DatabaseMysql::BeginTransaction()
         return true;                                        // transaction started
     }
 
-    tranThread = ZThread::ThreadImpl::current();            // owner of this transaction
-    TransactionQueues::iterator i = m_tranQueues.find(tranThread);
-    if (i != m_tranQueues.end() && i->second != NULL)
-        // If for thread exists queue and also contains transaction
-        // delete that transaction (not allow trans in trans)
-        delete i->second;
-
-    m_tranQueues[tranThread] = new SqlTransaction();
+    // If for thread exists queue and also contains transaction
+    // delete that transaction (not allow trans in trans)
+    delete SetThreadTransaction(new SqlTransaction());
 
     return true;
 }
@@ -341,12 +569,9 @@ bool DatabaseMysql::CommitTransaction()
         return _res;
     }
 
-    tranThread = ZThread::ThreadImpl::current();
-    TransactionQueues::iterator i = m_tranQueues.find(tranThread);
-    if (i != m_tranQueues.end() && i->second != NULL)
+    if (SqlTransaction* tran = SetThreadTransaction(NULL))
     {
-        m_threadBody->Delay(i->second);
-        i->second = NULL;
+        m_threadBody->Delay(tran);
         return true;
     }
     else
@@ -369,13 +594,7 @@ bool DatabaseMysql::RollbackTransaction()
         return _res;
     }
 
-    tranThread = ZThread::ThreadImpl::current();
-    TransactionQueues::iterator i = m_tranQueues.find(tranThread);
-    if (i != m_tranQueues.end() && i->second != NULL)
-    {
-        delete i->second;
-        i->second = NULL;
-    }
+    delete SetThreadTransaction(NULL);
     return true;
 }
 
@@ -387,6 +606,17 @@ unsigned long DatabaseMysql::escape_string(char *to, const char *from, unsigned
     return(mysql_real_escape_string(mMysql, to, from, length));
 }
 
+bool DatabaseMysql::IsBlobColumn(const char *table, const char *column)
+{
+    QueryResult* result = PQuery("SHOW COLUMNS FROM `%s` LIKE '%s'", table, column);
+    if(!result)
+        return false;
+
+    std::string type = result->Fetch()[1].GetCppString();
+    delete result;
+    return type.find("blob") != std::string::npos;
+}
+
 void DatabaseMysql::InitDelayThread()
 {
     assert(!m_delayThread);
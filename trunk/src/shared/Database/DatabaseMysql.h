@@ -58,10 +58,15 @@ class MANGOS_DLL_SPEC DatabaseMysql : public Database
         unsigned long escape_string(char *to, const char *from, unsigned long length);
         using Database::escape_string;
 
+        bool IsBlobColumn(const char *table, const char *column);
+
         // must be call before first query in thread
         void ThreadStart();
         // must be call before finish thread run
         void ThreadEnd();
+    protected:
+        QueryResult* DoPreparedQuery(uint32 id, const char *sql, SqlStmtParameters const& params);
+        bool DoPreparedExecute(uint32 id, const char *sql, SqlStmtParameters const& params);
     private:
         ZThread::FastMutex mMutex;
 
@@ -69,9 +74,14 @@ class MANGOS_DLL_SPEC DatabaseMysql : public Database
 
         MYSQL *mMysql;
 
+        typedef HM_NAMESPACE::hash_map<uint32, MYSQL_STMT*> StmtCache;
+        StmtCache m_stmtCache;                              ///< Prepared statements of connection by id
+
         static size_t db_count;
 
         bool _TransactionCmd(const char *sql);
+        MYSQL_STMT* _GetStatement(uint32 id, const char *sql);
+        bool _ExecuteStatement(MYSQL_STMT* stmt, const char *sql, SqlStmtParameters const& params);
 };
 #endif
 #endif
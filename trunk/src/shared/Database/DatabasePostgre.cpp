@@ -53,6 +53,7 @@ DatabasePostgre::DatabasePostgre() : Database(), mPGconn(NULL)
 
 DatabasePostgre::~DatabasePostgre()
 {
+    CloseQueryPool();
 
     if (m_delayThread)
         HaltDelayThread();
@@ -171,11 +172,9 @@ bool DatabasePostgre::Execute(const char *sql)
     // don't use queued execution if it has not been initialized
     if (!m_threadBody) return DirectExecute(sql);
 
-    tranThread = ZThread::ThreadImpl::current();            // owner of this transaction
-    TransactionQueues::iterator i = m_tranQueues.find(tranThread);
-    if (i != m_tranQueues.end() && i->second != NULL)
+    if (SqlTransaction* tran = GetThreadTransaction())
     {                                                       // Statement for transaction
-        i->second->DelayExecute(sql);
+        tran->DelayExecute(sql);
     }
     else
     {
@@ -216,6 +215,194 @@ bool DatabasePostgre::DirectExecute(const char* sql)
     return true;
 }
 
+/// Server side name of prepared statement
+static std::string GetStatementName(uint32 id)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "mangos_stmt_%u", id);
+    return name;
+}
+
+/// Postgre uses $1, $2, ... for params instead of '?'
+static std::string ConvertParamMarkers(const char *sql)
+{
+    std::string pgsql;
+    uint32 param = 0;
+    char quote = 0;
+
+    for(const char *c = sql; *c; ++c)
+    {
+        if(quote)
+        {
+            if(*c == quote)
+                quote = 0;
+        }
+        else if(*c == '\'' || *c == '"')
+            quote = *c;
+        else if(*c == '?')
+        {
+            char marker[16];
+            snprintf(marker, sizeof(marker), "$%u", ++param);
+            pgsql += marker;
+            continue;
+        }
+
+        pgsql += *c;
+    }
+
+    return pgsql;
+}
+
+bool DatabasePostgre::_PrepareStatement(uint32 id, const char *sql, SqlStmtParameters const& params)
+{
+    if (m_preparedStmts.find(id) != m_preparedStmts.end())
+        return true;
+
+    // param types are set by first use, all uses of a statement pass same types
+    std::vector<Oid> types(params.size());
+    for(size_t i = 0; i < params.size(); ++i)
+    {
+        switch(params[i].type)
+        {
+            case SqlStmtParameters::VALUE_INT64:
+            case SqlStmtParameters::VALUE_UINT64: types[i] = INT8OID;   break;
+            case SqlStmtParameters::VALUE_DOUBLE: types[i] = FLOAT8OID; break;
+            case SqlStmtParameters::VALUE_BINARY: types[i] = BYTEAOID;  break;
+            default:                              types[i] = 0;         break; // text, type from sql
+        }
+    }
+
+    std::string pgsql = ConvertParamMarkers(sql);
+    PGresult *res = PQprepare(mPGconn, GetStatementName(id).c_str(), pgsql.c_str(), int(types.size()), types.empty() ? NULL : &types[0]);
+    if (PQresultStatus(res) != PGRES_COMMAND_OK)
+    {
+        sLog.outErrorDb( "SQL: %s", pgsql.c_str() );
+        sLog.outErrorDb( "SQL %s", PQerrorMessage(mPGconn) );
+        PQclear(res);
+        return false;
+    }
+
+    PQclear(res);
+    m_preparedStmts.insert(id);
+    return true;
+}
+
+PGresult* DatabasePostgre::_ExecuteStatement(uint32 id, SqlStmtParameters const& params)
+{
+    // all params are sent binary: numbers as 8 bytes in network byte order, strings as they are
+    std::vector<char> numbers(params.size() * 8);
+    std::vector<const char*> values(params.size());
+    std::vector<int> lengths(params.size());
+    std::vector<int> formats(params.size(), 1);
+
+    for(size_t i = 0; i < params.size(); ++i)
+    {
+        SqlStmtParameters::Value const& value = params[i];
+        switch(value.type)
+        {
+            case SqlStmtParameters::VALUE_INT64:
+            case SqlStmtParameters::VALUE_UINT64:
+            case SqlStmtParameters::VALUE_DOUBLE:
+            {
+                uint64 bits = value.number.u;
+                for(int b = 7; b >= 0; --b, bits >>= 8)
+                    numbers[i * 8 + b] = char(bits & 0xFF);
+
+                values[i] = &numbers[i * 8];
+                lengths[i] = 8;
+                break;
+            }
+            default:
+                values[i] = value.str.data();
+                lengths[i] = int(value.str.size());
+                break;
+        }
+    }
+
+    return PQexecPrepared(mPGconn, GetStatementName(id).c_str(), int(params.size()),
+        values.empty() ? NULL : &values[0], lengths.empty() ? NULL : &lengths[0], formats.empty() ? NULL : &formats[0], 0);
+}
+
+QueryResult* DatabasePostgre::DoPreparedQuery(uint32 id, const char *sql, SqlStmtParameters const& params)
+{
+    if (!mPGconn)
+        return NULL;
+
+    // guarded block for thread-safe request
+    ZThread::Guard<ZThread::FastMutex> query_connection_guard(mMutex);
+    #ifdef MANGOS_DEBUG
+    uint32 _s = getMSTime();
+    #endif
+    if (!_PrepareStatement(id, sql, params))
+        return NULL;
+
+    // results are text, they are read from PGresult without copies as for other queries
+    PGresult *result = _ExecuteStatement(id, params);
+    if (!result)
+        return NULL;
+
+    if (PQresultStatus(result) != PGRES_TUPLES_OK)
+    {
+        sLog.outErrorDb( "SQL : %s [%s]", sql, params.ToString().c_str() );
+        sLog.outErrorDb( "SQL %s", PQerrorMessage(mPGconn));
+        PQclear(result);
+        return NULL;
+    }
+    else
+    {
+        #ifdef MANGOS_DEBUG
+        sLog.outDebug("[%u ms] SQL: %s [%s]", getMSTime() - _s, sql, params.ToString().c_str() );
+        #endif
+    }
+
+    uint64 rowCount = PQntuples(result);
+    uint32 fieldCount = PQnfields(result);
+    // end guarded block
+
+    if (!rowCount)
+    {
+        PQclear(result);
+        return NULL;
+    }
+
+    QueryResultPostgre * queryResult = new QueryResultPostgre(result, rowCount, fieldCount);
+    queryResult->NextRow();
+
+    return queryResult;
+}
+
+bool DatabasePostgre::DoPreparedExecute(uint32 id, const char *sql, SqlStmtParameters const& params)
+{
+    if (!mPGconn)
+        return false;
+
+    // guarded block for thread-safe request
+    ZThread::Guard<ZThread::FastMutex> query_connection_guard(mMutex);
+    #ifdef MANGOS_DEBUG
+    uint32 _s = getMSTime();
+    #endif
+    if (!_PrepareStatement(id, sql, params))
+        return false;
+
+    PGresult *res = _ExecuteStatement(id, params);
+    if (PQresultStatus(res) != PGRES_COMMAND_OK && PQresultStatus(res) != PGRES_TUPLES_OK)
+    {
+        sLog.outErrorDb( "SQL: %s [%s]", sql, params.ToString().c_str() );
+        sLog.outErrorDb( "SQL %s", PQerrorMessage(mPGconn) );
+        PQclear(res);
+        return false;
+    }
+    else
+    {
+        #ifdef MANGOS_DEBUG
+        sLog.outDebug("[%u ms] SQL: %s [%s]", getMSTime() - _s, sql, params.ToString().c_str() );
+        #endif
+    }
+    PQclear(res);
+
+    return true;
+}
+
 bool DatabasePostgre::_TransactionCmd(const char *sql)
 {
     if (!mPGconn)
@@ -253,14 +440,9 @@ bool DatabasePostgre::BeginTransaction()
         return true;
     }
     // transaction started
-    tranThread = ZThread::ThreadImpl::current();            // owner of this transaction
-    TransactionQueues::iterator i = m_tranQueues.find(tranThread);
-    if (i != m_tranQueues.end() && i->second != NULL)
-        // If for thread exists queue and also contains transaction
-        // delete that transaction (not allow trans in trans)
-        delete i->second;
-
-    m_tranQueues[tranThread] = new SqlTransaction();
+    // If for thread exists queue and also contains transaction
+    // delete that transaction (not allow trans in trans)
+    delete SetThreadTransaction(new SqlTransaction());
 
     return true;
 }
@@ -280,12 +462,9 @@ bool DatabasePostgre::CommitTransaction()
         mMutex.release();
         return _res;
     }
-    tranThread = ZThread::ThreadImpl::current();
-    TransactionQueues::iterator i = m_tranQueues.find(tranThread);
-    if (i != m_tranQueues.end() && i->second != NULL)
+    if (SqlTransaction* tran = SetThreadTransaction(NULL))
     {
-        m_threadBody->Delay(i->second);
-        i->second = NULL;
+        m_threadBody->Delay(tran);
         return true;
     }
     else
@@ -306,13 +485,7 @@ bool DatabasePostgre::RollbackTransaction()
         mMutex.release();
         return _res;
     }
-    tranThread = ZThread::ThreadImpl::current();
-    TransactionQueues::iterator i = m_tranQueues.find(tranThread);
-    if (i != m_tranQueues.end() && i->second != NULL)
-    {
-        delete i->second;
-        i->second = NULL;
-    }
+    delete SetThreadTransaction(NULL);
     return true;
 }
 
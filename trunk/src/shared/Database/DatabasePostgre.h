@@ -60,6 +60,9 @@ class DatabasePostgre : public Database
         void ThreadStart();
         // must be call before finish thread run
         void ThreadEnd();
+    protected:
+        QueryResult* DoPreparedQuery(uint32 id, const char *sql, SqlStmtParameters const& params);
+        bool DoPreparedExecute(uint32 id, const char *sql, SqlStmtParameters const& params);
     private:
         ZThread::FastMutex mMutex;
         ZThread::FastMutex tranMutex;
@@ -68,8 +71,12 @@ class DatabasePostgre : public Database
 
         PGconn *mPGconn;
 
+        std::set<uint32> m_preparedStmts;                   ///< Ids of statements prepared at connection
+
         static size_t db_count;
 
         bool _TransactionCmd(const char *sql);
+        bool _PrepareStatement(uint32 id, const char *sql, SqlStmtParameters const& params);
+        PGresult* _ExecuteStatement(uint32 id, SqlStmtParameters const& params);
 };
 #endif
@@ -26,6 +26,9 @@ DatabaseSqlite::DatabaseSqlite() : Database(), mSqlite(0)
 
 DatabaseSqlite::~DatabaseSqlite()
 {
+    for(VMCache::const_iterator itr = mVMCache.begin(); itr != mVMCache.end(); ++itr)
+        sqlite_finalize(itr->second, NULL);
+
     if (mSqlite)
         sqlite_close(mSqlite);
 }
@@ -98,4 +101,140 @@ bool DatabaseSqlite::Execute(const char *sql)
 
     return true;
 }
+
+sqlite_vm* DatabaseSqlite::_GetStatement(uint32 id, const char *sql, SqlStmtParameters const& params)
+{
+    sqlite_vm *vm = NULL;
+
+    VMCache::const_iterator itr = mVMCache.find(id);
+    if (itr != mVMCache.end())
+        vm = itr->second;
+    else
+    {
+        char *errmsg = NULL;
+        if (sqlite_compile(mSqlite, sql, NULL, &vm, &errmsg) != SQLITE_OK || !vm)
+        {
+            sLog.outErrorDb("SQL: %s", sql);
+            sLog.outErrorDb("SQL ERROR: %s", errmsg ? errmsg : "");
+            if (errmsg)
+                sqlite_freemem(errmsg);
+            return NULL;
+        }
+        mVMCache[id] = vm;
+    }
+
+    // SQLite 2 stores all values as text
+    for (size_t i = 0; i < params.size(); ++i)
+    {
+        SqlStmtParameters::Value const& value = params[i];
+        char number[32];
+        int res;
+
+        switch (value.type)
+        {
+            case SqlStmtParameters::VALUE_INT64:
+                snprintf(number, sizeof(number), SI64FMTD, value.number.i);
+                res = sqlite_bind(vm, int(i + 1), number, -1, 1);
+                break;
+            case SqlStmtParameters::VALUE_UINT64:
+                snprintf(number, sizeof(number), I64FMTD, value.number.u);
+                res = sqlite_bind(vm, int(i + 1), number, -1, 1);
+                break;
+            case SqlStmtParameters::VALUE_DOUBLE:
+                snprintf(number, sizeof(number), "%.17g", value.number.d);
+                res = sqlite_bind(vm, int(i + 1), number, -1, 1);
+                break;
+            default:
+                res = sqlite_bind(vm, int(i + 1), value.str.c_str(), int(value.str.size() + 1), 1);
+                break;
+        }
+
+        if (res != SQLITE_OK)
+        {
+            sLog.outErrorDb("SQL: %s [%s]", sql, params.ToString().c_str());
+            sLog.outErrorDb("SQL ERROR: can't bind param %u", uint32(i + 1));
+            _EndStatement(id, sql, params, vm);
+            return NULL;
+        }
+    }
+
+    return vm;
+}
+
+bool DatabaseSqlite::_EndStatement(uint32 id, const char *sql, SqlStmtParameters const& params, sqlite_vm *vm)
+{
+    // reset returns result of the run and makes statement ready for next binding
+    char *errmsg = NULL;
+    if (sqlite_reset(vm, &errmsg) == SQLITE_OK)
+        return true;
+
+    sLog.outErrorDb("SQL: %s [%s]", sql, params.ToString().c_str());
+    sLog.outErrorDb("SQL ERROR: %s", errmsg ? errmsg : "");
+    if (errmsg)
+        sqlite_freemem(errmsg);
+
+    // compile again at next use, schema may have been changed
+    sqlite_finalize(vm, NULL);
+    mVMCache.erase(id);
+    return false;
+}
+
+QueryResult* DatabaseSqlite::DoPreparedQuery(uint32 id, const char *sql, SqlStmtParameters const& params)
+{
+    if (!mSqlite)
+        return NULL;
+
+    sqlite_vm *vm = _GetStatement(id, sql, params);
+    if (!vm)
+        return NULL;
+
+    QueryResultStmt *queryResult = NULL;
+
+    int fieldCount = 0;
+    const char **values = NULL;
+    const char **names = NULL;
+    while (sqlite_step(vm, &fieldCount, &values, &names) == SQLITE_ROW)
+    {
+        // values are valid until next step, so they are copied to result
+        if (!queryResult)
+        {
+            queryResult = new QueryResultStmt(fieldCount);
+            for (int i = 0; i < fieldCount; ++i)
+                queryResult->SetField(i, names[i], QueryResultSqlite::ConvertNativeType(names[i + fieldCount]));
+        }
+
+        for (int i = 0; i < fieldCount; ++i)
+        {
+            if (values[i])
+                queryResult->AddString(values[i], strlen(values[i]));
+            else
+                queryResult->AddNull();
+        }
+    }
+
+    if (!_EndStatement(id, sql, params, vm) || !queryResult || !queryResult->EndRows())
+    {
+        delete queryResult;
+        return NULL;
+    }
+
+    return queryResult;
+}
+
+bool DatabaseSqlite::DoPreparedExecute(uint32 id, const char *sql, SqlStmtParameters const& params)
+{
+    if (!mSqlite)
+        return false;
+
+    sqlite_vm *vm = _GetStatement(id, sql, params);
+    if (!vm)
+        return false;
+
+    int fieldCount;
+    const char **values;
+    const char **names;
+    while (sqlite_step(vm, &fieldCount, &values, &names) == SQLITE_ROW) {}
+
+    return _EndStatement(id, sql, params, vm);
+}
 #endif
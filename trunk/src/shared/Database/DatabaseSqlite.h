@@ -36,8 +36,18 @@ class DatabaseSqlite : public Database
 
         operator bool () const { return mSqlite != NULL; }
 
+    protected:
+        QueryResult* DoPreparedQuery(uint32 id, const char *sql, SqlStmtParameters const& params);
+        bool DoPreparedExecute(uint32 id, const char *sql, SqlStmtParameters const& params);
+
     private:
         sqlite *mSqlite;
+
+        typedef HM_NAMESPACE::hash_map<uint32, sqlite_vm*> VMCache;
+        VMCache mVMCache;                                   // compiled statements by id, reset after each use
+
+        sqlite_vm* _GetStatement(uint32 id, const char *sql, SqlStmtParameters const& params);
+        bool _EndStatement(uint32 id, const char *sql, SqlStmtParameters const& params, sqlite_vm *vm);
 };
 #endif
 #endif
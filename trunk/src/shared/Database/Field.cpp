@@ -19,47 +19,93 @@
 #include "DatabaseEnv.h"
 
 Field::Field() :
-mValue(NULL), mType(DB_TYPE_UNKNOWN)
+mValue(NULL), mBuffer(NULL), mLength(0), mType(DB_TYPE_UNKNOWN), mNumber(NUMBER_NONE)
 {
 }
 
-Field::Field(Field &f)
+Field::Field(Field &f) :
+mBuffer(NULL), mNumber(f.mNumber), mNumberValue(f.mNumberValue)
 {
     const char *value;
 
     value = f.GetString();
+    mLength = f.GetLength();
 
-    if (value && (mValue = new char[strlen(value) + 1]))
-        strcpy(mValue, value);
-    else
-        mValue = NULL;
+    if (value && (mBuffer = new char[mLength + 1]))
+        memcpy(mBuffer, value, mLength + 1);
 
+    mValue = mBuffer;
     mType = f.GetType();
 }
 
 Field::Field(const char *value, enum Field::DataTypes type) :
-mType(type)
+mBuffer(NULL), mLength(value ? strlen(value) : 0), mType(type), mNumber(NUMBER_NONE)
 {
-    if (value && (mValue = new char[strlen(value) + 1]))
-        strcpy(mValue, value);
-    else
-        mValue = NULL;
+    if (value && (mBuffer = new char[mLength + 1]))
+        strcpy(mBuffer, value);
+
+    mValue = mBuffer;
 }
 
 Field::~Field()
 {
-    if(mValue) delete [] mValue;
+    if(mBuffer) delete [] mBuffer;
 }
 
 void Field::SetValue(const char *value)
 {
-    if(mValue) delete [] mValue;
+    if(mBuffer)
+    {
+        delete [] mBuffer;
+        mBuffer = NULL;
+    }
+
+    // row data stays in the query result until the result is freed
+    mValue = value;
+    mLength = LENGTH_UNKNOWN;
+    mNumber = NUMBER_NONE;
+}
+
+void Field::SetValue(const char *value, unsigned long length)
+{
+    SetValue(value);
+    mLength = value ? length : 0;
+}
+
+void Field::SetInt64Value(int64 value)
+{
+    SetValue(NULL);
+    mNumber = NUMBER_INT;
+    mNumberValue.i = value;
+}
+
+void Field::SetUInt64Value(uint64 value)
+{
+    SetValue(NULL);
+    mNumber = NUMBER_UINT;
+    mNumberValue.i = static_cast<int64>(value);
+}
 
-    if (value)
+void Field::SetDoubleValue(double value)
+{
+    SetValue(NULL);
+    mNumber = NUMBER_DOUBLE;
+    mNumberValue.d = value;
+}
+
+const char *Field::GetNumberString() const
+{
+    switch(mNumber)
     {
-        mValue = new char[strlen(value) + 1];
-        strcpy(mValue, value);
+        case NUMBER_INT:
+            snprintf(mNumberText, sizeof(mNumberText), SI64FMTD, mNumberValue.i);
+            break;
+        case NUMBER_UINT:
+            snprintf(mNumberText, sizeof(mNumberText), I64FMTD, static_cast<uint64>(mNumberValue.i));
+            break;
+        default:
+            snprintf(mNumberText, sizeof(mNumberText), "%.17g", mNumberValue.d);
+            break;
     }
-    else
-        mValue = NULL;
+    return mNumberText;
 }
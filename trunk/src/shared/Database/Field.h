@@ -40,36 +40,102 @@ class Field
 
         enum DataTypes GetType() const { return mType; }
 
-        const char *GetString() const { return mValue; }
+        const char *GetString() const { return mNumber != NUMBER_NONE ? GetNumberString() : mValue; }
         std::string GetCppString() const
         {
-            return mValue ? mValue : "";                    // std::string s = 0 have undefine result in C++
+            const char* value = GetString();
+            return value ? value : "";                      // std::string s = 0 have undefine result in C++
         }
-        float GetFloat() const { return mValue ? static_cast<float>(atof(mValue)) : 0.0f; }
-        bool GetBool() const { return mValue ? atoi(mValue) > 0 : false; }
-        int32 GetInt32() const { return mValue ? static_cast<int32>(atol(mValue)) : int32(0); }
-        uint8 GetUInt8() const { return mValue ? static_cast<uint8>(atol(mValue)) : uint8(0); }
-        uint16 GetUInt16() const { return mValue ? static_cast<uint16>(atol(mValue)) : uint16(0); }
-        int16 GetInt16() const { return mValue ? static_cast<int16>(atol(mValue)) : int16(0); }
-        uint32 GetUInt32() const { return mValue ? static_cast<uint32>(atol(mValue)) : uint32(0); }
+        float GetFloat() const
+        {
+            if(mNumber != NUMBER_NONE)
+                return static_cast<float>(GetNumberDouble());
+            return mValue ? static_cast<float>(atof(mValue)) : 0.0f;
+        }
+        bool GetBool() const { return mNumber != NUMBER_NONE ? GetNumberInt() > 0 : mValue ? atoi(mValue) > 0 : false; }
+        int32 GetInt32() const { return mNumber != NUMBER_NONE ? static_cast<int32>(GetNumberInt()) : mValue ? static_cast<int32>(atol(mValue)) : int32(0); }
+        uint8 GetUInt8() const { return mNumber != NUMBER_NONE ? static_cast<uint8>(GetNumberInt()) : mValue ? static_cast<uint8>(atol(mValue)) : uint8(0); }
+        uint16 GetUInt16() const { return mNumber != NUMBER_NONE ? static_cast<uint16>(GetNumberInt()) : mValue ? static_cast<uint16>(atol(mValue)) : uint16(0); }
+        int16 GetInt16() const { return mNumber != NUMBER_NONE ? static_cast<int16>(GetNumberInt()) : mValue ? static_cast<int16>(atol(mValue)) : int16(0); }
+        uint32 GetUInt32() const { return mNumber != NUMBER_NONE ? static_cast<uint32>(GetNumberInt()) : mValue ? static_cast<uint32>(atol(mValue)) : uint32(0); }
         uint64 GetUInt64() const
         {
-            if(mValue)
-            {
-                uint64 value;
-                sscanf(mValue,I64FMTD,&value);
-                return value;
-            }
-            else
+            if(mNumber != NUMBER_NONE)
+                return static_cast<uint64>(GetNumberInt());
+
+            if(!mValue)
                 return 0;
+
+            // plain digits are usual for guid/money columns, parse them without sscanf
+            uint64 value = 0;
+            char const* c = mValue;
+            for(; *c >= '0' && *c <= '9'; ++c)
+                value = value * 10 + uint64(*c - '0');
+
+            if(*c && c == mValue)
+                sscanf(mValue,I64FMTD,&value);
+
+            return value;
+        }
+
+        // size of value in bytes, binary values (blobs) may contain null bytes
+        unsigned long GetLength() const
+        {
+            if(mNumber != NUMBER_NONE)
+                return strlen(GetNumberString());
+            if(mLength == LENGTH_UNKNOWN)
+                mLength = mValue ? strlen(mValue) : 0;
+            return mLength;
         }
 
         void SetType(enum DataTypes type) { mType = type; }
 
+        // value is not copied, it must stay valid while the field is used (query result row buffer)
         void SetValue(const char *value);
+        void SetValue(const char *value, unsigned long length);
+
+        // binary numbers of prepared statement results, they are not parsed from text
+        void SetInt64Value(int64 value);
+        void SetUInt64Value(uint64 value);
+        void SetDoubleValue(double value);
 
     private:
-        char *mValue;
+        enum { LENGTH_UNKNOWN = 0xFFFFFFFF };
+
+        enum NumberType
+        {
+            NUMBER_NONE,                                    // text value in mValue (or NULL)
+            NUMBER_INT,
+            NUMBER_UINT,
+            NUMBER_DOUBLE
+        };
+
+        int64 GetNumberInt() const
+        {
+            return mNumber == NUMBER_DOUBLE ? static_cast<int64>(mNumberValue.d) : mNumberValue.i;
+        }
+        double GetNumberDouble() const
+        {
+            switch(mNumber)
+            {
+                case NUMBER_DOUBLE: return mNumberValue.d;
+                case NUMBER_UINT:   return static_cast<double>(static_cast<uint64>(mNumberValue.i));
+                default:            return static_cast<double>(mNumberValue.i);
+            }
+        }
+        const char *GetNumberString() const;
+
+        const char *mValue;
+        char *mBuffer;                                      // own copy of value, only for copied fields
+        mutable unsigned long mLength;
         enum DataTypes mType;
+
+        enum NumberType mNumber;
+        union
+        {
+            int64 i;                                        // also uint64 bits for NUMBER_UINT
+            double d;
+        } mNumberValue;
+        mutable char mNumberText[32];                       // number as text, made by GetString
 };
 #endif
@@ -55,8 +55,10 @@ bool QueryResultMysql::NextRow()
         return false;
     }
 
+    unsigned long *lengths = mysql_fetch_lengths(mResult);
+
     for (uint32 i = 0; i < mFieldCount; i++)
-        mCurrentRow[i].SetValue(row[i]);
+        mCurrentRow[i].SetValue(row[i], lengths[i]);
 
     return true;
 }
@@ -76,7 +78,7 @@ void QueryResultMysql::EndQuery()
     }
 }
 
-enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType) const
+enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType)
 {
     switch (mysqlType)
     {
@@ -38,8 +38,9 @@ class QueryResultMysql : public QueryResult
 
         bool NextRow();
 
+        static enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType);
+
     private:
-        enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType) const;
         void EndQuery();
 
         MYSQL_RES *mResult;
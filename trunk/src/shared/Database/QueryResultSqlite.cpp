@@ -75,7 +75,7 @@ void QueryResultSqlite::EndQuery()
     }
 }
 
-enum Field::DataTypes QueryResultSqlite::ConvertNativeType(const char* sqliteType) const
+enum Field::DataTypes QueryResultSqlite::ConvertNativeType(const char* sqliteType)
 {
     if (sqliteType)
     {
@@ -32,8 +32,9 @@ class QueryResultSqlite : public QueryResult
 
         bool NextRow();
 
+        static enum Field::DataTypes ConvertNativeType(const char* sqliteType);
+
     private:
-        enum Field::DataTypes ConvertNativeType(const char* sqliteType) const;
         void EndQuery();
 
         char **mTableData;
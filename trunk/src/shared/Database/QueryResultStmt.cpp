@@ -0,0 +1,133 @@
+/* 
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "DatabaseEnv.h"
+
+QueryResultStmt::QueryResultStmt(uint32 fieldCount) :
+QueryResult(0, fieldCount), mNextCell(0)
+{
+    mCurrentRow = new Field[mFieldCount];
+    ASSERT(mCurrentRow);
+}
+
+QueryResultStmt::~QueryResultStmt()
+{
+    EndQuery();
+}
+
+void QueryResultStmt::SetField(uint32 index, const char* name, enum Field::DataTypes type)
+{
+    mFieldNames[index] = name;
+    mCurrentRow[index].SetType(type);
+}
+
+void QueryResultStmt::AddNull()
+{
+    Cell cell;
+    cell.type = CELL_NULL;
+    cell.value.u = 0;
+    cell.length = 0;
+    mCells.push_back(cell);
+}
+
+void QueryResultStmt::AddInt64(int64 value)
+{
+    Cell cell;
+    cell.type = CELL_INT64;
+    cell.value.i = value;
+    cell.length = 0;
+    mCells.push_back(cell);
+}
+
+void QueryResultStmt::AddUInt64(uint64 value)
+{
+    Cell cell;
+    cell.type = CELL_UINT64;
+    cell.value.u = value;
+    cell.length = 0;
+    mCells.push_back(cell);
+}
+
+void QueryResultStmt::AddDouble(double value)
+{
+    Cell cell;
+    cell.type = CELL_DOUBLE;
+    cell.value.d = value;
+    cell.length = 0;
+    mCells.push_back(cell);
+}
+
+void QueryResultStmt::AddString(const char* value, unsigned long length)
+{
+    Cell cell;
+    cell.type = CELL_STRING;
+    cell.value.offset = mStrings.size();
+    cell.length = length;
+    mCells.push_back(cell);
+
+    mStrings.insert(mStrings.end(), value, value + length);
+    mStrings.push_back('\0');
+}
+
+bool QueryResultStmt::EndRows()
+{
+    mRowCount = mFieldCount ? mCells.size() / mFieldCount : 0;
+    if (!mRowCount)
+        return false;
+
+    NextRow();
+    return true;
+}
+
+bool QueryResultStmt::NextRow()
+{
+    if (!mCurrentRow)
+        return false;
+
+    if (mNextCell >= mCells.size())
+    {
+        EndQuery();
+        return false;
+    }
+
+    for (uint32 i = 0; i < mFieldCount; ++i, ++mNextCell)
+    {
+        Cell const& cell = mCells[mNextCell];
+        switch (cell.type)
+        {
+            case CELL_INT64:  mCurrentRow[i].SetInt64Value(cell.value.i); break;
+            case CELL_UINT64: mCurrentRow[i].SetUInt64Value(cell.value.u); break;
+            case CELL_DOUBLE: mCurrentRow[i].SetDoubleValue(cell.value.d); break;
+            case CELL_STRING: mCurrentRow[i].SetValue(&mStrings[cell.value.offset], cell.length); break;
+            default:          mCurrentRow[i].SetValue(NULL); break;
+        }
+    }
+
+    return true;
+}
+
+void QueryResultStmt::EndQuery()
+{
+    if (mCurrentRow)
+    {
+        delete [] mCurrentRow;
+        mCurrentRow = 0;
+    }
+
+    mCells.clear();
+    mStrings.clear();
+}
@@ -0,0 +1,72 @@
+/* 
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#if !defined(QUERYRESULTSTMT_H)
+#define QUERYRESULTSTMT_H
+
+/// Result of a prepared statement query. The backend copies all rows into one buffer,
+/// so the statement may run again while the result is still used (query holders).
+/// Numbers are kept binary, fields of the current row point into the buffer.
+class QueryResultStmt : public QueryResult
+{
+    public:
+        explicit QueryResultStmt(uint32 fieldCount);
+
+        ~QueryResultStmt();
+
+        bool NextRow();
+
+        /// filling by backend: field names, then values of all rows in order
+        void SetField(uint32 index, const char* name, enum Field::DataTypes type);
+        void AddNull();
+        void AddInt64(int64 value);
+        void AddUInt64(uint64 value);
+        void AddDouble(double value);
+        void AddString(const char* value, unsigned long length);
+        /// ends filling, returns false (with result to delete) if there are no rows
+        bool EndRows();
+
+    private:
+        enum CellType
+        {
+            CELL_NULL,
+            CELL_INT64,
+            CELL_UINT64,
+            CELL_DOUBLE,
+            CELL_STRING
+        };
+
+        struct Cell
+        {
+            CellType type;
+            union
+            {
+                int64 i;
+                uint64 u;
+                double d;
+                size_t offset;                              ///< of string in mStrings
+            } value;
+            unsigned long length;
+        };
+
+        void EndQuery();
+
+        std::vector<Cell> mCells;
+        std::vector<char> mStrings;                         ///< strings of all rows, null terminated
+        size_t mNextCell;
+};
+#endif
@@ -0,0 +1,94 @@
+/* 
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "SqlBatch.h"
+#include "DatabaseEnv.h"
+
+bool SqlInsertBatch::AddRow(const char *format, ...)
+{
+    va_list ap;
+    char szRow [MAX_QUERY_LEN];
+    va_start(ap, format);
+    int res = vsnprintf( szRow, MAX_QUERY_LEN, format, ap );
+    va_end(ap);
+
+    if(res==-1)
+    {
+        sLog.outError("SQL row truncated (and not inserted) for format: %s",format);
+        return false;
+    }
+
+    if(m_sql.length() + res + 3 > SQL_BATCH_MAX_LENGTH)
+        Execute();
+
+    if(!m_rows)
+        m_sql = m_insert;
+    else
+        m_sql += ",";
+
+    m_sql += "(";
+    m_sql += szRow;
+    m_sql += ")";
+    ++m_rows;
+    return true;
+}
+
+void SqlInsertBatch::Execute()
+{
+    if(!m_rows)
+        return;
+
+    // inserted part can include rows with keys still in delete batch
+    if(m_deleteFirst)
+        m_deleteFirst->Execute();
+
+    m_db.Execute(m_sql.c_str());
+    m_sql.clear();
+    m_rows = 0;
+}
+
+SqlDeleteBatch::SqlDeleteBatch(Database& db, const char *format, ...) : m_db(db), m_count(0)
+{
+    va_list ap;
+    char szDelete [MAX_QUERY_LEN];
+    va_start(ap, format);
+    vsnprintf( szDelete, MAX_QUERY_LEN, format, ap );
+    va_end(ap);
+
+    m_delete = szDelete;
+}
+
+void SqlDeleteBatch::AddKey(uint32 key)
+{
+    if(m_delete.length() + size_t(m_keys.tellp()) + 13 > SQL_BATCH_MAX_LENGTH)
+        Execute();
+
+    m_keys << (m_count ? ",'" : "('") << key << "'";
+    ++m_count;
+}
+
+void SqlDeleteBatch::Execute()
+{
+    if(!m_count)
+        return;
+
+    m_keys << ")";
+    m_db.Execute((m_delete + m_keys.str()).c_str());
+    m_keys.str("");
+    m_count = 0;
+}
@@ -0,0 +1,63 @@
+/* 
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef __SQLBATCH_H
+#define __SQLBATCH_H
+
+#include "Common.h"
+
+class Database;
+
+/// ---- MULTI-ROW STATEMENTS ----
+
+#define SQL_BATCH_MAX_LENGTH    32768                       ///< longer statements are executed in parts
+
+/// Keys collected for one "DELETE FROM table WHERE ... key IN (...)" statement
+class SqlDeleteBatch
+{
+    private:
+        Database& m_db;
+        std::string m_delete;
+        std::ostringstream m_keys;
+        uint32 m_count;
+    public:
+        /// format is statement before key list: "DELETE FROM table WHERE guid = '%u' AND key IN "
+        SqlDeleteBatch(Database& db, const char *format, ...) ATTR_PRINTF(3,4);
+        void AddKey(uint32 key);
+        void Execute();
+};
+
+/// Rows collected for one "INSERT INTO table (fields) VALUES (...),(...)" statement
+class SqlInsertBatch
+{
+    private:
+        Database& m_db;
+        std::string m_insert;
+        std::string m_sql;
+        uint32 m_rows;
+        SqlDeleteBatch* m_deleteFirst;
+    public:
+        /// insert is statement before rows: "INSERT INTO table (fields) VALUES "
+        /// deleteFirst keys are deleted before each part of insert, for rows rewritten by delete and insert
+        SqlInsertBatch(Database& db, const char *insert, SqlDeleteBatch* deleteFirst = NULL)
+            : m_db(db), m_insert(insert), m_rows(0), m_deleteFirst(deleteFirst) {}
+        /// format is row values without brackets
+        bool AddRow(const char *format, ...) ATTR_PRINTF(2,3);
+        void Execute();
+};
+#endif                                                      //__SQLBATCH_H
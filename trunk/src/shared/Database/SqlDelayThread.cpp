@@ -19,9 +19,96 @@
 #include "Database/SqlDelayThread.h"
 #include "Database/SqlOperations.h"
 #include "DatabaseEnv.h"
+#include "Timer.h"
 
-SqlDelayThread::SqlDelayThread(Database* db) : m_dbEngine(db), m_running(true)
+/// Delay thread statistics are logged with this interval (in milliseconds)
+#define SQL_DELAY_STATS_INTERVAL 60000
+
+/// Upper bounds (in milliseconds) of wait time histogram buckets, last bucket is unbounded
+static const uint32 SqlDelayWaitBuckets[SQL_DELAY_WAIT_BUCKETS - 1] = { 1, 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000 };
+
+SqlDelayThread::SqlDelayThread(Database* db) : m_dbEngine(db), m_running(true), m_writeThread(NULL),
+    m_queuedCount(0), m_doneCount(0), m_statTime(getMSTime()), m_statCount(0), m_statWaitTotal(0), m_statWaitMax(0)
+{
+    memset(m_statWaitHistogram, 0, sizeof(m_statWaitHistogram));
+}
+
+void SqlDelayThread::Delay(SqlOperation* sql)
+{
+    sql->m_queueTime = getMSTime();
+
+    // keep read-after-write order with the main connection
+    if (m_writeThread)
+        sql->m_writeBarrier = m_writeThread->GetQueuedCount();
+
+    {
+        ZThread::Guard<ZThread::FastMutex> guard(m_seqLock);
+        ++m_queuedCount;
+    }
+
+    m_sqlQueue.add(sql);
+}
+
+uint64 SqlDelayThread::GetQueuedCount()
 {
+    ZThread::Guard<ZThread::FastMutex> guard(m_seqLock);
+    return m_queuedCount;
+}
+
+void SqlDelayThread::WaitDone(uint64 count)
+{
+    while (true)
+    {
+        {
+            ZThread::Guard<ZThread::FastMutex> guard(m_seqLock);
+            if (m_doneCount >= count)
+                return;
+        }
+
+        ZThread::Thread::sleep(1);
+    }
+}
+
+void SqlDelayThread::UpdateStats(uint32 waitTime)
+{
+    ++m_statCount;
+    m_statWaitTotal += waitTime;
+    if (waitTime > m_statWaitMax)
+        m_statWaitMax = waitTime;
+
+    uint32 bucket = 0;
+    while (bucket < SQL_DELAY_WAIT_BUCKETS - 1 && waitTime > SqlDelayWaitBuckets[bucket])
+        ++bucket;
+    ++m_statWaitHistogram[bucket];
+
+    uint32 now = getMSTime();
+    if (getMSTimeDiff(m_statTime, now) < SQL_DELAY_STATS_INTERVAL)
+        return;
+
+    sLog.outDetail("SQL %s thread: %u operations, wait time avg %u ms p50 %u ms p95 %u ms p99 %u ms max %u ms, %u queued",
+        m_writeThread ? "query pool" : "delay", m_statCount, m_statWaitTotal / m_statCount,
+        GetWaitPercentile(50), GetWaitPercentile(95), GetWaitPercentile(99), m_statWaitMax, (uint32)m_sqlQueue.size());
+
+    m_statTime = now;
+    m_statCount = 0;
+    m_statWaitTotal = 0;
+    m_statWaitMax = 0;
+    memset(m_statWaitHistogram, 0, sizeof(m_statWaitHistogram));
+}
+
+/// Wait time not exceeded by percent of operations, rounded up to histogram bucket bound
+uint32 SqlDelayThread::GetWaitPercentile(uint32 percent) const
+{
+    uint32 needed = (m_statCount * percent + 99) / 100;
+    uint32 count = 0;
+    for (uint32 bucket = 0; bucket < SQL_DELAY_WAIT_BUCKETS - 1; ++bucket)
+    {
+        count += m_statWaitHistogram[bucket];
+        if (count >= needed)
+            return std::min(SqlDelayWaitBuckets[bucket], m_statWaitMax);
+    }
+
+    return m_statWaitMax;
 }
 
 void SqlDelayThread::run()
@@ -39,8 +126,21 @@ void SqlDelayThread::run()
         while (!m_sqlQueue.empty())
         {
             s = m_sqlQueue.next();
+
+            if (m_writeThread && s->m_writeBarrier)
+                m_writeThread->WaitDone(s->m_writeBarrier);
+
+            uint32 waitTime = getMSTimeDiff(s->m_queueTime, getMSTime());
+
             s->Execute(m_dbEngine);
             delete s;
+
+            {
+                ZThread::Guard<ZThread::FastMutex> guard(m_seqLock);
+                ++m_doneCount;
+            }
+
+            UpdateStats(waitTime);
         }
     }
 
@@ -19,6 +19,7 @@
 #ifndef __SQLDELAYTHREAD_H
 #define __SQLDELAYTHREAD_H
 
+#include "Platform/Define.h"
 #include "zthread/Thread.h"
 #include "zthread/Runnable.h"
 #include "zthread/FastMutex.h"
@@ -27,6 +28,8 @@
 class Database;
 class SqlOperation;
 
+#define SQL_DELAY_WAIT_BUCKETS 12
+
 class SqlDelayThread : public ZThread::Runnable
 {
     typedef ZThread::LockedQueue<SqlOperation*, ZThread::FastMutex> SqlQueue;
@@ -35,12 +38,34 @@ class SqlDelayThread : public ZThread::Runnable
         Database* m_dbEngine;                               ///< Pointer to used Database engine
         bool m_running;
 
+        SqlDelayThread* m_writeThread;                      ///< Main thread of the database, set for query pool threads
+        ZThread::FastMutex m_seqLock;
+        uint64 m_queuedCount;                               ///< Operations put to the queue
+        uint64 m_doneCount;                                 ///< Operations executed
+
+        uint32 m_statTime;
+        uint32 m_statCount;
+        uint32 m_statWaitTotal;
+        uint32 m_statWaitMax;
+        uint32 m_statWaitHistogram[SQL_DELAY_WAIT_BUCKETS]; ///< Operations by wait time bucket, for percentiles
+
+        void UpdateStats(uint32 waitTime);
+        uint32 GetWaitPercentile(uint32 percent) const;
+
         SqlDelayThread();
     public:
         SqlDelayThread(Database* db);
 
         ///< Put sql statement to delay queue
-        inline void Delay(SqlOperation* sql) { m_sqlQueue.add(sql); }
+        void Delay(SqlOperation* sql);
+
+        size_t GetQueueSize() { return m_sqlQueue.size(); }
+
+        ///< Queries of this thread will wait for writes queued to writeThread before them
+        void SetWriteThread(SqlDelayThread* writeThread) { m_writeThread = writeThread; }
+
+        uint64 GetQueuedCount();
+        void WaitDone(uint64 count);                        ///< Block until count operations are executed
 
         virtual void Stop();                                ///< Stop event
         virtual void run();                                 ///< Main Thread loop
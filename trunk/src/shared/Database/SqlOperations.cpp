@@ -29,6 +29,36 @@ void SqlStatement::Execute(Database *db)
     db->DirectExecute(m_sql);
 }
 
+void SqlPreparedStatement::Execute(Database *db)
+{
+    db->DirectPreparedExecute(m_id, m_id.GetSql(), m_params);
+}
+
+void SqlTransaction::DelayExecute(const char *sql)
+{
+    Statement stmt;
+    stmt.sql = strdup(sql);
+    stmt.params = NULL;
+    m_queue.push(stmt);
+}
+
+void SqlTransaction::DelayExecute(SqlStatementID const& id, SqlStmtParameters const& params)
+{
+    Statement stmt;
+    stmt.sql = NULL;
+    stmt.id = id;
+    stmt.params = new SqlStmtParameters(params);
+    m_queue.push(stmt);
+}
+
+void SqlTransaction::Free(Statement& stmt)
+{
+    if(stmt.params)
+        delete stmt.params;
+    else
+        free((void*)const_cast<char*>(stmt.sql));
+}
+
 void SqlTransaction::Execute(Database *db)
 {
     if(m_queue.empty())
@@ -36,22 +66,24 @@ void SqlTransaction::Execute(Database *db)
     db->DirectExecute("START TRANSACTION");
     while(!m_queue.empty())
     {
-        char const *sql = m_queue.front();
+        Statement stmt = m_queue.front();
         m_queue.pop();
 
-        if(!db->DirectExecute(sql))
+        bool res = stmt.params
+            ? db->DirectPreparedExecute(stmt.id, stmt.id.GetSql(), *stmt.params)
+            : db->DirectExecute(stmt.sql);
+        Free(stmt);
+
+        if(!res)
         {
-            free((void*)const_cast<char*>(sql));
             db->DirectExecute("ROLLBACK");
             while(!m_queue.empty())
             {
-                free((void*)const_cast<char*>(m_queue.front()));
+                Free(m_queue.front());
                 m_queue.pop();
             }
             return;
         }
-
-        free((void*)const_cast<char*>(sql));
     }
     db->DirectExecute("COMMIT");
 }
@@ -109,6 +141,16 @@ bool SqlQueryHolder::SetQuery(size_t index, const char *sql)
     return true;
 }
 
+bool SqlQueryHolder::SetPreparedQuery(size_t index, SqlStatementID& id, const char *sql, SqlStmtParameters const& params)
+{
+    if(!SetQuery(index, sql))
+        return false;
+
+    Database::InitStatement(id, sql);
+    m_stmts[index] = SqlStmtPair(id, new SqlStmtParameters(params));
+    return true;
+}
+
 bool SqlQueryHolder::SetPQuery(size_t index, const char *format, ...)
 {
     if(!format)
@@ -141,6 +183,8 @@ QueryResult* SqlQueryHolder::GetResult(size_t index)
         {
             free((void*)(const_cast<char*>(m_queries[index].first)));
             m_queries[index].first = NULL;
+            delete m_stmts[index].second;
+            m_stmts[index].second = NULL;
         }
         /// when you get a result aways remember to delete it!
         return m_queries[index].second;
@@ -165,6 +209,7 @@ SqlQueryHolder::~SqlQueryHolder()
         if(m_queries[i].first != NULL)
         {
             free((void*)(const_cast<char*>(m_queries[i].first)));
+            delete m_stmts[i].second;
             if(m_queries[i].second)
                 delete m_queries[i].second;
         }
@@ -175,6 +220,7 @@ void SqlQueryHolder::SetSize(size_t size)
 {
     /// to optimize push_back, reserve the number of queries about to be executed
     m_queries.resize(size);
+    m_stmts.resize(size, SqlStmtPair(SqlStatementID(), (SqlStmtParameters*)NULL));
 }
 
 void SqlQueryHolderEx::Execute(Database *db)
@@ -185,11 +231,20 @@ void SqlQueryHolderEx::Execute(Database *db)
     /// we can do this, we are friends
     std::vector<SqlQueryHolder::SqlResultPair> &queries = m_holder->m_queries;
 
+    std::vector<SqlQueryHolder::SqlStmtPair> &stmts = m_holder->m_stmts;
+
     for(size_t i = 0; i < queries.size(); i++)
     {
         /// execute all queries in the holder and pass the results
+        /// results already stored (reused holder) are kept
         char const *sql = queries[i].first;
-        if(sql) m_holder->SetResult(i, db->Query(sql));
+        if(!sql || queries[i].second)
+            continue;
+
+        if(stmts[i].second)
+            m_holder->SetResult(i, db->PreparedQuery(stmts[i].first, sql, *stmts[i].second));
+        else
+            m_holder->SetResult(i, db->Query(sql));
     }
 
     /// sync with the caller thread
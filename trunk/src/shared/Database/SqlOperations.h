@@ -26,6 +26,7 @@
 #include "zthread/Thread.h"
 #include <queue>
 #include "Utilities/Callback.h"
+#include "Database/SqlPreparedStatement.h"
 
 /// ---- BASE ---
 
@@ -35,9 +36,13 @@ class SqlDelayThread;
 class SqlOperation
 {
     public:
+        SqlOperation() : m_queueTime(0), m_writeBarrier(0) {}
         virtual void OnRemove() { delete this; }
         virtual void Execute(Database *db) = 0;
         virtual ~SqlOperation() {}
+
+        uint32 m_queueTime;                                 ///< getMSTime() when added to a delay thread
+        uint64 m_writeBarrier;                              ///< count of main connection writes to finish before execute
 };
 
 /// ---- ASYNC STATEMENTS / TRANSACTIONS ----
@@ -52,13 +57,33 @@ class SqlStatement : public SqlOperation
         void Execute(Database *db);
 };
 
+class SqlPreparedStatement : public SqlOperation
+{
+    private:
+        SqlStatementID m_id;
+        SqlStmtParameters m_params;
+    public:
+        SqlPreparedStatement(SqlStatementID const& id, SqlStmtParameters const& params) : m_id(id), m_params(params) {}
+        void Execute(Database *db);
+};
+
 class SqlTransaction : public SqlOperation
 {
     private:
-        std::queue<const char *> m_queue;
+        struct Statement                                    ///< sql, or prepared statement if params
+        {
+            const char *sql;
+            SqlStatementID id;
+            SqlStmtParameters *params;
+        };
+        std::queue<Statement> m_queue;
+
+        static void Free(Statement& stmt);
     public:
         SqlTransaction() {}
-        void DelayExecute(const char *sql) { m_queue.push(strdup(sql)); }
+        void DelayExecute(const char *sql);
+        void DelayExecute(SqlStatementID const& id, SqlStmtParameters const& params);
+        size_t GetSize() const { return m_queue.size(); }
         void Execute(Database *db);
 };
 
@@ -96,11 +121,14 @@ class SqlQueryHolder
     private:
         typedef std::pair<const char*, QueryResult*> SqlResultPair;
         std::vector<SqlResultPair> m_queries;
+        typedef std::pair<SqlStatementID, SqlStmtParameters*> SqlStmtPair;
+        std::vector<SqlStmtPair> m_stmts;                   ///< params are set for prepared statement queries
     public:
         SqlQueryHolder() {}
         ~SqlQueryHolder();
         bool SetQuery(size_t index, const char *sql);
         bool SetPQuery(size_t index, const char *format, ...) ATTR_PRINTF(3,4);
+        bool SetPreparedQuery(size_t index, SqlStatementID& id, const char *sql, SqlStmtParameters const& params);
         void SetSize(size_t size);
         QueryResult* GetResult(size_t index);
         void SetResult(size_t index, QueryResult *result);
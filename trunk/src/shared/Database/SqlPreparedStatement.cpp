@@ -0,0 +1,79 @@
+/* 
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "SqlPreparedStatement.h"
+
+SqlStmtParameters& SqlStmtParameters::AddInt64(int64 value)
+{
+    m_values.resize(m_values.size() + 1);
+    m_values.back().type = VALUE_INT64;
+    m_values.back().number.i = value;
+    return *this;
+}
+
+SqlStmtParameters& SqlStmtParameters::AddUInt64(uint64 value)
+{
+    m_values.resize(m_values.size() + 1);
+    m_values.back().type = VALUE_UINT64;
+    m_values.back().number.u = value;
+    return *this;
+}
+
+SqlStmtParameters& SqlStmtParameters::AddDouble(double value)
+{
+    m_values.resize(m_values.size() + 1);
+    m_values.back().type = VALUE_DOUBLE;
+    m_values.back().number.d = value;
+    return *this;
+}
+
+SqlStmtParameters& SqlStmtParameters::AddString(const char* value, size_t length)
+{
+    m_values.resize(m_values.size() + 1);
+    m_values.back().type = VALUE_STRING;
+    m_values.back().number.u = 0;
+    m_values.back().str.assign(value, length);
+    return *this;
+}
+
+SqlStmtParameters& SqlStmtParameters::AddBinary(const void* value, size_t length)
+{
+    AddString((const char*)value, length);
+    m_values.back().type = VALUE_BINARY;
+    return *this;
+}
+
+std::string SqlStmtParameters::ToString() const
+{
+    std::ostringstream ss;
+    for(size_t i = 0; i < m_values.size(); ++i)
+    {
+        if(i)
+            ss << ", ";
+
+        const Value& value = m_values[i];
+        switch(value.type)
+        {
+            case VALUE_INT64:  ss << value.number.i; break;
+            case VALUE_UINT64: ss << value.number.u; break;
+            case VALUE_DOUBLE: ss << value.number.d; break;
+            case VALUE_STRING: ss << "'" << value.str << "'"; break;
+            case VALUE_BINARY: ss << "<" << value.str.size() << " bytes>"; break;
+        }
+    }
+    return ss.str();
+}
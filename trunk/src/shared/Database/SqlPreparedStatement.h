@@ -0,0 +1,99 @@
+/* 
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef __SQLPREPAREDSTATEMENT_H
+#define __SQLPREPAREDSTATEMENT_H
+
+#include "Common.h"
+
+class Database;
+
+/// ---- PREPARED STATEMENTS ----
+
+/// Id of a prepared statement, usually a static object at the place of use: it is assigned
+/// at first use from the sql text, then every connection prepares the statement once
+/// and keeps it by this id
+class SqlStatementID
+{
+    friend class Database;
+    public:
+        SqlStatementID() : m_id(0), m_sql(NULL) {}
+
+        uint32 GetId() const { return m_id; }
+        const char* GetSql() const { return m_sql; }        ///< registered sql, same for all statements of id
+    private:
+        uint32 m_id;
+        const char* m_sql;
+};
+
+/// Parameter values of a prepared statement in binary form, in order of '?' in sql:
+/// params << guid << name;
+class SqlStmtParameters
+{
+    public:
+        enum ValueType
+        {
+            VALUE_INT64,
+            VALUE_UINT64,
+            VALUE_DOUBLE,
+            VALUE_STRING,
+            VALUE_BINARY                                    ///< bytes for blob columns, compared as binary
+        };
+
+        struct Value
+        {
+            ValueType type;
+            union
+            {
+                int64 i;
+                uint64 u;
+                double d;
+            } number;
+            std::string str;
+        };
+
+        SqlStmtParameters() {}
+
+        SqlStmtParameters& operator<<(bool value)   { return AddUInt64(value ? 1 : 0); }
+        SqlStmtParameters& operator<<(uint8 value)  { return AddUInt64(value); }
+        SqlStmtParameters& operator<<(uint16 value) { return AddUInt64(value); }
+        SqlStmtParameters& operator<<(uint32 value) { return AddUInt64(value); }
+        SqlStmtParameters& operator<<(uint64 value) { return AddUInt64(value); }
+        SqlStmtParameters& operator<<(int8 value)   { return AddInt64(value); }
+        SqlStmtParameters& operator<<(int16 value)  { return AddInt64(value); }
+        SqlStmtParameters& operator<<(int32 value)  { return AddInt64(value); }
+        SqlStmtParameters& operator<<(int64 value)  { return AddInt64(value); }
+        SqlStmtParameters& operator<<(float value)  { return AddDouble(value); }
+        SqlStmtParameters& operator<<(double value) { return AddDouble(value); }
+        SqlStmtParameters& operator<<(const std::string& value) { return AddString(value.data(), value.size()); }
+        SqlStmtParameters& operator<<(const char* value) { return AddString(value, strlen(value)); }
+
+        SqlStmtParameters& AddInt64(int64 value);
+        SqlStmtParameters& AddUInt64(uint64 value);
+        SqlStmtParameters& AddDouble(double value);
+        SqlStmtParameters& AddString(const char* value, size_t length);
+        SqlStmtParameters& AddBinary(const void* value, size_t length);
+
+        size_t size() const { return m_values.size(); }
+        const Value& operator[](size_t index) const { return m_values[index]; }
+
+        /// parameters as sql text, for error logs
+        std::string ToString() const;
+    private:
+        std::vector<Value> m_values;
+};
+#endif                                                      //__SQLPREPAREDSTATEMENT_H
@@ -0,0 +1,481 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <string.h>
+#include <algorithm>
+
+#include "FlatBVH.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define FLATBVH_SSE
+#include <xmmintrin.h>
+#endif
+
+using namespace G3D;
+
+namespace VMAP
+{
+    //==========================================================
+
+    struct FlatBVHBuildTriangle
+    {
+        Vector3 iVertex[3];
+        Vector3 iCenter;
+    };
+
+    struct FlatBVHCenterLess
+    {
+        int iAxis;
+        bool operator()(const FlatBVHBuildTriangle& a, const FlatBVHBuildTriangle& b) const { return(a.iCenter[iAxis] < b.iCenter[iAxis]); }
+    };
+
+    // ray data shared by all box and triangle tests of one traversal
+    struct FlatBVHRay
+    {
+        float iOrigin[3];
+        float iDir[3];
+        float iInvDir[3];
+        bool iParallel[3];                                  // box test by origin only, the slab distances are undefined
+    };
+
+    //==========================================================
+    /**
+    Median split of the triangle range along the largest extent of the triangle centers.
+    */
+    static int splitTriangles(Array<FlatBVHBuildTriangle>& pTriangles, int pBegin, int pEnd)
+    {
+        Vector3 lo = pTriangles[pBegin].iCenter;
+        Vector3 hi = lo;
+        for(int i=pBegin+1; i<pEnd; ++i)
+        {
+            lo = lo.min(pTriangles[i].iCenter);
+            hi = hi.max(pTriangles[i].iCenter);
+        }
+        Vector3 extent = hi - lo;
+
+        FlatBVHCenterLess less;
+        if(extent.x >= extent.y && extent.x >= extent.z)
+            less.iAxis = 0;
+        else if(extent.y >= extent.z)
+            less.iAxis = 1;
+        else
+            less.iAxis = 2;
+
+        int mid = (pBegin + pEnd) / 2;
+        FlatBVHBuildTriangle* triangles = pTriangles.getCArray();
+        std::nth_element(triangles + pBegin, triangles + mid, triangles + pEnd, less);
+        return mid;
+    }
+
+    //==========================================================
+
+    static int buildLeaf(const Array<FlatBVHBuildTriangle>& pTriangles, int pBegin, int pEnd, Array<FlatBVHTriangles>& pBlocks)
+    {
+        FlatBVHTriangles block;
+        memset(&block, 0, sizeof(FlatBVHTriangles));
+        for(int i=pBegin; i<pEnd; ++i)
+        {
+            const FlatBVHBuildTriangle& t = pTriangles[i];
+            for(int a=0; a<3; ++a)
+            {
+                block.iV0[a][i-pBegin] = t.iVertex[0][a];
+                block.iE1[a][i-pBegin] = t.iVertex[1][a] - t.iVertex[0][a];
+                block.iE2[a][i-pBegin] = t.iVertex[2][a] - t.iVertex[0][a];
+            }
+        }
+        pBlocks.append(block);
+        return ~(pBlocks.size() - 1);
+    }
+
+    //==========================================================
+
+    static int buildNode(Array<FlatBVHBuildTriangle>& pTriangles, int pBegin, int pEnd, Array<FlatBVHNode>& pNodes, Array<FlatBVHTriangles>& pBlocks)
+    {
+        // split the largest range until there is a range for each child or all ranges fit into a leaf
+        int begin[FLATBVH_WIDTH];
+        int end[FLATBVH_WIDTH];
+        int nRanges = 1;
+        begin[0] = pBegin;
+        end[0] = pEnd;
+        while(nRanges < FLATBVH_WIDTH)
+        {
+            int largest = 0;
+            for(int i=1; i<nRanges; ++i)
+                if(end[i] - begin[i] > end[largest] - begin[largest])
+                    largest = i;
+
+            if(end[largest] - begin[largest] <= FLATBVH_WIDTH)
+                break;
+
+            int mid = splitTriangles(pTriangles, begin[largest], end[largest]);
+            begin[nRanges] = mid;
+            end[nRanges] = end[largest];
+            end[largest] = mid;
+            ++nRanges;
+        }
+
+        FlatBVHNode node;
+        memset(&node, 0, sizeof(FlatBVHNode));
+        for(int i=0; i<FLATBVH_WIDTH; ++i)
+            node.iChild[i] = FLATBVH_NO_CHILD;
+
+        int nodePos = pNodes.size();
+        pNodes.append(node);
+
+        for(int i=0; i<nRanges; ++i)
+        {
+            Vector3 lo = pTriangles[begin[i]].iVertex[0];
+            Vector3 hi = lo;
+            for(int j=begin[i]; j<end[i]; ++j)
+            {
+                for(int k=0; k<3; ++k)
+                {
+                    lo = lo.min(pTriangles[j].iVertex[k]);
+                    hi = hi.max(pTriangles[j].iVertex[k]);
+                }
+            }
+
+            int child;
+            if(end[i] - begin[i] <= FLATBVH_WIDTH)
+                child = buildLeaf(pTriangles, begin[i], end[i], pBlocks);
+            else
+                child = buildNode(pTriangles, begin[i], end[i], pNodes, pBlocks);
+
+            // the child nodes are appended after this one, so get it again
+            FlatBVHNode& current = pNodes[nodePos];
+            for(int a=0; a<3; ++a)
+            {
+                current.iLo[a][i] = lo[a];
+                current.iHi[a][i] = hi[a];
+            }
+            current.iChild[i] = child;
+        }
+        return nodePos;
+    }
+
+    //==========================================================
+    /**
+    Returns a bit for each child box hit before pMaxDist, pNear gets the entry distances.
+    */
+    static inline int intersectBoxes(const FlatBVHNode& pNode, const FlatBVHRay& pRay, float pMaxDist, float* pNear)
+    {
+#ifdef FLATBVH_SSE
+        __m128 tNear = _mm_setzero_ps();
+        __m128 tFar = _mm_set1_ps(pMaxDist);
+        __m128 valid = _mm_cmpeq_ps(tNear, tNear);
+        for(int a=0; a<3; ++a)
+        {
+            __m128 lo = _mm_loadu_ps(pNode.iLo[a]);
+            __m128 hi = _mm_loadu_ps(pNode.iHi[a]);
+            __m128 origin = _mm_set1_ps(pRay.iOrigin[a]);
+            if(pRay.iParallel[a])
+            {
+                valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmple_ps(lo, origin), _mm_cmple_ps(origin, hi)));
+                continue;
+            }
+            __m128 invDir = _mm_set1_ps(pRay.iInvDir[a]);
+            __m128 t1 = _mm_mul_ps(_mm_sub_ps(lo, origin), invDir);
+            __m128 t2 = _mm_mul_ps(_mm_sub_ps(hi, origin), invDir);
+            tNear = _mm_max_ps(tNear, _mm_min_ps(t1, t2));
+            tFar = _mm_min_ps(tFar, _mm_max_ps(t1, t2));
+        }
+        _mm_storeu_ps(pNear, tNear);
+        return _mm_movemask_ps(_mm_and_ps(valid, _mm_cmple_ps(tNear, tFar)));
+#else
+        int mask = 0;
+        for(int i=0; i<FLATBVH_WIDTH; ++i)
+        {
+            float tNear = 0.0f;
+            float tFar = pMaxDist;
+            bool valid = true;
+            for(int a=0; a<3 && valid; ++a)
+            {
+                if(pRay.iParallel[a])
+                {
+                    valid = pNode.iLo[a][i] <= pRay.iOrigin[a] && pRay.iOrigin[a] <= pNode.iHi[a][i];
+                    continue;
+                }
+                float t1 = (pNode.iLo[a][i] - pRay.iOrigin[a]) * pRay.iInvDir[a];
+                float t2 = (pNode.iHi[a][i] - pRay.iOrigin[a]) * pRay.iInvDir[a];
+                tNear = std::max(tNear, std::min(t1, t2));
+                tFar = std::min(tFar, std::max(t1, t2));
+            }
+            pNear[i] = tNear;
+            if(valid && tNear <= tFar)
+                mask |= 1 << i;
+        }
+        return mask;
+#endif
+    }
+
+    //==========================================================
+    /**
+    Two sided ray triangle test (Moeller-Trumbore) of the 4 triangles of a leaf.
+    pMaxDist is set to the closest hit and true returned if one is before pMaxDist.
+    */
+    static inline bool intersectTriangles(const FlatBVHTriangles& pTri, const FlatBVHRay& pRay, float& pMaxDist)
+    {
+        static const float epsilon = 0.000001f;
+        float t[FLATBVH_WIDTH];
+        int mask;
+#ifdef FLATBVH_SSE
+        const __m128 dx = _mm_set1_ps(pRay.iDir[0]);
+        const __m128 dy = _mm_set1_ps(pRay.iDir[1]);
+        const __m128 dz = _mm_set1_ps(pRay.iDir[2]);
+        const __m128 e1x = _mm_loadu_ps(pTri.iE1[0]);
+        const __m128 e1y = _mm_loadu_ps(pTri.iE1[1]);
+        const __m128 e1z = _mm_loadu_ps(pTri.iE1[2]);
+        const __m128 e2x = _mm_loadu_ps(pTri.iE2[0]);
+        const __m128 e2y = _mm_loadu_ps(pTri.iE2[1]);
+        const __m128 e2z = _mm_loadu_ps(pTri.iE2[2]);
+
+        // p = dir x e2
+        const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+        const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+        const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+
+        const __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+        const __m128 absDet = _mm_andnot_ps(_mm_set1_ps(-0.0f), det);
+        __m128 valid = _mm_cmpgt_ps(absDet, _mm_set1_ps(epsilon));
+        const __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+        // s = origin - v0
+        const __m128 sx = _mm_sub_ps(_mm_set1_ps(pRay.iOrigin[0]), _mm_loadu_ps(pTri.iV0[0]));
+        const __m128 sy = _mm_sub_ps(_mm_set1_ps(pRay.iOrigin[1]), _mm_loadu_ps(pTri.iV0[1]));
+        const __m128 sz = _mm_sub_ps(_mm_set1_ps(pRay.iOrigin[2]), _mm_loadu_ps(pTri.iV0[2]));
+
+        const __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), invDet);
+
+        // q = s x e1
+        const __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+        const __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+        const __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+
+        const __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), invDet);
+        const __m128 dist = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), invDet);
+
+        const __m128 zero = _mm_setzero_ps();
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(u, zero));
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(v, zero));
+        valid = _mm_and_ps(valid, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.0f)));
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(dist, zero));
+        valid = _mm_and_ps(valid, _mm_cmple_ps(dist, _mm_set1_ps(pMaxDist)));
+
+        mask = _mm_movemask_ps(valid);
+        if(!mask)
+            return false;
+        _mm_storeu_ps(t, dist);
+#else
+        mask = 0;
+        const float* d = pRay.iDir;
+        for(int i=0; i<FLATBVH_WIDTH; ++i)
+        {
+            const float e1[3] = { pTri.iE1[0][i], pTri.iE1[1][i], pTri.iE1[2][i] };
+            const float e2[3] = { pTri.iE2[0][i], pTri.iE2[1][i], pTri.iE2[2][i] };
+
+            const float p[3] = { d[1]*e2[2] - d[2]*e2[1], d[2]*e2[0] - d[0]*e2[2], d[0]*e2[1] - d[1]*e2[0] };
+            const float det = e1[0]*p[0] + e1[1]*p[1] + e1[2]*p[2];
+            if(det > -epsilon && det < epsilon)
+                continue;
+            const float invDet = 1.0f / det;
+
+            const float s[3] = { pRay.iOrigin[0] - pTri.iV0[0][i], pRay.iOrigin[1] - pTri.iV0[1][i], pRay.iOrigin[2] - pTri.iV0[2][i] };
+            const float u = (s[0]*p[0] + s[1]*p[1] + s[2]*p[2]) * invDet;
+            if(u < 0.0f)
+                continue;
+
+            const float q[3] = { s[1]*e1[2] - s[2]*e1[1], s[2]*e1[0] - s[0]*e1[2], s[0]*e1[1] - s[1]*e1[0] };
+            const float v = (d[0]*q[0] + d[1]*q[1] + d[2]*q[2]) * invDet;
+            if(v < 0.0f || u + v > 1.0f)
+                continue;
+
+            t[i] = (e2[0]*q[0] + e2[1]*q[1] + e2[2]*q[2]) * invDet;
+            if(t[i] >= 0.0f && t[i] <= pMaxDist)
+                mask |= 1 << i;
+        }
+        if(!mask)
+            return false;
+#endif
+        for(int i=0; i<FLATBVH_WIDTH; ++i)
+            if((mask & (1 << i)) && t[i] < pMaxDist)
+                pMaxDist = t[i];
+        return true;
+    }
+
+    //==========================================================
+
+    void FlatBVH::free()
+    {
+        if(iNodes != 0) delete [] iNodes;
+        if(iTriangleBlocks != 0) delete [] iTriangleBlocks;
+        iNodes = 0;
+        iTriangleBlocks = 0;
+        iNNodes = iNTriangleBlocks = iNTriangles = 0;
+    }
+
+    //==========================================================
+
+    void FlatBVH::build(const Array<Vector3>& pVertices)
+    {
+        free();
+
+        Array<FlatBVHBuildTriangle> triangles;
+        for(int i=0; i+2<pVertices.size(); i+=3)
+        {
+            FlatBVHBuildTriangle t;
+            t.iVertex[0] = pVertices[i];
+            t.iVertex[1] = pVertices[i+1];
+            t.iVertex[2] = pVertices[i+2];
+            t.iCenter = (t.iVertex[0] + t.iVertex[1] + t.iVertex[2]) / 3.0f;
+            triangles.append(t);
+        }
+        if(triangles.size() == 0)
+            return;
+
+        Array<FlatBVHNode> nodes;
+        Array<FlatBVHTriangles> blocks;
+        buildNode(triangles, 0, triangles.size(), nodes, blocks);
+
+        iNTriangles = triangles.size();
+        iNNodes = nodes.size();
+        iNTriangleBlocks = blocks.size();
+        iNodes = new FlatBVHNode[iNNodes];
+        memcpy(iNodes, nodes.getCArray(), sizeof(FlatBVHNode) * iNNodes);
+        iTriangleBlocks = new FlatBVHTriangles[iNTriangleBlocks];
+        memcpy(iTriangleBlocks, blocks.getCArray(), sizeof(FlatBVHTriangles) * iNTriangleBlocks);
+    }
+
+    //==========================================================
+
+    bool FlatBVH::writeChunk(FILE *pFile) const
+    {
+        bool result = true;
+        unsigned int size = sizeof(unsigned int)*3 + sizeof(FlatBVHNode)*iNNodes + sizeof(FlatBVHTriangles)*iNTriangleBlocks;
+        if(result && fwrite("FBVH",4,1,pFile) != 1) result = false;
+        if(result && fwrite(&size,4,1,pFile) != 1) result = false;
+        if(result && fwrite(&iNNodes,sizeof(unsigned int),1,pFile) != 1) result = false;
+        if(result && fwrite(&iNTriangleBlocks,sizeof(unsigned int),1,pFile) != 1) result = false;
+        if(result && fwrite(&iNTriangles,sizeof(unsigned int),1,pFile) != 1) result = false;
+        if(result && fwrite(iNodes,sizeof(FlatBVHNode),iNNodes,pFile) != iNNodes) result = false;
+        if(result && fwrite(iTriangleBlocks,sizeof(FlatBVHTriangles),iNTriangleBlocks,pFile) != iNTriangleBlocks) result = false;
+        return(result);
+    }
+
+    //==========================================================
+
+    bool FlatBVH::readChunk(FILE *pFile)
+    {
+        free();
+
+        bool result = true;
+        char chunk[4];
+        unsigned int size;
+        if(result && fread(chunk,4,1,pFile) != 1) result = false;
+        if(result && strncmp(chunk,"FBVH",4)) result = false;
+        if(result && fread(&size,4,1,pFile) != 1) result = false;
+        if(result && fread(&iNNodes,sizeof(unsigned int),1,pFile) != 1) result = false;
+        if(result && fread(&iNTriangleBlocks,sizeof(unsigned int),1,pFile) != 1) result = false;
+        if(result && fread(&iNTriangles,sizeof(unsigned int),1,pFile) != 1) result = false;
+        if(result && size != sizeof(unsigned int)*3 + sizeof(FlatBVHNode)*iNNodes + sizeof(FlatBVHTriangles)*iNTriangleBlocks) result = false;
+        if(result)
+        {
+            iNodes = new FlatBVHNode[iNNodes];
+            iTriangleBlocks = new FlatBVHTriangles[iNTriangleBlocks];
+        }
+        if(result && fread(iNodes,sizeof(FlatBVHNode),iNNodes,pFile) != iNNodes) result = false;
+        if(result && fread(iTriangleBlocks,sizeof(FlatBVHTriangles),iNTriangleBlocks,pFile) != iNTriangleBlocks) result = false;
+        if(!result)
+            free();
+        return(result);
+    }
+
+    //==========================================================
+
+    bool FlatBVH::intersectRay(const Ray& pRay, float& pMaxDist, bool pStopAtFirstHit) const
+    {
+        if(iNNodes == 0)
+            return false;
+
+        FlatBVHRay ray;
+        for(int a=0; a<3; ++a)
+        {
+            ray.iOrigin[a] = pRay.origin[a];
+            ray.iDir[a] = pRay.direction[a];
+            ray.iParallel[a] = (pRay.direction[a] == 0.0f);
+            ray.iInvDir[a] = ray.iParallel[a] ? 0.0f : 1.0f / pRay.direction[a];
+        }
+
+        // nodes to visit with their entry distance, the nearest child on top
+        int stack[FLATBVH_STACK_SIZE];
+        float stackDist[FLATBVH_STACK_SIZE];
+        int stackSize = 1;
+        stack[0] = 0;
+        stackDist[0] = 0.0f;
+
+        bool hit = false;
+        while(stackSize > 0)
+        {
+            --stackSize;
+            // a closer hit was found since the node was pushed
+            if(stackDist[stackSize] > pMaxDist)
+                continue;
+
+            const FlatBVHNode& node = iNodes[stack[stackSize]];
+            float tNear[FLATBVH_WIDTH];
+            int mask = intersectBoxes(node, ray, pMaxDist, tNear);
+
+            int order[FLATBVH_WIDTH];
+            int nOrder = 0;
+            for(int i=0; i<FLATBVH_WIDTH; ++i)
+            {
+                if(!(mask & (1 << i)) || node.iChild[i] == FLATBVH_NO_CHILD)
+                    continue;
+
+                if(node.iChild[i] < 0)
+                {
+                    if(intersectTriangles(iTriangleBlocks[~node.iChild[i]], ray, pMaxDist))
+                    {
+                        hit = true;
+                        if(pStopAtFirstHit)
+                            return true;
+                    }
+                    continue;
+                }
+
+                // sort farthest first
+                int j = nOrder++;
+                while(j > 0 && tNear[order[j-1]] < tNear[i])
+                {
+                    order[j] = order[j-1];
+                    --j;
+                }
+                order[j] = i;
+            }
+
+            for(int j=0; j<nOrder && stackSize<FLATBVH_STACK_SIZE; ++j)
+            {
+                stack[stackSize] = node.iChild[order[j]];
+                stackDist[stackSize] = tNear[order[j]];
+                ++stackSize;
+            }
+        }
+        return hit;
+    }
+
+    //==========================================================
+}                                                           // VMAP
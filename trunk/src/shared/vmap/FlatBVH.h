@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _FLATBVH_H
+#define _FLATBVH_H
+
+#include <stdio.h>
+
+#include <G3D/Vector3.h>
+#include <G3D/Array.h>
+#include <G3D/Ray.h>
+
+#define FLATBVH_WIDTH 4                                     // children of a node and triangles of a leaf
+#define FLATBVH_NO_CHILD 0                                  // root node is never a child
+#define FLATBVH_STACK_SIZE 128                              // median splits keep the depth below 24 for 2^24 triangles
+
+namespace VMAP
+{
+    /**
+    Node of the FlatBVH. The bounds of its 4 children are stored by axis, so one SIMD register
+    holds the same bound of all children. A child >= 0 is a node index, a child < 0 is the
+    triangle block ~iChild. Unused children are FLATBVH_NO_CHILD.
+    */
+    struct FlatBVHNode
+    {
+        float iLo[3][FLATBVH_WIDTH];
+        float iHi[3][FLATBVH_WIDTH];
+        int iChild[FLATBVH_WIDTH];
+    };
+
+    /**
+    The up to 4 triangles of a leaf as first vertex and two edges, stored by coordinate.
+    Unused lanes have zero edges, so they are never hit.
+    */
+    struct FlatBVHTriangles
+    {
+        float iV0[3][FLATBVH_WIDTH];
+        float iE1[3][FLATBVH_WIDTH];
+        float iE2[3][FLATBVH_WIDTH];
+    };
+
+    /**
+    Bounding volume hierarchy of all triangles of a ModelContainer in absolute coordinates.
+    Nodes and triangle blocks are kept in two flat arrays, so like the BSP-Trees they are
+    loaded as binary blocks. Rays are tested against 4 child boxes or 4 triangles at once,
+    with SSE if the compiler targets it.
+    */
+    class FlatBVH
+    {
+        private:
+            FlatBVHNode *iNodes;
+            FlatBVHTriangles *iTriangleBlocks;
+            unsigned int iNNodes;
+            unsigned int iNTriangleBlocks;
+            unsigned int iNTriangles;
+
+            FlatBVH(const FlatBVH&);
+            FlatBVH& operator=(const FlatBVH&);
+
+        public:
+            FlatBVH() : iNodes(0), iTriangleBlocks(0), iNNodes(0), iNTriangleBlocks(0), iNTriangles(0) {}
+            ~FlatBVH() { free(); }
+
+            void free();
+
+            // 3 vertices for each triangle
+            void build(const G3D::Array<G3D::Vector3>& pVertices);
+
+            bool writeChunk(FILE *pFile) const;
+            bool readChunk(FILE *pFile);
+
+            /**
+            Sets pMaxDist to the distance of the closest hit before pMaxDist, or of any such hit if pStopAtFirstHit.
+            Triangles are hit from both sides. Returns true if a triangle was hit.
+            */
+            bool intersectRay(const G3D::Ray& pRay, float& pMaxDist, bool pStopAtFirstHit) const;
+
+            inline unsigned int getNTriangles() const { return(iNTriangles); }
+            inline size_t getMemUsage() const { return(iNNodes * sizeof(FlatBVHNode) + iNTriangleBlocks * sizeof(FlatBVHTriangles) + sizeof(FlatBVH)); }
+    };
+}
+#endif
@@ -20,6 +20,7 @@
 #define _IVMAPMANAGER_H
 
 #include<string>
+#include<vector>
 
 //===========================================================
 
@@ -60,6 +61,14 @@ namespace VMAP
             virtual void unloadMap(unsigned int pMapId) = 0;
 
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) = 0;
+            /**
+            test line of sight from one position to pCount targets, pTargets holds x,y,z of each target
+            */
+            virtual void isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, const float* pTargets, int pCount, std::vector<bool>& pResults) = 0;
+            /**
+            summary line of sight cache hits and misses of all maps
+            */
+            virtual void getLineOfSightCacheStats(unsigned int& pHits, unsigned int& pMisses) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z) = 0;
             /**
             test if we hit an object. return true if we hit one. rx,ry,rz will hold the hit position or the dest position, if no intersection was found
@@ -34,7 +34,7 @@ namespace VMAP
     */
     size_t hashCode(const ModelContainer& pMc)
     {
-        return (pMc.getBasePosition() * pMc.getNTriangles()).hashCode();
+        return (pMc.getBasePosition() * pMc.getNAllTriangles()).hashCode();
     }
     //==========================================================
 
@@ -44,6 +44,7 @@ namespace VMAP
 
         iNSubModel = pNSubModel;
         iSubModel = 0;
+        iFlatBVH = 0;
         if(pNSubModel > 0) iSubModel = new SubModel[iNSubModel];
     }
 
@@ -51,7 +52,8 @@ namespace VMAP
 
     bool ModelContainer::operator==(const ModelContainer& pMc2) const
     {
-        if (this->iNSubModel == 0 && pMc2.iNSubModel == 0 && this->iSubModel == 0 && pMc2.iSubModel == 0)
+        if (this->iNSubModel == 0 && pMc2.iNSubModel == 0 && this->iSubModel == 0 && pMc2.iSubModel == 0 &&
+            this->iFlatBVH == 0 && pMc2.iFlatBVH == 0)
             return true;
         return this == &pMc2;
     }
@@ -161,6 +163,7 @@ namespace VMAP
         iNSubModel = nSubModels;
 
         iSubModel = new SubModel[iNSubModel];
+        iFlatBVH = 0;
 
         int subModelPos,treeNodePos, trianglePos;
         subModelPos = treeNodePos = trianglePos = 0;
@@ -181,6 +184,27 @@ namespace VMAP
     {
         free();
         if(iSubModel != 0) delete [] iSubModel;
+        if(iFlatBVH != 0) delete iFlatBVH;
+    }
+
+    //==========================================================
+
+    void ModelContainer::buildFlatBVH()
+    {
+        Array<Vector3> vertices;
+        for(unsigned int i=0; i<iNSubModel; ++i)
+        {
+            const SubModel& sm = iSubModel[i];
+            for(unsigned int j=0; j<sm.getNTriangles(); ++j)
+            {
+                const TriangleBox& t = sm.getTriangle(j);
+                for(int k=0; k<3; ++k)
+                    vertices.append(t.vertex(k).getVector3() + sm.getBasePosition());
+            }
+        }
+
+        if(iFlatBVH == 0) iFlatBVH = new FlatBVH();
+        iFlatBVH->build(vertices);
     }
     //==========================================================
 
@@ -193,9 +217,9 @@ namespace VMAP
         FILE *wf =fopen(filename,"wb");
         if(wf)
         {
-            fwrite(VMAP_MAGIC,1,8,wf);
+            fwrite(iFlatBVH ? VMAP_MAGIC : VMAP_MAGIC_BSP,1,8,wf);
             result = true;
-            if(result && fwrite("CTREE01",8,1,wf) != 1) result = false;
+            if(result && fwrite(iFlatBVH ? "CTREE02" : "CTREE01",8,1,wf) != 1) result = false;
             if(result && fwrite(&flags,sizeof(unsigned int),1,wf) != 1) result = false;
 
             if(result && fwrite("POS ",4,1,wf) != 1) result = false;
@@ -212,6 +236,13 @@ namespace VMAP
             Vector3 high = iBox.high();
             if(result && fwrite(&high,sizeof(float),3,wf) != 3) result = false;
 
+            if(iFlatBVH)
+            {
+                if(result && !iFlatBVH->writeChunk(wf)) result = false;
+                fclose(wf);
+                return(result);
+            }
+
             if(result && fwrite("NODE",4,1,wf) != 1) result = false;
             size = sizeof(unsigned int)+ sizeof(TreeNode)*getNNodes();
             if(result && fwrite(&size,4,1,wf) != 1) result = false;
@@ -252,11 +283,14 @@ namespace VMAP
         if(rf)
         {
             free();
+            if(iFlatBVH != 0) { delete iFlatBVH; iFlatBVH = 0; }
 
             result = true;
-            char magic[8];                          // Ignore the added magic header
-            fread(magic,1,8,rf);
-            if(strncmp(VMAP_MAGIC,magic,8)) result = false;
+            char magic[8];
+            if(fread(magic,1,8,rf) != 8) result = false;
+            // files with BSP-Trees are still loaded, the current ones only have a FlatBVH
+            bool flatBVH = result && !strncmp(VMAP_MAGIC,magic,8);
+            if(result && !flatBVH && strncmp(VMAP_MAGIC_BSP,magic,8)) result = false;
             if(result && fread(ident,8,1,rf) != 1) result = false;
             if(result && fread(&flags,sizeof(unsigned int),1,rf) != 1) result = false;
             //POS
@@ -274,6 +308,14 @@ namespace VMAP
             if(result && fread(&high,sizeof(float),3,rf) != 3) result = false;
             setBounds(low, high);
 
+            if(flatBVH)
+            {
+                iFlatBVH = new FlatBVH();
+                if(result && !iFlatBVH->readChunk(rf)) result = false;
+                fclose(rf);
+                return result;
+            }
+
             //---- TreeNodes
             if(result && fread(chunk,4,1,rf) != 1) result = false;
             if(result && fread(&size,4,1,rf) != 1) result = false;
@@ -320,7 +362,7 @@ namespace VMAP
     size_t ModelContainer::getMemUsage()
     {
                                                             // BaseModel is included in ModelContainer
-        return(iNSubModel * sizeof(SubModel) + BaseModel::getMemUsage() + sizeof(ModelContainer) - sizeof(BaseModel));
+        return(iNSubModel * sizeof(SubModel) + BaseModel::getMemUsage() + sizeof(ModelContainer) - sizeof(BaseModel) + (iFlatBVH ? iFlatBVH->getMemUsage() : 0));
     }
 
     //=================================================================
@@ -335,6 +377,12 @@ namespace VMAP
 
     void ModelContainer::intersect(const G3D::Ray& pRay, float& pMaxDist, bool pStopAtFirstHit, G3D::Vector3& /*pOutLocation*/, G3D::Vector3& /*pOutNormal*/) const
     {
+        if(iFlatBVH)
+        {
+            iFlatBVH->intersectRay(pRay, pMaxDist, pStopAtFirstHit);
+            return;
+        }
+
         IntersectionCallBack<SubModel> intersectCallback;
         NodeValueAccess<TreeNode, SubModel> vna = NodeValueAccess<TreeNode, SubModel>(getTreeNodes(), iSubModel);
         Ray relativeRay = Ray::fromOriginAndDirection(pRay.origin - getBasePosition(), pRay.direction);
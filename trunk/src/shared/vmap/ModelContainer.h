@@ -31,6 +31,7 @@
 #include "VMapTools.h"
 #include "SubModel.h"
 #include "BaseModel.h"
+#include "FlatBVH.h"
 
 namespace VMAP
 {
@@ -41,6 +42,7 @@ namespace VMAP
     The tree nodes are used for the BSP-Tree of SubModels as well as for the BSP-Tree of triangles within one SubModel.
     The references are done by indexes within these static arrays.
     Therefore we are able to just load a binary block and do not need to mess around with memory allocation and pointers.
+    Model files of the current format hold only a FlatBVH of all triangles, it replaces the trees and SubModels.
     */
 
     //=====================================================
@@ -51,12 +53,13 @@ namespace VMAP
             unsigned int iNSubModel;
             SubModel *iSubModel;
             G3D::AABox iBox;
+            FlatBVH *iFlatBVH;                              // NULL for BSP-Tree files
 
             ModelContainer (const ModelContainer& c): BaseModel(c) {}
             ModelContainer& operator=(const ModelContainer& ) {}
 
         public:
-            ModelContainer() : BaseModel() { iNSubModel =0; iSubModel = 0; };
+            ModelContainer() : BaseModel() { iNSubModel =0; iSubModel = 0; iFlatBVH = 0; };
 
             // for the mainnode
             ModelContainer(unsigned int pNTriangles, unsigned int pNNodes, unsigned int pNSubModel);
@@ -81,12 +84,17 @@ namespace VMAP
 
             inline void setBounds(const G3D::Vector3& lo, const G3D::Vector3& hi) { iBox.set(lo,hi); }
 
+            // build the FlatBVH from the SubModels, writeFile then uses the current format
+            void buildFlatBVH();
+
+            inline unsigned int getNAllTriangles() const { return(iFlatBVH ? iFlatBVH->getNTriangles() : getNTriangles()); }
+
             bool writeFile(const char *filename);
 
             bool readFile(const char *filename);
 
             size_t getMemUsage();
-            size_t hashCode() { return (getBasePosition() * getNTriangles()).hashCode(); }
+            size_t hashCode() { return (getBasePosition() * getNAllTriangles()).hashCode(); }
 
             void intersect(const G3D::Ray& pRay, float& pMaxDist, bool pStopAtFirstHit, G3D::Vector3& pOutLocation, G3D::Vector3& pOutNormal) const;
             bool intersect(const G3D::Ray& pRay, float& pMaxDist) const;
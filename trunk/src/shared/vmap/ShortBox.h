@@ -123,21 +123,23 @@ namespace VMAP
             inline void intersect(const G3D::Ray& pRay, float& pMaxDist, bool /*pStopAtFirstHitDummy*/, G3D::Vector3& /*pOutLocationDummy*/, G3D::Vector3& /*pOutNormalDummy*/) const
             {
                 static const double epsilon = 0.00001;
-                G3D::Triangle testT(vertex(0).getVector3(),vertex(1).getVector3(),vertex(2).getVector3());
-                float t = pRay.intersectionTime(testT);
+                // test with edges directly, a G3D::Triangle would also calculate normal and plane for each side
+                const G3D::Vector3 v0 = vertex(0).getVector3();
+                const G3D::Vector3 v1 = vertex(1).getVector3();
+                const G3D::Vector3 v2 = vertex(2).getVector3();
+                float t = pRay.intersectionTime(v0, v1, v2, v1 - v0, v2 - v0);
                 if ((t < pMaxDist) || t < (pMaxDist + epsilon))
                     pMaxDist = t;
                 else
                 {
-                    testT = G3D::Triangle(vertex(2).getVector3(),vertex(1).getVector3(),vertex(0).getVector3());
-
 #ifdef _DEBUG_VMAPS
                     {
-                        G3D::Triangle myt(testT.vertex(0)+p6, testT.vertex(1)+p6,testT.vertex(2)+p6);
+                        G3D::Triangle myt(v2+p6, v1+p6, v0+p6);
                         gTriArray.push_back(myt);
                     }
 #endif
-                    t = pRay.intersectionTime(testT);
+                    // back side
+                    t = pRay.intersectionTime(v2, v1, v0, v1 - v2, v0 - v2);
                     if ((t < pMaxDist) || t < (pMaxDist + epsilon))
                         pMaxDist = t;
                 }
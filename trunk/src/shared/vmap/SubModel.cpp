@@ -221,7 +221,8 @@ namespace VMAP
             //p6=getBasePosition();
             //gBoxArray.push_back(getAABoxBounds());
 #endif
-            getTreeNode(0).intersectRay(relativeRay, intersectCallback, pMaxDist, vna, pStopAtFirstHit, false);
+            // triangle test is not more expensive than a test of the triangle bounds, so no bounds test first
+            getTreeNode(0).intersectRay(relativeRay, intersectCallback, pMaxDist, vna, pStopAtFirstHit, true);
     }
 
     //==========================================================
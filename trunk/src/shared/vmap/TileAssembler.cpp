@@ -334,6 +334,7 @@ namespace VMAP
                     {
                         mainTree->balance();
                         modelContainer = new ModelContainer(mainTree);
+                        modelContainer->buildFlatBVH();
                         modelContainer->writeFile(pDestFileName);
                     }
                     removeEntriesFromTree(mainTree);
@@ -27,6 +27,8 @@
 #include <G3D/Vector3.h>
 #include <G3D/AABox.h>
 
+#define TREENODE_TRAVERSAL_STACK_SIZE 64
+
 namespace VMAP
 {
     /**
@@ -117,6 +119,11 @@ namespace VMAP
             return canHitThisNode;
         }
 
+        /**
+        Non recursive traversal of the node array. Nodes still to be visited at the far side of a splitting plane
+        are kept on a small stack with the distance to that plane, so they are dropped when a closer hit was found
+        meanwhile. Deeper trees than the stack size continue with a new traversal for the overflowing node.
+        */
         template<typename RayCallback, typename TNode, typename TValue>
         void intersectRay(
             const G3D::Ray& ray, 
@@ -125,97 +132,123 @@ namespace VMAP
             const NodeValueAccess<TNode, TValue>& pNodeValueAccess,
             bool pStopAtFirstHit,
             bool intersectCallbackIsFast) const {
-                float enterDistance = distance;
-                if (! intersects(ray, distance)) {
-                    // The ray doesn't hit this node, so it can't hit the children of the node.
-                    return;
-                }
+                const float enterDistance = distance;
+
+                struct PendingNode
+                {
+                    TreeNode const* node;
+                    float planeDistance;
+                };
+                PendingNode stack[TREENODE_TRAVERSAL_STACK_SIZE];
+                int stackSize = 0;
+
+                TreeNode const* node = this;
+                for(;;) {
+                    if (node == NULL) {
+                        if (stackSize == 0)
+                            return;
+
+                        const PendingNode& pending = stack[--stackSize];
+                        // We aren't going to hit anything else before hitting the splitting plane,
+                        // so don't bother looking on the far side of it.
+                        if (pending.planeDistance <= distance)
+                            node = pending.node;
+                        continue;
+                    }
 
-                // Test for intersection against every object at this node.
-                for (unsigned int v = iStartPosition; v < (iNumberOfValues+iStartPosition); ++v) {        
-                    const TValue& nodeValue = pNodeValueAccess.getValue(v);
-                    bool canHitThisObject = true;
-                    if (! intersectCallbackIsFast) {
-                        // See if
-                        G3D::Vector3 location;
-                        const G3D::AABox& bounds = nodeValue.getAABoxBounds();
-                        bool alreadyInsideBounds = false;
-                        bool rayWillHitBounds = 
-                            MyCollisionDetection::collisionLocationForMovingPointFixedAABox(
-                            ray.origin, ray.direction, bounds, location, alreadyInsideBounds);
-
-                        canHitThisObject = (alreadyInsideBounds ||                
-                            (rayWillHitBounds && ((location - ray.origin).squaredLength() < (distance*distance))));
+                    if (! node->intersects(ray, distance)) {
+                        // The ray doesn't hit this node, so it can't hit the children of the node.
+                        node = NULL;
+                        continue;
                     }
 
-                    if (canHitThisObject) {
-                        // It is possible that this ray hits this object.  Look for the intersection using the
-                        // callback.
-                        intersectCallback(ray, &nodeValue, pStopAtFirstHit, distance);
+                    // Test for intersection against every object at this node.
+                    for (unsigned int v = node->iStartPosition; v < (node->iNumberOfValues+node->iStartPosition); ++v) {        
+                        const TValue& nodeValue = pNodeValueAccess.getValue(v);
+                        bool canHitThisObject = true;
+                        if (! intersectCallbackIsFast) {
+                            // See if
+                            G3D::Vector3 location;
+                            const G3D::AABox& bounds = nodeValue.getAABoxBounds();
+                            bool alreadyInsideBounds = false;
+                            bool rayWillHitBounds = 
+                                MyCollisionDetection::collisionLocationForMovingPointFixedAABox(
+                                ray.origin, ray.direction, bounds, location, alreadyInsideBounds);
+
+                            canHitThisObject = (alreadyInsideBounds ||                
+                                (rayWillHitBounds && ((location - ray.origin).squaredLength() < (distance*distance))));
+                        }
+
+                        if (canHitThisObject) {
+                            // It is possible that this ray hits this object.  Look for the intersection using the
+                            // callback.
+                            intersectCallback(ray, &nodeValue, pStopAtFirstHit, distance);
+                        }
+                        if(pStopAtFirstHit && distance < enterDistance)
+                            return;
                     }
-                    if(pStopAtFirstHit && distance < enterDistance)
-                        return;
-                }
 
-                // There are three cases to consider next:
-                // 
-                //  1. the ray can start on one side of the splitting plane and never enter the other,
-                //  2. the ray can start on one side and enter the other, and
-                //  3. the ray can travel exactly down the splitting plane
+                    // There are three cases to consider next:
+                    // 
+                    //  1. the ray can start on one side of the splitting plane and never enter the other,
+                    //  2. the ray can start on one side and enter the other, and
+                    //  3. the ray can travel exactly down the splitting plane
 
-                enum {NONE = -1};
-                int firstChild = NONE;
-                int secondChild = NONE;
+                    const G3D::Vector3::Axis axis = node->iSplitAxis;
+                    const float splitLocation = node->iSplitLocation;
 
-                if (ray.origin[iSplitAxis] < iSplitLocation) {
+                    enum {NONE = -1};
+                    int firstChild = NONE;
+                    int secondChild = NONE;
 
-                    // The ray starts on the small side
-                    firstChild = 0;
+                    if (ray.origin[axis] < splitLocation) {
 
-                    if (ray.direction[iSplitAxis] > 0) {
-                        // The ray will eventually reach the other side
-                        secondChild = 1;
-                    }
+                        // The ray starts on the small side
+                        firstChild = 0;
 
-                } else if (ray.origin[iSplitAxis] > iSplitLocation) {
+                        if (ray.direction[axis] > 0) {
+                            // The ray will eventually reach the other side
+                            secondChild = 1;
+                        }
 
-                    // The ray starts on the large side
-                    firstChild = 1;
+                    } else if (ray.origin[axis] > splitLocation) {
 
-                    if (ray.direction[iSplitAxis] < 0) {
-                        secondChild = 0;
-                    }
-                } else {
-                    // The ray starts on the splitting plane
-                    if (ray.direction[iSplitAxis] < 0) {
-                        // ...and goes to the small side
-                        firstChild = 0;
-                    } else if (ray.direction[iSplitAxis] > 0) {
-                        // ...and goes to the large side
+                        // The ray starts on the large side
                         firstChild = 1;
+
+                        if (ray.direction[axis] < 0) {
+                            secondChild = 0;
+                        }
+                    } else {
+                        // The ray starts on the splitting plane
+                        if (ray.direction[axis] < 0) {
+                            // ...and goes to the small side
+                            firstChild = 0;
+                        } else if (ray.direction[axis] > 0) {
+                            // ...and goes to the large side
+                            firstChild = 1;
+                        }
                     }
-                }
 
-                // Test on the side closer to the ray origin.
-                if ((firstChild != NONE) && iChilds[firstChild]>0) {
-                    getChild(pNodeValueAccess.getNodePtr() , firstChild)->intersectRay(ray, intersectCallback, distance, pNodeValueAccess, pStopAtFirstHit,intersectCallbackIsFast);
-                    if(pStopAtFirstHit && distance < enterDistance)
-                        return;
-                }
-                if (ray.direction[iSplitAxis] != 0) {
-                    // See if there was an intersection before hitting the splitting plane.  
-                    // If so, there is no need to look on the far side and recursion terminates.
-                    float distanceToSplittingPlane = (iSplitLocation - ray.origin[iSplitAxis]) / ray.direction[iSplitAxis];
-                    if (distanceToSplittingPlane > distance) {
-                        // We aren't going to hit anything else before hitting the splitting plane,
-                        // so don't bother looking on the far side of the splitting plane at the other
-                        // child.
-                        return;
+                    // The far side is only set for a ray crossing the plane, so its direction on the axis is not 0.
+                    if ((secondChild != NONE) && node->iChilds[secondChild]>0) {
+                        TreeNode const* farNode = node->getChild(pNodeValueAccess.getNodePtr(), secondChild);
+                        if (stackSize < TREENODE_TRAVERSAL_STACK_SIZE) {
+                            stack[stackSize].node = farNode;
+                            stack[stackSize].planeDistance = (splitLocation - ray.origin[axis]) / ray.direction[axis];
+                            ++stackSize;
+                        } else {
+                            farNode->intersectRay(ray, intersectCallback, distance, pNodeValueAccess, pStopAtFirstHit, intersectCallbackIsFast);
+                            if(pStopAtFirstHit && distance < enterDistance)
+                                return;
+                        }
                     }
-                }
-                // Test on the side farther from the ray origin.
-                if ((secondChild != NONE) && iChilds[secondChild]>0) {
-                    getChild(pNodeValueAccess.getNodePtr() , secondChild)->intersectRay(ray, intersectCallback, distance, pNodeValueAccess, pStopAtFirstHit,intersectCallbackIsFast);
+
+                    // Continue on the side closer to the ray origin.
+                    if ((firstChild != NONE) && node->iChilds[firstChild]>0)
+                        node = node->getChild(pNodeValueAccess.getNodePtr(), firstChild);
+                    else
+                        node = NULL;
                 }
         }
     };
@@ -24,12 +24,14 @@ namespace VMAP
 {
     //=====================================
     #define MAX_CAN_FALL_DISTANCE 10.0
-    const char VMAP_MAGIC[] = "VMAP_2.0";
+    const char VMAP_MAGIC[] = "VMAP_2.1";                   // model files with FlatBVH
+    const char VMAP_MAGIC_BSP[] = "VMAP_2.0";               // model files with BSP-Trees, still loaded
 
     class VMapDefinitions
     {
         public:
             static const double getMaxCanFallDistance() { return(MAX_CAN_FALL_DISTANCE); }
+            static bool isKnownMagic(const char* pMagic) { return(!strncmp(VMAP_MAGIC,pMagic,8) || !strncmp(VMAP_MAGIC_BSP,pMagic,8)); }
     };
 
     //======================================
@@ -18,6 +18,9 @@
 
 #include "VMapManager.h"
 #include "VMapDefinitions.h"
+#include "Platform/Define.h"
+#include "Timer.h"
+#include "zthread/Guard.h"
 
 using namespace G3D;
 
@@ -193,6 +196,7 @@ namespace VMAP
 
     int VMapManager::loadMap(const char* pBasePath, unsigned int pMapId, int x, int y)
     {
+        ZThread::Guard<ZThread::Lockable> guard(iTreeLock.getWriteLock());
         int result = VMAP_LOAD_RESULT_IGNORED;
         if(isMapLoadingEnabled() && !iIgnoreMapIds.containsKey(pMapId))
         {
@@ -294,7 +298,7 @@ namespace VMAP
                     {
                         char magic[8];
                         fread(magic,1,8,df2);
-                        if(!strncmp(VMAP_MAGIC,magic,8))
+                        if(VMapDefinitions::isKnownMagic(magic))
                             result = true;
                         fclose(df2);
                     }
@@ -310,6 +314,7 @@ namespace VMAP
 
     bool VMapManager::existsMap(const char* pBasePath, unsigned int pMapId, int x, int y)
     {
+        ZThread::Guard<ZThread::Lockable> guard(iTreeLock.getWriteLock());
         std::string basePath = std::string(pBasePath);
         if(basePath.length() > 0 && (basePath[basePath.length()-1] != '/' || basePath[basePath.length()-1] != '\\'))
         {
@@ -332,6 +337,7 @@ namespace VMAP
 
     void VMapManager::unloadMap(unsigned int pMapId, int x, int y)
     {
+        ZThread::Guard<ZThread::Lockable> guard(iTreeLock.getWriteLock());
         _unloadMap(pMapId, x, y);
 
 #ifdef _VMAP_LOG_DEBUG
@@ -371,6 +377,7 @@ namespace VMAP
 
     void VMapManager::unloadMap(unsigned int pMapId)
     {
+        ZThread::Guard<ZThread::Lockable> guard(iTreeLock.getWriteLock());
         if(iInstanceMapTrees.containsKey(pMapId))
         {
             MapTree* instanceTree = iInstanceMapTrees.get(pMapId);
@@ -392,6 +399,7 @@ namespace VMAP
 
     bool VMapManager::isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2)
     {
+        ZThread::Guard<ZThread::Lockable> guard(iTreeLock.getReadLock());
         bool result = true;
         if(isLineOfSightCalcEnabled() && iInstanceMapTrees.containsKey(pMapId))
         {
@@ -411,6 +419,48 @@ namespace VMAP
         }
         return(result);
     }
+    //=========================================================
+
+    void VMapManager::isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, const float* pTargets, int pCount, std::vector<bool>& pResults)
+    {
+        ZThread::Guard<ZThread::Lockable> guard(iTreeLock.getReadLock());
+        pResults.assign(pCount, true);
+        if(isLineOfSightCalcEnabled() && iInstanceMapTrees.containsKey(pMapId))
+        {
+            Vector3 pos1 = convertPositionToInternalRep(x1,y1,z1);
+            Array<Vector3> pos2;
+            pos2.resize(pCount);
+            for(int i=0; i<pCount; ++i)
+            {
+                pos2[i] = convertPositionToInternalRep(pTargets[i*3], pTargets[i*3+1], pTargets[i*3+2]);
+            }
+            MapTree* mapTree = iInstanceMapTrees.get(pMapId);
+            Array<bool> results;
+            mapTree->isInLineOfSight(pos1, pos2, results);
+            for(int i=0; i<pCount; ++i)
+            {
+                pResults[i] = results[i];
+            }
+        }
+    }
+
+    //=========================================================
+
+    void VMapManager::getLineOfSightCacheStats(unsigned int& pHits, unsigned int& pMisses)
+    {
+        ZThread::Guard<ZThread::Lockable> guard(iTreeLock.getReadLock());
+        pHits = 0;
+        pMisses = 0;
+        Array<unsigned int > keys = iInstanceMapTrees.getKeys();
+        for(int i=0; i<keys.size(); ++i)
+        {
+            unsigned int hits, misses;
+            iInstanceMapTrees.get(keys[i])->getLineOfSightCache().getStats(hits, misses);
+            pHits += hits;
+            pMisses += misses;
+        }
+    }
+
     //=========================================================
     /**
     get the hit position and return true if we hit something
@@ -418,6 +468,7 @@ namespace VMAP
     */
     bool VMapManager::getObjectHitPos(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float &ry, float& rz, float pModifyDist)
     {
+        ZThread::Guard<ZThread::Lockable> guard(iTreeLock.getReadLock());
         bool result = false;
         rx=x2;
         ry=y2;
@@ -453,6 +504,7 @@ namespace VMAP
     //int gGetHeightCounter = 0;
     float VMapManager::getHeight(unsigned int pMapId, float x, float y, float z)
     {
+        ZThread::Guard<ZThread::Lockable> guard(iTreeLock.getReadLock());
         float height = VMAP_INVALID_HEIGHT_VALUE;           //no height
         if(isHeightCalcEnabled() && iInstanceMapTrees.containsKey(pMapId))
         {
@@ -581,6 +633,11 @@ namespace VMAP
     bool MapTree::isInLineOfSight(const Vector3& pos1, const Vector3& pos2)
     {
         bool result = true;
+        unsigned int now = getMSTime();
+        if(iLineOfSightCache.get(pos1, pos2, now, result))
+        {
+            return result;
+        }
         float maxDist = abs((pos2 - pos1).magnitude());
                                                             // direction with length of 1
         Ray ray = Ray::fromOriginAndDirection(pos1, (pos2 - pos1)/maxDist);
@@ -589,8 +646,61 @@ namespace VMAP
         {
             result = false;
         }
+        iLineOfSightCache.set(pos1, pos2, now, result);
         return result;
     }
+
+    //=========================================================
+
+    void MapTree::isInLineOfSight(const Vector3& pPos1, const Array<Vector3>& pPos2, Array<bool>& pResults)
+    {
+        pResults.resize(pPos2.size());
+        unsigned int now = getMSTime();
+        Array<int> uncached;
+        Vector3 low = pPos1;
+        Vector3 high = pPos1;
+        for(int i=0; i<pPos2.size(); ++i)
+        {
+            pResults[i] = true;
+            if(pPos1 == pPos2[i] || iLineOfSightCache.get(pPos1, pPos2[i], now, pResults[i]))
+            {
+                continue;
+            }
+            uncached.append(i);
+            low = low.min(pPos2[i]);
+            high = high.max(pPos2[i]);
+        }
+        if(uncached.size() == 0)
+        {
+            return;
+        }
+
+        // only models crossing the box around all rays can block them
+        Array<ModelContainer *> models;
+        iTree->getIntersectingMembers(AABox(low, high), models);
+
+        for(int i=0; i<uncached.size(); ++i)
+        {
+            int n = uncached[i];
+            float maxDist = abs((pPos2[n] - pPos1).magnitude());
+            Ray ray = Ray::fromOriginAndDirection(pPos1, (pPos2[n] - pPos1)/maxDist);
+            for(int j=0; j<models.size() && pResults[n]; ++j)
+            {
+                float dist = maxDist;
+                if(!models[j]->intersect(ray, dist))
+                {
+                    continue;
+                }
+                Vector3 location, normal;
+                models[j]->intersect(ray, dist, true, location, normal);
+                if(dist > 0 && dist < maxDist)
+                {
+                    pResults[n] = false;
+                }
+            }
+            iLineOfSightCache.set(pPos1, pPos2[n], now, pResults[n]);
+        }
+    }
     //=========================================================
     /**
     When moving from pos1 to pos2 check if we hit an object. Return true and the position if we hit one
@@ -702,6 +812,7 @@ namespace VMAP
                 if(result && newModelLoaded)
                 {
                     iTree->balance();
+                    iLineOfSightCache.clear();
                 }
                 if(result && ferror(df) != 0)
                 {
@@ -761,6 +872,7 @@ namespace VMAP
                 if(treeChanged)
                 {
                     iTree->balance();
+                    iLineOfSightCache.clear();
                 }
             }
         }
@@ -774,6 +886,90 @@ namespace VMAP
         iLoadedModelContainer.set(pName, pMc);
         iTree->insert(pMc);
     }
+
+    //=========================================================
+    //=========================================================
+
+    LineOfSightCache::LineOfSightCache() : iHits(0), iMisses(0)
+    {
+        iEntries.resize(LOS_CACHE_SIZE);
+        clear();
+    }
+
+    //=========================================================
+
+    void LineOfSightCache::makeKey(const Vector3& pPos1, const Vector3& pPos2, int* pKey)
+    {
+        for(int i=0; i<3; ++i)
+        {
+            pKey[i] = int(floor(pPos1[i] / LOS_CACHE_STEP));
+            pKey[i+3] = int(floor(pPos2[i] / LOS_CACHE_STEP));
+        }
+    }
+
+    //=========================================================
+
+    unsigned int LineOfSightCache::getSlot(const int* pKey)
+    {
+        unsigned int hash = 0;
+        for(int i=0; i<6; ++i)
+        {
+            hash = (hash ^ (unsigned int)pKey[i]) * 16777619U;
+        }
+        return(hash & (LOS_CACHE_SIZE - 1));
+    }
+
+    //=========================================================
+
+    bool LineOfSightCache::get(const Vector3& pPos1, const Vector3& pPos2, unsigned int pTime, bool& pResult)
+    {
+        int key[6];
+        makeKey(pPos1, pPos2, key);
+        ZThread::Guard<ZThread::FastMutex> guard(iLock);
+        const Entry& entry = iEntries[getSlot(key)];
+        if(entry.iUsed && getMSTimeDiff(entry.iTime, pTime) < LOS_CACHE_TIME && memcmp(entry.iKey, key, sizeof(key)) == 0)
+        {
+            pResult = entry.iResult;
+            ++iHits;
+            return true;
+        }
+        ++iMisses;
+        return false;
+    }
+
+    //=========================================================
+
+    void LineOfSightCache::set(const Vector3& pPos1, const Vector3& pPos2, unsigned int pTime, bool pResult)
+    {
+        int key[6];
+        makeKey(pPos1, pPos2, key);
+        ZThread::Guard<ZThread::FastMutex> guard(iLock);
+        Entry& entry = iEntries[getSlot(key)];
+        memcpy(entry.iKey, key, sizeof(key));
+        entry.iTime = pTime;
+        entry.iResult = pResult;
+        entry.iUsed = true;
+    }
+
+    //=========================================================
+
+    void LineOfSightCache::clear()
+    {
+        ZThread::Guard<ZThread::FastMutex> guard(iLock);
+        for(int i=0; i<iEntries.size(); ++i)
+        {
+            iEntries[i].iUsed = false;
+        }
+    }
+
+    //=========================================================
+
+    void LineOfSightCache::getStats(unsigned int& pHits, unsigned int& pMisses)
+    {
+        ZThread::Guard<ZThread::FastMutex> guard(iLock);
+        pHits = iHits;
+        pMisses = iMisses;
+    }
     //=========================================================
     //=========================================================
     //=========================================================
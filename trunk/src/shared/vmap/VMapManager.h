@@ -27,6 +27,8 @@
 #include "DebugCmdLogger.h"
 #endif
 #include <G3D/Table.h>
+#include "zthread/FastMutex.h"
+#include "zthread/FairReadWriteLock.h"
 
 //===========================================================
 
@@ -34,6 +36,10 @@
 
 #define FILENAMEBUFFER_SIZE 500
 
+#define LOS_CACHE_SIZE 4096                                 // entries per map tree, power of 2
+#define LOS_CACHE_TIME 1000                                 // ms a cached result is used
+#define LOS_CACHE_STEP 1.0f                                 // position quantization step
+
 /**
 This is the main Class to manage loading and unloading of maps, line of sight, height calculation and so on.
 For each map or map tile to load it reads a directory file that contains the ModelContainer files used by this map or map tile.
@@ -66,6 +72,39 @@ namespace VMAP
     };
 
     //===========================================================
+    /**
+    Bounded cache of line of sight results of one map tree.
+    Both positions are quantized, so objects standing still reuse the result until it expires.
+    Entries are overwritten on hash collision. Map threads can share a tree, so access is locked.
+    */
+    class LineOfSightCache
+    {
+        private:
+            struct Entry
+            {
+                int iKey[6];
+                unsigned int iTime;
+                bool iResult;
+                bool iUsed;
+            };
+
+            G3D::Array<Entry> iEntries;
+            ZThread::FastMutex iLock;
+            unsigned int iHits;
+            unsigned int iMisses;
+
+            static void makeKey(const G3D::Vector3& pPos1, const G3D::Vector3& pPos2, int* pKey);
+            static unsigned int getSlot(const int* pKey);
+        public:
+            LineOfSightCache();
+
+            bool get(const G3D::Vector3& pPos1, const G3D::Vector3& pPos2, unsigned int pTime, bool& pResult);
+            void set(const G3D::Vector3& pPos1, const G3D::Vector3& pPos2, unsigned int pTime, bool pResult);
+            void clear();
+
+            void getStats(unsigned int& pHits, unsigned int& pMisses);
+    };
+
     //===========================================================
     //===========================================================
     //===========================================================
@@ -74,6 +113,7 @@ namespace VMAP
     {
         private:
             G3D::AABSPTree<ModelContainer *> *iTree;
+            LineOfSightCache iLineOfSightCache;
 
             // Key: filename, value ModelContainer
             G3D::Table<std::string, ManagedModelContainer *> iLoadedModelContainer;
@@ -102,6 +142,8 @@ namespace VMAP
             ~MapTree();
 
             bool isInLineOfSight(const G3D::Vector3& pos1, const G3D::Vector3& pos2);
+            // test many targets with one tree traversal for model containers around all of them
+            void isInLineOfSight(const G3D::Vector3& pPos1, const G3D::Array<G3D::Vector3>& pPos2, G3D::Array<bool>& pResults);
             bool getObjectHitPos(const G3D::Vector3& pos1, const G3D::Vector3& pos2, G3D::Vector3& pResultHitPos, float pModifyDist);
             float getHeight(const G3D::Vector3& pPos);
 
@@ -113,6 +155,7 @@ namespace VMAP
             void getModelContainer(G3D::Array<ModelContainer *>& pArray ) { iTree->getMembers(pArray); }
             const void addDirFile(const std::string& pDirName, const FilesInDir& pFilesInDir) { iLoadedDirFiles.set(pDirName, pFilesInDir); }
             size_t size() { return(iTree->size()); }
+            LineOfSightCache& getLineOfSightCache() { return(iLineOfSightCache); }
     };
 
     //===========================================================
@@ -132,6 +175,9 @@ namespace VMAP
             G3D::Table<unsigned int , bool> iMapsSplitIntoTiles;
             G3D::Table<unsigned int , bool> iIgnoreMapIds;
 
+            // map threads load and unload tiles of their maps (write) while other threads use the trees (read)
+            ZThread::FairReadWriteLock iTreeLock;
+
 #ifdef _VMAP_LOG_DEBUG
             CommandFileRW iCommandLogger;
 #endif
@@ -159,6 +205,8 @@ namespace VMAP
             void unloadMap(unsigned int pMapId);
 
             bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) ;
+            void isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, const float* pTargets, int pCount, std::vector<bool>& pResults);
+            void getLineOfSightCacheStats(unsigned int& pHits, unsigned int& pMisses);
             /**
             fill the hit pos and return true, if an object was hit
             */